@@ -14,13 +14,13 @@ public class DruStateChart : ModuleRules
                 "Core",
                 "StructUtils",
                 "GameplayTags",
+                "Engine",
             });
         
         PrivateDependencyModuleNames.AddRange(
             new []
             {
                 "CoreUObject",
-                "Engine",
             });
     }
 }
@@ -1,5 +1,23 @@
 // Copyright Andrei Sudarikov. All Rights Reserved.
 
 #include "Modules/ModuleManager.h"
+#include "Impl/StateChartExecutorRegistry.h"
+#include "StateChartLog.h"
 
-IMPLEMENT_MODULE(FDefaultModuleImpl, DruStateChart)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogDruStateChart);
+
+class FDruStateChartModule : public FDefaultModuleImpl
+{
+public:
+    void StartupModule() override
+    {
+        DruStateChart_Impl::FStateChartExecutorRegistry::Startup();
+    }
+
+    void ShutdownModule() override
+    {
+        DruStateChart_Impl::FStateChartExecutorRegistry::Shutdown();
+    }
+};
+
+IMPLEMENT_MODULE(FDruStateChartModule, DruStateChart)
@@ -2,8 +2,28 @@
 
 #include "Interfaces/IStateChartExecutor.h"
 #include "Impl/StateChartDefaultExecutor.h"
+#include "Impl/StateChartFlatExecutor.h"
+#include "StateChartAsset.h"
+#include "StateChartEvent.h"
+#include "StateChartLog.h"
 
 TSharedRef<IStateChartExecutor> IStateChartExecutor::CreateDefault(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject)
 {
-    return MakeShared<DruStateChart_Impl::FStateChartDefaultExecutor>(StateChartAsset, ContextObject);
+    if (StateChartAsset.GetFlatTable() != nullptr)
+    {
+        return MakeShared<DruStateChart_Impl::FStateChartFlatExecutor>(StateChartAsset, ContextObject);
+    }
+
+    return DruStateChart_Impl::CreateSpecializedExecutor(StateChartAsset, ContextObject);
+}
+
+void IStateChartExecutor::ExecuteTagEventImpl(const FGameplayTag& EventTag)
+{
+    ExecuteEventImpl(FConstStructView::Make(FStateChartGenericEvent(EventTag)));
+}
+
+FStateChartTimerHandle IStateChartExecutor::ExecuteEventDelayedImpl(FConstStructView Event, float DelaySeconds)
+{
+    UE_LOG(LogDruStateChart, Warning, TEXT("Executor of '%s' does not support delayed events. Event %s is dropped"), *GetNameSafe(GetExecutingAsset()), *GetNameSafe(Event.GetScriptStruct()));
+    return FStateChartTimerHandle();
 }
\ No newline at end of file
@@ -2,7 +2,19 @@
 
 #include "StateChartAsset.h"
 #include "Impl/StateChartElements.h"
+#include "StateChartAction.h"
+#include "StateChartCondition.h"
+#include "StateChartLog.h"
 #include "ExternalPackageHelper.h"
+#include "HAL/IConsoleManager.h"
+
+#if WITH_EDITOR
+static bool GVerifyIncrementalAssembly = false;
+static FAutoConsoleVariableRef CVarVerifyIncrementalAssembly(
+    TEXT("DruStateChart.VerifyIncrementalAssembly"),
+    GVerifyIncrementalAssembly,
+    TEXT("Compares incrementally patched StateChart nodes against full rebuild after every edit"));
+#endif
 
 TObjectPtr<UStateChartAsset> UStateChartAsset::Create(const TArray<TObjectPtr<UBaseStateDefinition>>& States, const TArray<TObjectPtr<UTransitionDefinition>>& Transitions)
 {
@@ -63,6 +75,142 @@ void UStateChartAsset::PostLoad()
 #endif
 }
 
+#if WITH_EDITOR
+void UStateChartAsset::PreEditChange(FProperty* PropertyAboutToChange)
+{
+    Super::PreEditChange(PropertyAboutToChange);
+
+    const FName PropertyName = PropertyAboutToChange != nullptr ? PropertyAboutToChange->GetFName() : NAME_None;
+
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(UStateChartAsset, AllStates) || PropertyName == GET_MEMBER_NAME_CHECKED(UStateChartAsset, AllTransitions))
+    {
+        PreEditStates = AllStates;
+        PreEditTransitions = AllTransitions;
+    }
+}
+
+void UStateChartAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(UStateChartAsset, AllStates) || PropertyName == GET_MEMBER_NAME_CHECKED(UStateChartAsset, AllTransitions))
+    {
+        // elements were added, removed or replaced. They are patched like any other element change
+        NotifyElementListChanged();
+        return;
+    }
+
+    // settings may affect compiled data
+    bNodesDirty = true;
+}
+
+template <typename T, typename TElements>
+static TSet<T*> MakeElementSet(const TElements& Elements)
+{
+    TSet<T*> Result;
+    Result.Reserve(Elements.Num());
+
+    for (T* Element : Elements)
+    {
+        Result.Add(Element);
+    }
+
+    return Result;
+}
+
+/* Returns true if elements kept by edit are still in the same order and added ones follow all of them */
+template <typename T>
+static bool IsAppendOnlyEdit(const TArray<T*>& OldElements, const TArray<TObjectPtr<T>>& NewElements, const TSet<T*>& OldSet, const TSet<T*>& NewSet)
+{
+    int32 OldIndex = 0;
+    bool bAddedFound = false;
+
+    for (T* Element : NewElements)
+    {
+        if (Element == nullptr)
+        {
+            continue;
+        }
+
+        if (!OldSet.Contains(Element))
+        {
+            bAddedFound = true;
+            continue;
+        }
+
+        while (OldIndex < OldElements.Num() && !NewSet.Contains(OldElements[OldIndex]))
+        {
+            OldIndex++;
+        }
+
+        if (bAddedFound || OldIndex >= OldElements.Num() || OldElements[OldIndex] != Element)
+        {
+            return false;
+        }
+
+        OldIndex++;
+    }
+
+    return true;
+}
+
+void UStateChartAsset::NotifyElementListChanged()
+{
+    TArray<UBaseStateDefinition*> OldStates = MoveTemp(PreEditStates);
+    TArray<UTransitionDefinition*> OldTransitions = MoveTemp(PreEditTransitions);
+
+    const TSet<UBaseStateDefinition*> NewStateSet = MakeElementSet<UBaseStateDefinition>(AllStates);
+    const TSet<UTransitionDefinition*> NewTransitionSet = MakeElementSet<UTransitionDefinition>(AllTransitions);
+    const TSet<UBaseStateDefinition*> OldStateSet = MakeElementSet<UBaseStateDefinition>(OldStates);
+    const TSet<UTransitionDefinition*> OldTransitionSet = MakeElementSet<UTransitionDefinition>(OldTransitions);
+
+    if (!IsAppendOnlyEdit(OldStates, AllStates, OldStateSet, NewStateSet) || !IsAppendOnlyEdit(OldTransitions, AllTransitions, OldTransitionSet, NewTransitionSet))
+    {
+        // order of lists breaks ties between siblings, patches assume new elements are appended
+        bNodesDirty = true;
+    }
+
+    // copies are iterated, because notifications keep AllStates and AllTransitions in sync
+    const TArray<TObjectPtr<UBaseStateDefinition>> NewStates = AllStates;
+    const TArray<TObjectPtr<UTransitionDefinition>> NewTransitions = AllTransitions;
+
+    // transitions leave before their states and states arrive before their transitions
+    for (UTransitionDefinition* Transition : OldTransitions)
+    {
+        if (Transition != nullptr && !NewTransitionSet.Contains(Transition))
+        {
+            NotifyElementChanged(*Transition, EStateChartElementChange::Removed);
+        }
+    }
+
+    for (UBaseStateDefinition* State : OldStates)
+    {
+        if (State != nullptr && !NewStateSet.Contains(State))
+        {
+            NotifyElementChanged(*State, EStateChartElementChange::Removed);
+        }
+    }
+
+    for (UBaseStateDefinition* State : NewStates)
+    {
+        if (State != nullptr && !OldStateSet.Contains(State))
+        {
+            NotifyElementChanged(*State, EStateChartElementChange::Added);
+        }
+    }
+
+    for (UTransitionDefinition* Transition : NewTransitions)
+    {
+        if (Transition != nullptr && !OldTransitionSet.Contains(Transition))
+        {
+            NotifyElementChanged(*Transition, EStateChartElementChange::Added);
+        }
+    }
+}
+#endif
+
 const DruStateChart_Impl::FStateChartNodes& UStateChartAsset::GetAssembledNodes() const
 {
     if (bNodesDirty)
@@ -79,9 +227,74 @@ void UStateChartAsset::AssembleNodeTree()
     AllStates.Remove(nullptr);
     AllTransitions.Remove(nullptr);
 
+    for (UBaseStateDefinition* State : AllStates)
+    {
+        CompileElement(*State);
+    }
+
+    for (UTransitionDefinition* Transition : AllTransitions)
+    {
+        CompileElement(*Transition);
+    }
+
     Nodes.CreateNodes(AllStates, AllTransitions);
 
     bNodesDirty = false;
+
+    CompileFlatTable();
+}
+
+const DruStateChart_Impl::FStateChartFlatTable* UStateChartAsset::GetFlatTable() const
+{
+    // make sure table is up to date
+    GetAssembledNodes();
+
+    return FlatTable.IsValid() ? &FlatTable : nullptr;
+}
+
+void UStateChartAsset::CompileElement(UStateChartElementAsset& Element) const
+{
+    FStateChartCompileContext CompileContext;
+    CompileContext.DatamodelType = Datamodel.GetPropertyBagStruct();
+
+    auto CompileActions = [&](TArray<FInstancedStruct>& Actions)
+    {
+        for (FInstancedStruct& Struct : Actions)
+        {
+            if (FStateChartAction* Action = Struct.GetMutablePtr<FStateChartAction>())
+            {
+                Action->Compile(CompileContext);
+            }
+        }
+    };
+
+    if (UTransitionDefinition* Transition = Cast<UTransitionDefinition>(&Element))
+    {
+        for (FInstancedStruct& Struct : Transition->Conditions)
+        {
+            if (FStateChartCondition* Condition = Struct.GetMutablePtr<FStateChartCondition>())
+            {
+                Condition->Compile(CompileContext);
+            }
+        }
+
+        CompileActions(Transition->Actions);
+    }
+    else if (UBaseStateWithActionsDefinition* State = Cast<UBaseStateWithActionsDefinition>(&Element))
+    {
+        CompileActions(State->EnterActions);
+        CompileActions(State->ExitActions);
+    }
+}
+
+void UStateChartAsset::CompileFlatTable()
+{
+    FlatTable.Reset();
+
+    if (bCompileFlatTable)
+    {
+        FlatTable.Compile(*this, MaxFlatTableConfigurations);
+    }
 }
 
 #if WITH_EDITOR
@@ -105,4 +318,133 @@ void UStateChartAsset::MoveSubObjectsToExternalPackage()
 
     bNodesDirty = true;
 }
+
+void UStateChartAsset::NotifyElementChanged(UStateChartElementAsset& Element, EStateChartElementChange Change)
+{
+    // keep element lists in sync
+    if (UBaseStateDefinition* State = Cast<UBaseStateDefinition>(&Element))
+    {
+        if (Change == EStateChartElementChange::Added)
+        {
+            AllStates.AddUnique(State);
+        }
+        else if (Change == EStateChartElementChange::Removed)
+        {
+            AllStates.Remove(State);
+        }
+    }
+    else if (UTransitionDefinition* Transition = Cast<UTransitionDefinition>(&Element))
+    {
+        if (Change == EStateChartElementChange::Added)
+        {
+            AllTransitions.AddUnique(Transition);
+        }
+        else if (Change == EStateChartElementChange::Removed)
+        {
+            AllTransitions.Remove(Transition);
+        }
+    }
+
+    if (Change != EStateChartElementChange::Removed)
+    {
+        CompileElement(Element);
+    }
+
+    if (!bNodesDirty)
+    {
+        if (!PatchNodes(Element, Change))
+        {
+            // fallback to full rebuild on next access
+            bNodesDirty = true;
+        }
+        else if (GVerifyIncrementalAssembly)
+        {
+            // lists may hold empty entries just added in details panel, full rebuild ignores them
+            TArray<TObjectPtr<UBaseStateDefinition>> States = AllStates;
+            TArray<TObjectPtr<UTransitionDefinition>> Transitions = AllTransitions;
+            States.Remove(nullptr);
+            Transitions.Remove(nullptr);
+
+            DruStateChart_Impl::FStateChartNodes RebuiltNodes;
+            RebuiltNodes.CreateNodes(States, Transitions);
+
+            FString Difference;
+            if (!Nodes.IsEquivalent(RebuiltNodes, &Difference))
+            {
+                UE_LOG(LogDruStateChart, Error, TEXT("Incremental assembly of '%s' does not match full rebuild: %s"), *GetPathName(), *Difference);
+                Nodes = MoveTemp(RebuiltNodes);
+            }
+        }
+
+        // rebuild only tables that depend on edited element. Any edit may change used features, eligibility or contents of the table
+        if (!bNodesDirty)
+        {
+            const bool bTransitionsChanged = Element.IsA<UTransitionDefinition>() || Change != EStateChartElementChange::Modified;
+            const bool bStatesChanged = !Element.IsA<UTransitionDefinition>();
+
+            Nodes.UpdateFeatures();
+
+            if (bTransitionsChanged)
+            {
+                Nodes.BuildTagIndex();
+                Nodes.BuildEventTypeIndex();
+                Nodes.BuildDependencyIndex();
+                Nodes.BuildGuardTable();
+            }
+
+            if (bStatesChanged)
+            {
+                Nodes.BuildHandlerTable();
+                Nodes.BuildHistoryTable();
+            }
+
+            CompileFlatTable();
+        }
+    }
+
+    ElementChangedDelegate.Broadcast(&Element, Change);
+}
+
+bool UStateChartAsset::PatchNodes(UStateChartElementAsset& Element, EStateChartElementChange Change)
+{
+    if (UTransitionDefinition* Transition = Cast<UTransitionDefinition>(&Element))
+    {
+        switch (Change)
+        {
+            case EStateChartElementChange::Added:
+                return Nodes.InsertTransition(*Transition);
+
+            case EStateChartElementChange::Removed:
+                return Nodes.RemoveTransition(*Transition);
+
+            case EStateChartElementChange::Reordered:
+            case EStateChartElementChange::Modified:
+                return Nodes.UpdateTransition(*Transition);
+
+            default:
+                return false;
+        }
+    }
+
+    if (UBaseStateDefinition* State = Cast<UBaseStateDefinition>(&Element))
+    {
+        switch (Change)
+        {
+            case EStateChartElementChange::Added:
+                return Nodes.InsertLeafState(*State);
+
+            case EStateChartElementChange::Reparented:
+                return Nodes.ReparentState(*State);
+
+            case EStateChartElementChange::Modified:
+                // nodes do not depend on any other state property
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    return false;
+}
 #endif
@@ -90,6 +90,13 @@ TObjectPtr<UStateChartAsset> FStateChartBuilder::Build(UObject* InParent, UClass
         CreateHistoryTransition(*HistoryBuilder);
     }
 
+    StateChart->Datamodel = Datamodel;
+    StateChart->bCompileFlatTable = MaxFlatTableConfigurations > 0;
+    StateChart->MaxFlatTableConfigurations = FMath::Max(MaxFlatTableConfigurations, 1);
+    StateChart->EventQueueCapacity = EventQueueCapacity;
+    StateChart->EventQueueOverflow = EventQueueOverflow;
+    StateChart->EventQueuePolicies = EventQueuePolicies;
+
     // make sure node tree is already assembled
     // we do it here, because we may be called from async loading thread. this way we are not wasting time of game thread
     StateChart->AssembleNodeTree();
@@ -97,6 +104,41 @@ TObjectPtr<UStateChartAsset> FStateChartBuilder::Build(UObject* InParent, UClass
     return StateChart;
 }
 
+FStateChartBuilder& FStateChartBuilder::Variable(FName Name, bool InitialValue)
+{
+    Datamodel.AddProperty(Name, EPropertyBagPropertyType::Bool);
+    Datamodel.SetValueBool(Name, InitialValue);
+    return *this;
+}
+
+FStateChartBuilder& FStateChartBuilder::Variable(FName Name, int32 InitialValue)
+{
+    Datamodel.AddProperty(Name, EPropertyBagPropertyType::Int32);
+    Datamodel.SetValueInt32(Name, InitialValue);
+    return *this;
+}
+
+FStateChartBuilder& FStateChartBuilder::Variable(FName Name, float InitialValue)
+{
+    Datamodel.AddProperty(Name, EPropertyBagPropertyType::Float);
+    Datamodel.SetValueFloat(Name, InitialValue);
+    return *this;
+}
+
+FStateChartBuilder& FStateChartBuilder::Variable(FName Name, double InitialValue)
+{
+    Datamodel.AddProperty(Name, EPropertyBagPropertyType::Double);
+    Datamodel.SetValueDouble(Name, InitialValue);
+    return *this;
+}
+
+FStateChartBuilder& FStateChartBuilder::Variable(FName Name, FName InitialValue)
+{
+    Datamodel.AddProperty(Name, EPropertyBagPropertyType::Name);
+    Datamodel.SetValueName(Name, InitialValue);
+    return *this;
+}
+
 void FStateChartBuilder::AppendName(const DruStateChart_Impl::FBuilderBase& Item, const TCHAR* RelativeName)
 {
     auto AppendHelper = [&](auto Str)
@@ -203,6 +245,9 @@ TObjectPtr<UTransitionDefinition> FStateChartBuilder::CreateTransitionDefinition
     Result->SortOrder = Builder.SortOrder;
     Result->bInitial = Builder.bInitial;
     Result->EventID = Builder.EventStruct;
+    Result->EventTag = Builder.TriggerTag;
+    Result->bMatchTagExact = Builder.bMatchTagExact;
+    Result->Delay = Builder.Delay;
     Algo::Transform(Builder.TargetPaths, Result->TargetStates, [&](const FString& Path) { return IDLookup[PathLookup[Path]]; });
     Result->Conditions = MoveTemp(Builder.Conditions);
     Result->Actions = MoveTemp(Builder.Actions);
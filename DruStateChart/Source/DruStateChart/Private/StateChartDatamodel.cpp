@@ -0,0 +1,14 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartDatamodel.h"
+
+const FProperty* FStateChartDatamodelSlot::FindProperty(const FStateChartCompileContext& Context) const
+{
+    return Context.DatamodelType != nullptr ? Context.DatamodelType->FindPropertyByName(Name) : nullptr;
+}
+
+bool FStateChartDatamodelChangedCondition::Evaluate(const FStateChartExecutionContext& Context, FConstStructView Event) const
+{
+    const FStateChartDatamodelChangedEvent* ChangedEvent = Event.GetPtr<FStateChartDatamodelChangedEvent>();
+    return ChangedEvent != nullptr && ChangedEvent->Name == Name;
+}
@@ -4,34 +4,81 @@
 #include "StateChartAsset.h"
 #include "StateChartAction.h"
 #include "StateChartCondition.h"
+#include "StateChartDatamodel.h"
+#include "StateChartEvent.h"
+#include "StateChartLog.h"
 #include "StateHandler.h"
 #include "Impl/StateChartElements.h"
 #include "Impl/StateChartNodes.h"
-#include "Algo/AllOf.h"
-#include "Algo/AnyOf.h"
-#include "Algo/Copy.h"
+#include "Algo/BinarySearch.h"
 #include "Algo/Transform.h"
+#include "Templates/IntegerSequence.h"
 
 namespace DruStateChart_Impl
 {
 
-template <typename T, typename TTargetAllocator, typename TSourceAllocator>
-void AppendUnique(TArray<T, TTargetAllocator>& Target, const TArray<T, TSourceAllocator>& Source)
+/* Changes number of active transitions on given key. OnFirst and OnLast are called when it changes from and to zero */
+template <typename TKey, typename TOnFirst, typename TOnLast>
+static void UpdateInterestCount(TArray<TPair<TKey, int32>>& Interests, const TKey& Key, int32 Delta, TOnFirst&& OnFirst, TOnLast&& OnLast)
 {
-    for (auto& Item : Source)
+    // charts react to few event types and tags, so linear search beats a map here
+    int32 InterestIndex = Interests.IndexOfByPredicate([&](const TPair<TKey, int32>& Interest) { return Interest.Key == Key; });
+    if (InterestIndex == INDEX_NONE)
     {
-        Target.AddUnique(Item);
+        InterestIndex = Interests.Emplace(Key, 0);
+    }
+
+    int32& Count = Interests[InterestIndex].Value;
+    Count += Delta;
+
+    if (Count == Delta && Delta > 0)
+    {
+        OnFirst();
+    }
+    else if (Count == 0)
+    {
+        Interests.RemoveAtSwap(InterestIndex);
+        OnLast();
     }
 }
 
-FStateChartDefaultExecutor::FStateChartDefaultExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject)
+template <EStateChartFeatures Features>
+TStateChartExecutor<Features>::TStateChartExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject)
     : Asset(&StateChartAsset)
     , Context(*this, ContextObject)
     , Nodes(&StateChartAsset.GetAssembledNodes())
+    , Datamodel(StateChartAsset.GetDatamodel())
+{
+    Context.Datamodel = Datamodel.GetMutableValue();
+
+    // changes are not worth an event if nobody listens to them
+    bRaiseDatamodelEvents = Nodes->EventTypeIndex.FindListIndex(FStateChartDatamodelChangedEvent::StaticStruct()) != INDEX_NONE;
+
+    ExternalEventQueue.SetPolicy(StateChartAsset.GetEventQueueCapacity(), StateChartAsset.GetEventQueueOverflow(), StateChartAsset.GetEventQueuePolicies());
+
+    if (bHasHistory && Nodes->HistoryTable.Slots.Num() != 0)
+    {
+        ActiveStateBits.SetNumZeroed((Nodes->StateNodes.Num() + 31) / 32);
+    }
+
+    RegistrySlot = FStateChartExecutorRegistry::Get().Add(*this, StateChartAsset);
+}
+
+template <EStateChartFeatures Features>
+TStateChartExecutor<Features>::~TStateChartExecutor()
 {
+    CancelAllTimers();
+    SetEventBus(nullptr);
+
+    // executors outliving the module have nothing to unregister from
+    if (FStateChartExecutorRegistry* Registry = FStateChartExecutorRegistry::TryGet())
+    {
+        Registry->Remove(RegistrySlot);
+    }
 }
 
-void FStateChartDefaultExecutor::Execute()
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::Execute()
 {
     if (Nodes->StateNodes.Num() > 0)
     {
@@ -43,47 +90,153 @@ void FStateChartDefaultExecutor::Execute()
     }
 }
 
-TArray<TObjectPtr<UBaseStateDefinition>> FStateChartDefaultExecutor::GetActiveStates() const
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::Stop()
+{
+    checkf(!bInsideExecutionLoop && !bInsideActionExecution, TEXT("Executor of '%s' cannot be stopped by its own Actions"), *Asset->GetPathName());
+
+    // abandon current plan. Done calls of its actions are ignored, because plan index no longer matches
+    ReleasePlan();
+    CurrentPlanIndex += 1;
+
+    // exit actions need a plan, even though they are not waited for
+    AcquirePlan();
+
+    if constexpr (bHasAsyncActions)
+    {
+        CurrentPlan->ContinuationDelegate = FSimpleDelegate::CreateSP(this, &TStateChartExecutor::OnActionCompleted, CurrentPlanIndex, uint16(0));
+    }
+
+    // deepest states exit first, same as when transition leaves them
+    FStateIndexArray StatesToExit;
+    StatesToExit.Append(ActiveStates);
+    StatesToExit.Sort([](FIndex A, FIndex B) { return B < A; });
+
+    // events raised by exit actions are queued as if plan was running, and discarded below together with timers
+    bExecutingPlan = true;
+    {
+        TGuardValue<bool> Guard(bInsideExecutionLoop, true);
+
+        for (FIndex StateIndex : StatesToExit)
+        {
+            ExitStateAsync(StateIndex);
+        }
+    }
+    bExecutingPlan = false;
+    ReleasePlan();
+
+    CancelAllTimers();
+    ExternalEventQueue.Reset();
+    InternalEventQueue.Reset();
+    HistoryStorage.Reset();
+
+    ClearDirtyTransitions();
+    bEventlessPending = false;
+    MacrostepMicrosteps = 0;
+    MacrostepEventlessMicrosteps = 0;
+
+    UpdateBusyInterest();
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::Reset(TObjectPtr<UObject> ContextObject)
+{
+    Stop();
+
+    Context.ContextObject = ContextObject;
+    Datamodel.CopyMatchingValuesByID(Asset->GetDatamodel());
+
+    Stats = FStateChartExecutorStats();
+    ExternalEventQueue.ResetStats();
+    InternalEventQueue.ResetStats();
+    Significance = EStateChartSignificance::High;
+}
+
+template <EStateChartFeatures Features>
+typename TStateChartExecutor<Features>::FHandlerCreated& TStateChartExecutor<Features>::OnStateHandlerCreated()
+{
+    if (!StateHandlerCreatedDelegate.IsValid())
+    {
+        StateHandlerCreatedDelegate = MakeUnique<FHandlerCreated>();
+    }
+
+    return *StateHandlerCreatedDelegate;
+}
+
+template <EStateChartFeatures Features>
+TArray<TObjectPtr<UBaseStateDefinition>> TStateChartExecutor<Features>::GetActiveStates() const
 {
     TArray<TObjectPtr<UBaseStateDefinition>> Result;
     Algo::Transform(ActiveStates, Result, [this](FIndex Index) { return Nodes->StateNodes[Index].Definition; });
     return Result;
 }
 
-void FStateChartDefaultExecutor::AddReferencedObjects(FReferenceCollector& Collector)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::AddReferencedObjects(FReferenceCollector& Collector)
 {
-    Collector.AddReferencedObject(Asset);
+    // asset is reported by registry
     Collector.AddReferencedObject(Context.ContextObject);
 
-    for (auto& EventStruct : ExternalEventQueue)
-    {
-        EventStruct.AddStructReferencedObjects(Collector);
-    }
-    
-    for (auto& EventStruct : InternalEventQueue)
+    Datamodel.AddStructReferencedObjects(Collector);
+
+    for (FDelayedEvent& DelayedEvent : DelayedEvents)
     {
-        EventStruct.AddStructReferencedObjects(Collector);
+        DelayedEvent.Event.AddStructReferencedObjects(Collector);
     }
 
+    ExternalEventQueue.AddStructReferencedObjects(Collector);
+    InternalEventQueue.AddStructReferencedObjects(Collector);
+
+    Collector.AddReferencedObjects(StateHandlers);
+
     if (bExecutingPlan)
     {
-        CurrentPlan.Event.AddStructReferencedObjects(Collector);
+        CurrentPlan->Event.AddStructReferencedObjects(Collector);
     }
 }
 
-FString FStateChartDefaultExecutor::GetReferencerName() const
+template <EStateChartFeatures Features>
+FStateChartExecutorStats TStateChartExecutor<Features>::GetStats() const
 {
-    return TEXT("StateChartDefaultExecutor");
+    FStateChartExecutorStats Result = Stats;
+    Result.MaxExternalQueueDepth = ExternalEventQueue.GetMaxNum();
+    Result.MaxInternalQueueDepth = InternalEventQueue.GetMaxNum();
+    Result.NumDroppedEvents = ExternalEventQueue.GetNumDropped();
+    Result.NumCoalescedEvents = ExternalEventQueue.GetNumCoalesced();
+    return Result;
 }
 
-void FStateChartDefaultExecutor::ExecuteEventImpl(FConstStructView Event)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ExecuteEventImpl(FConstStructView Event)
 {
     if (bExecutingPlan)
     {
         // we'll process it later
         bInsideActionExecution ?
-            InternalEventQueue.Emplace(Event) :
-            ExternalEventQueue.Emplace(Event);
+            InternalEventQueue.Enqueue(Event) :
+            ExternalEventQueue.Enqueue(Event);
+
+        return;
+    }
+
+    if (bDeferEvents || !ExternalEventQueue.IsEmpty())
+    {
+        // events left by previous Pump go first
+        ExternalEventQueue.Enqueue(Event);
+
+        if (!bDeferEvents)
+        {
+            ProcessEventsSynchronous();
+        }
+        else if (ExternalEventQueue.IsCritical(Event.GetScriptStruct()))
+        {
+            // cannot wait for scheduler. events queued before it are processed too, so order is kept
+            Pump(MAX_int32);
+        }
+        else
+        {
+            UpdateBusyInterest();
+        }
 
         return;
     }
@@ -98,82 +251,639 @@ void FStateChartDefaultExecutor::ExecuteEventImpl(FConstStructView Event)
     ProcessEventsSynchronous();
 }
 
-void FStateChartDefaultExecutor::StartNewPlan(const FTransitionIndexArray& Transitions, FInstancedStruct Event)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::NotifyDatamodelChanged(FName VariableName)
+{
+    InvalidateDependency(VariableName);
+
+    if (bRaiseDatamodelEvents)
+    {
+        // changes made by actions are queued as internal events
+        ExecuteEventImpl(FConstStructView::Make(FStateChartDatamodelChangedEvent(VariableName)));
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ExecuteTagEventImpl(const FGameplayTag& EventTag)
+{
+    if (!EventTag.IsValid())
+    {
+        // nothing to index by, let regular path handle it
+        IStateChartExecutor::ExecuteTagEventImpl(EventTag);
+        return;
+    }
+
+    if (bExecutingPlan)
+    {
+        // we'll process it later
+        bInsideActionExecution ?
+            InternalEventQueue.EnqueueTag(EventTag) :
+            ExternalEventQueue.EnqueueTag(EventTag);
+
+        return;
+    }
+
+    if (bDeferEvents || !ExternalEventQueue.IsEmpty())
+    {
+        // events left by previous Pump go first
+        ExternalEventQueue.EnqueueTag(EventTag);
+
+        if (!bDeferEvents)
+        {
+            ProcessEventsSynchronous();
+        }
+        else if (ExternalEventQueue.IsCritical(FStateChartGenericEvent::StaticStruct()))
+        {
+            // same as critical struct events, tag events are queued as FStateChartGenericEvent
+            Pump(MAX_int32);
+        }
+        else
+        {
+            UpdateBusyInterest();
+        }
+
+        return;
+    }
+
+    check(ExternalEventQueue.IsEmpty());
+    check(InternalEventQueue.IsEmpty());
+
+    StartNewPlan(CollectTagTransitions(EventTag, FConstStructView()), FInstancedStruct(), EventTag);
+    ProcessEventsSynchronous();
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::StartNewPlan(const FTransitionIndexArray& Transitions, FInstancedStruct Event, const FGameplayTag& EventTag)
 {
     check(!bExecutingPlan);
 
     if (Transitions.Num() != 0)
     {
-        CurrentPlan = FExecutionPlan(CurrentPlan.PlanIndex + 1);
-        CurrentPlan.Event = MoveTemp(Event);
+        Stats.NumMicrosteps += 1;
+        MacrostepMicrosteps += 1;
+
+        AcquirePlan();
+        CurrentPlanIndex += 1;
+        CurrentPlan->Event = MoveTemp(Event);
+        CurrentPlan->EventTag = EventTag;
         bExecutingPlan = true;
+        UpdateBusyInterest();
 
         FStateIndexArray Temp;
 
-        CollectStatesToExit(Transitions, Temp);
+        GetSolver().CollectStatesToExit(Transitions, Temp);
         Temp.Sort([](auto A, auto B) { return B < A; });
-        Algo::Transform(Temp, CurrentPlan.Steps, [](FIndex Index) { return FExecutionPlanStep{ EStepType::Exit, Index }; });
+        Algo::Transform(Temp, CurrentPlan->Steps, [](FIndex Index) { return FExecutionPlanStep{ EStepType::Exit, Index }; });
 
-        RecordHistoryStates(Temp);
+        if constexpr (bHasHistory)
+        {
+            RecordHistoryStates(Temp);
+        }
         Temp.Reset();
 
-        Algo::Transform(Transitions, CurrentPlan.Steps, [](FIndex Index) { return FExecutionPlanStep{ EStepType::Transition, Index }; });
+        Algo::Transform(Transitions, CurrentPlan->Steps, [](FIndex Index) { return FExecutionPlanStep{ EStepType::Transition, Index }; });
 
-        CollectStatesToEnter(Transitions, Temp, CurrentPlan.StatesForDefaultEntry);
+        GetSolver().CollectStatesToEnter(Transitions, Temp, CurrentPlan->StatesForDefaultEntry);
         Temp.Sort();
-        Algo::Transform(Temp, CurrentPlan.Steps, [](FIndex Index) { return FExecutionPlanStep{ EStepType::Enter, Index }; });
+        Algo::Transform(Temp, CurrentPlan->Steps, [](FIndex Index) { return FExecutionPlanStep{ EStepType::Enter, Index }; });
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::FExecutionPlan::Reset()
+{
+    StepIndex = 0;
+    NumActionsToComplete = 0;
+    ContinuationType = EActionContinuationType::Default;
+    StepTimeout = 0.f;
+    bStepWaitsForever = false;
+
+    Steps.Reset();
+    StatesForDefaultEntry.Reset();
+    ContinuationDelegate.Unbind();
+
+    // pooled plans must not keep payloads alive
+    Event.Reset();
+    EventTag = FGameplayTag();
+}
+
+template <EStateChartFeatures Features>
+TArray<TUniquePtr<typename TStateChartExecutor<Features>::FExecutionPlan>>& TStateChartExecutor<Features>::GetPlanPool()
+{
+    static TArray<TUniquePtr<FExecutionPlan>> PlanPool;
+    return PlanPool;
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::AcquirePlan()
+{
+    if (CurrentPlan.IsValid())
+    {
+        CurrentPlan->Reset();
+        return;
+    }
+
+    TArray<TUniquePtr<FExecutionPlan>>& PlanPool = GetPlanPool();
+    CurrentPlan = PlanPool.Num() != 0 ? PlanPool.Pop() : MakeUnique<FExecutionPlan>();
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ReleasePlan()
+{
+    // several plans are alive only while executors wait for async actions, so few of them are worth keeping
+    static constexpr int32 MaxPooledPlans = 16;
+
+    if (CurrentPlan.IsValid())
+    {
+        TArray<TUniquePtr<FExecutionPlan>>& PlanPool = GetPlanPool();
+
+        if (PlanPool.Num() < MaxPooledPlans)
+        {
+            CurrentPlan->Reset();
+            PlanPool.Add(MoveTemp(CurrentPlan));
+        }
+        else
+        {
+            CurrentPlan.Reset();
+        }
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ProcessEventsSynchronous()
+{
+    while (true)
+    {
+        if (bExecutingPlan)
+        {
+            // process CurrentPlan, until completion or interruption by async action
+            ProcessPlanSynchronous();
+
+            if (bExecutingPlan)
+            {
+                // not finished synchronously, need to wait for continuation
+                UpdateBusyInterest();
+                return;
+            }
+        }
+
+        // eventless transitions enabled by previous microstep are taken before the next event
+        if (StartEventlessPlan())
+        {
+            continue;
+        }
+
+        FinishMacrostep();
+
+        // start plan for the next event
+        FGameplayTag EventTag;
+        FInstancedStruct Event;
+
+        if (!InternalEventQueue.Dequeue(EventTag, Event))
+        {
+            // events raised by actions belong to the current macrostep, so budget applies to external ones only
+            if (!CanProcessExternalEvent() || !ExternalEventQueue.Dequeue(EventTag, Event))
+            {
+                UpdateBusyInterest();
+                return;
+            }
+
+            if (bPumping)
+            {
+                PumpMacrostepsLeft -= 1;
+            }
+        }
+
+        if (EventTag.IsValid())
+        {
+            StartNewPlan(CollectTagTransitions(EventTag, FConstStructView()), FInstancedStruct(), EventTag);
+        }
+        else
+        {
+            StartNewPlan(CollectTransitions(Event), MoveTemp(Event));
+        }
+    }
+}
+
+template <EStateChartFeatures Features>
+bool TStateChartExecutor<Features>::CanProcessExternalEvent() const
+{
+    if (!bPumping)
+    {
+        return !bDeferEvents;
+    }
+
+    return PumpMacrostepsLeft > 0 && (PumpDeadline == 0.0 || FPlatformTime::Seconds() < PumpDeadline);
+}
+
+template <EStateChartFeatures Features>
+int32 TStateChartExecutor<Features>::Pump(int32 MaxMacrosteps, double MaxSeconds)
+{
+    if (bExecutingPlan || ExternalEventQueue.IsEmpty() || MaxMacrosteps <= 0)
+    {
+        // either waiting for async action or called from one of them
+        return 0;
+    }
+
+    TGuardValue<bool> Guard(bPumping, true);
+    PumpMacrostepsLeft = MaxMacrosteps;
+    PumpDeadline = MaxSeconds > 0.0 ? FPlatformTime::Seconds() + MaxSeconds : 0.0;
+
+    ProcessEventsSynchronous();
+
+    return MaxMacrosteps - PumpMacrostepsLeft;
+}
+
+template <EStateChartFeatures Features>
+bool TStateChartExecutor<Features>::StartEventlessPlan()
+{
+    if (Nodes->EventTypeIndex.EventlessTransitions.Num() == 0)
+    {
+        return false;
+    }
+
+    if (MacrostepEventlessMicrosteps >= Asset->GetMaxEventlessMicrosteps())
+    {
+        UE_LOG(LogDruStateChart, Warning, TEXT("StateChart '%s' took %d eventless transitions in a row. Remaining ones are skipped until next event"), *Asset->GetPathName(), MacrostepEventlessMicrosteps);
+        Stats.NumEventlessLimitHits += 1;
+        bEventlessPending = true;
+        return false;
+    }
+
+    // all eventless transitions of active states are evaluated here, so earlier changes of dependencies are accounted for
+    bEventlessPending = false;
+    ClearDirtyTransitions();
+
+    StartNewPlan(CollectEventlessTransitions(), FInstancedStruct());
+
+    if (bExecutingPlan)
+    {
+        MacrostepEventlessMicrosteps += 1;
+    }
+
+    return bExecutingPlan;
+}
+
+template <EStateChartFeatures Features>
+FStateChartTimerHandle TStateChartExecutor<Features>::ExecuteEventDelayedImpl(FConstStructView Event, float DelaySeconds)
+{
+    if (!TimerWheel.IsValid())
+    {
+        UE_LOG(LogDruStateChart, Warning, TEXT("Executor of '%s' has no timer wheel. Delayed event %s is dropped"), *Asset->GetPathName(), *GetNameSafe(Event.GetScriptStruct()));
+        return FStateChartTimerHandle();
+    }
+
+    const int32 EventIndex = DelayedEvents.Add({ FStateChartTimerHandle(), FInstancedStruct(Event) });
+    const FStateChartTimerHandle Timer = TimerWheel->Schedule(*this, EventIndex, DelaySeconds);
+    DelayedEvents[EventIndex].Timer = Timer;
+
+    return Timer;
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::CancelDelayedEvent(const FStateChartTimerHandle& Handle)
+{
+    if (!TimerWheel.IsValid())
+    {
+        return;
+    }
+
+    if (const uint32* Cookie = TimerWheel->FindCookie(Handle))
+    {
+        // handle may belong to other executor sharing the wheel
+        if (DelayedEvents.IsValidIndex(*Cookie) && DelayedEvents[*Cookie].Timer == Handle)
+        {
+            DelayedEvents.RemoveAt(*Cookie);
+            TimerWheel->Cancel(Handle);
+        }
+
+        return;
+    }
+
+    // timer may have expired already, but its batch is still being delivered
+    for (auto It = DelayedEvents.CreateIterator(); It; ++It)
+    {
+        if (It->Timer == Handle)
+        {
+            It.RemoveCurrent();
+            return;
+        }
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::SetTimerWheel(TSharedPtr<FStateChartTimerWheel> InTimerWheel)
+{
+    CancelAllTimers();
+    TimerWheel = MoveTemp(InTimerWheel);
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::SetEventBus(TSharedPtr<FStateChartEventBus> InEventBus)
+{
+    if (EventBus.IsValid())
+    {
+        for (const TPair<const UScriptStruct*, int32>& Interest : EventInterest)
+        {
+            EventBus->RemoveInterest(*this, Interest.Key);
+        }
+
+        for (const TPair<FGameplayTag, int32>& Interest : TagInterest)
+        {
+            EventBus->RemoveTagInterest(*this, Interest.Key);
+        }
+
+        // also clears busy state
+        EventBus->RemoveExecutor(*this);
+    }
+
+    EventInterest.Reset();
+    TagInterest.Reset();
+    bBusyOnEventBus = false;
+    EventBus = MoveTemp(InEventBus);
+
+    if (EventBus.IsValid())
+    {
+        EventBus->AddExecutor(*this);
+
+        for (FIndex StateIndex : ActiveStates)
+        {
+            UpdateEventInterest(StateIndex, 1);
+        }
+
+        UpdateBusyInterest();
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::UpdateEventInterest(FIndex StateIndex, int32 Delta)
+{
+    const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
+
+    for (int32 TransitionIndex = StateNode.TransitionIndex; TransitionIndex < StateNode.TransitionIndex + StateNode.NumTransitions; ++TransitionIndex)
+    {
+        // eventless and timed transitions are not triggered by broadcast events
+        const UScriptStruct* EventType = Nodes->TransitionNodes[TransitionIndex].EventID;
+        if (EventType == nullptr || EventType == FStateChartTimeoutEvent::StaticStruct())
+        {
+            continue;
+        }
+
+        // tagged transitions wake executor only for their tag and its child tags
+        const FGameplayTag& EventTag = Nodes->TransitionNodes[TransitionIndex].Definition->EventTag;
+        if (EventType == FStateChartGenericEvent::StaticStruct() && EventTag.IsValid())
+        {
+            UpdateInterestCount(TagInterest, EventTag, Delta,
+                [&] { EventBus->AddTagInterest(*this, EventTag); },
+                [&] { EventBus->RemoveTagInterest(*this, EventTag); });
+        }
+        else
+        {
+            UpdateInterestCount(EventInterest, EventType, Delta,
+                [&] { EventBus->AddInterest(*this, EventType); },
+                [&] { EventBus->RemoveInterest(*this, EventType); });
+        }
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::UpdateBusyInterest()
+{
+    const bool bBusy = EventBus.IsValid() && (bExecutingPlan || !ExternalEventQueue.IsEmpty());
+
+    if (bBusy != bBusyOnEventBus)
+    {
+        bBusyOnEventBus = bBusy;
+        EventBus->SetExecutorBusy(*this, bBusy);
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::OnTimersExpired(TArrayView<const FStateChartExpiredTimer> Timers)
+{
+    for (const FStateChartExpiredTimer& Timer : Timers)
+    {
+        if (Timer.Cookie == ActionTimeoutCookie)
+        {
+            if (Timer.Handle == ActionTimeoutTimer)
+            {
+                OnActionTimeout();
+            }
+        }
+        else if ((Timer.Cookie & TimeoutCookieFlag) != 0)
+        {
+            // state may have been exited by previous timer of this batch
+            const int32 TransitionIndex = Timer.Cookie & ~TimeoutCookieFlag;
+            const int32 Slot = FindTimeoutSlot(FIndex(TransitionIndex));
+            if (Slot != INDEX_NONE && TimeoutTimers[Slot] == Timer.Handle)
+            {
+                ExecuteEventImpl(FConstStructView::Make(FStateChartTimeoutEvent(TransitionIndex, Timer.Handle)));
+            }
+        }
+        else if (DelayedEvents.IsValidIndex(Timer.Cookie) && DelayedEvents[Timer.Cookie].Timer == Timer.Handle)
+        {
+            FInstancedStruct Event = MoveTemp(DelayedEvents[Timer.Cookie].Event);
+            DelayedEvents.RemoveAt(Timer.Cookie);
+
+            ExecuteEventImpl(Event);
+        }
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ScheduleTimeouts(FIndex StateIndex)
+{
+    const TArray<FIndex>& TimedTransitions = Nodes->EventTypeIndex.TimedTransitions;
+    const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
+    const int32 RangeEnd = StateNode.TransitionIndex + StateNode.NumTransitions;
+
+    for (int32 Index = Algo::LowerBound(TimedTransitions, StateNode.TransitionIndex); Index < TimedTransitions.Num() && int32(TimedTransitions[Index]) < RangeEnd; ++Index)
+    {
+        if (!TimerWheel.IsValid())
+        {
+            UE_LOG(LogDruStateChart, Warning, TEXT("Executor of '%s' has no timer wheel. Timed transitions are never taken"), *Asset->GetPathName());
+            return;
+        }
+
+        if (TimeoutTimers.Num() != TimedTransitions.Num())
+        {
+            TimeoutTimers.SetNum(TimedTransitions.Num());
+        }
+
+        const FIndex TransitionIndex = TimedTransitions[Index];
+        const float Delay = Nodes->TransitionNodes[TransitionIndex].Definition->Delay;
+
+        TimeoutTimers[Index] = TimerWheel->Schedule(*this, TimeoutCookieFlag | uint32(int32(TransitionIndex)), Delay);
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::CancelTimeouts(FIndex StateIndex)
+{
+    const TArray<FIndex>& TimedTransitions = Nodes->EventTypeIndex.TimedTransitions;
+    const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
+    const int32 RangeEnd = StateNode.TransitionIndex + StateNode.NumTransitions;
+
+    for (int32 Index = Algo::LowerBound(TimedTransitions, StateNode.TransitionIndex); Index < TimedTransitions.Num() && int32(TimedTransitions[Index]) < RangeEnd; ++Index)
+    {
+        if (TimeoutTimers.IsValidIndex(Index) && TimeoutTimers[Index].IsValid())
+        {
+            TimerWheel->Cancel(TimeoutTimers[Index]);
+            TimeoutTimers[Index] = FStateChartTimerHandle();
+        }
+    }
+}
+
+template <EStateChartFeatures Features>
+int32 TStateChartExecutor<Features>::FindTimeoutSlot(FIndex TransitionIndex) const
+{
+    const int32 Slot = Algo::BinarySearch(Nodes->EventTypeIndex.TimedTransitions, TransitionIndex);
+    return TimeoutTimers.IsValidIndex(Slot) ? Slot : INDEX_NONE;
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::CancelAllTimers()
+{
+    if (TimerWheel.IsValid())
+    {
+        for (const FStateChartTimerHandle& Timer : TimeoutTimers)
+        {
+            TimerWheel->Cancel(Timer);
+        }
+
+        for (const FDelayedEvent& DelayedEvent : DelayedEvents)
+        {
+            TimerWheel->Cancel(DelayedEvent.Timer);
+        }
+
+        TimerWheel->Cancel(ActionTimeoutTimer);
+    }
+
+    TimeoutTimers.Reset();
+    DelayedEvents.Reset();
+    ActionTimeoutTimer = FStateChartTimerHandle();
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::Update()
+{
+    if (bExecutingPlan || Nodes->EventTypeIndex.EventlessTransitions.Num() == 0)
+    {
+        // running macrostep checks eventless transitions on its own
+        return;
+    }
+
+    if (!bHasDirtyTransitions && !bEventlessPending && Nodes->DependencyIndex.PollingTransitions.Num() == 0)
+    {
+        Stats.NumIdleUpdates += 1;
+        return;
+    }
+
+    for (FIndex TransitionIndex : Nodes->DependencyIndex.PollingTransitions)
+    {
+        InvalidateTransition(TransitionIndex);
+    }
+
+    const FTransitionIndexArray Transitions = CollectEventlessTransitions(!bEventlessPending);
+    bEventlessPending = false;
+    ClearDirtyTransitions();
+
+    StartNewPlan(Transitions, FInstancedStruct());
+
+    if (bExecutingPlan)
+    {
+        MacrostepEventlessMicrosteps += 1;
+        ProcessEventsSynchronous();
+    }
+}
+
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::InvalidateDependency(FName Dependency)
+{
+    if (const TArray<FIndex>* Transitions = Nodes->DependencyIndex.DependentTransitions.Find(Dependency))
+    {
+        for (FIndex TransitionIndex : *Transitions)
+        {
+            InvalidateTransition(TransitionIndex);
+        }
     }
 }
 
-void FStateChartDefaultExecutor::ProcessEventsSynchronous()
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::InvalidateTransition(FIndex TransitionIndex)
 {
-    while (bExecutingPlan)
+    if (DirtyTransitions.Num() != Nodes->TransitionNodes.Num())
     {
-        // process CurrentPlan, until completion or interruption by async action
-        ProcessPlanSynchronous();
+        // nodes were rebuilt after editing
+        DirtyTransitions.Init(false, Nodes->TransitionNodes.Num());
+    }
 
-        if (bExecutingPlan)
-        {
-            // not finished synchronously, need to wait for continuation
-            return;
-        }
+    DirtyTransitions[TransitionIndex] = true;
+    bHasDirtyTransitions = true;
+}
 
-        FInstancedStruct Event;
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ClearDirtyTransitions()
+{
+    if (bHasDirtyTransitions)
+    {
+        DirtyTransitions.SetRange(0, DirtyTransitions.Num(), false);
+        bHasDirtyTransitions = false;
+    }
+}
 
-        if (InternalEventQueue.Num() != 0)
-        {
-            Event = InternalEventQueue.PopFrontValue();
-        }
-        else if (ExternalEventQueue.Num() != 0)
-        {
-            Event = ExternalEventQueue.PopFrontValue();
-        }
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::FinishMacrostep()
+{
+    Stats.NumMacrosteps += 1;
+    Stats.LastMacrostepMicrosteps = MacrostepMicrosteps;
+    Stats.MaxMacrostepMicrosteps = FMath::Max(Stats.MaxMacrostepMicrosteps, MacrostepMicrosteps);
 
-        if (Event.IsValid())
-        {
-            StartNewPlan(CollectTransitions(Event), Event);
-        }
+    MacrostepMicrosteps = 0;
+    MacrostepEventlessMicrosteps = 0;
+}
+
+template <EStateChartFeatures Features>
+FConstStructView TStateChartExecutor<Features>::GetPlanEvent()
+{
+    if (!CurrentPlan->Event.IsValid() && CurrentPlan->EventTag.IsValid())
+    {
+        CurrentPlan->Event.InitializeAs<FStateChartGenericEvent>(CurrentPlan->EventTag);
     }
+
+    return CurrentPlan->Event;
 }
 
-void FStateChartDefaultExecutor::ProcessPlanSynchronous()
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ProcessPlanSynchronous()
 {
     check(bExecutingPlan);
 
     TGuardValue<bool> Guard(bInsideExecutionLoop, true);
 
-    const int32 NumSteps = CurrentPlan.Steps.Num();
+    const int32 NumSteps = CurrentPlan->Steps.Num();
+
+    uint16& StepIndex = CurrentPlan->StepIndex;
+    EActionContinuationType& ContinuationType = CurrentPlan->ContinuationType;
 
-    uint16& StepIndex = CurrentPlan.StepIndex;
-    EActionContinuationType& ContinuationType = CurrentPlan.ContinuationType;
+    if constexpr (bHasAsyncActions)
+    {
+        // previous step is no longer waited for
+        CancelActionTimeout();
+    }
 
     while (StepIndex < NumSteps)
     {
-        // reset counter. it will be updated inside respective Exit/Enter functions
-        CurrentPlan.NumActionsToComplete = 0;
-        CurrentPlan.ContinuationDelegate = FSimpleDelegate::CreateSP(this, &FStateChartDefaultExecutor::OnActionCompleted, CurrentPlan.PlanIndex, StepIndex);
+        if constexpr (bHasAsyncActions)
+        {
+            // reset counters. they will be updated inside respective Exit/Enter functions
+            CurrentPlan->NumActionsToComplete = 0;
+            CurrentPlan->StepTimeout = 0.f;
+            CurrentPlan->bStepWaitsForever = false;
+            CurrentPlan->ContinuationDelegate = FSimpleDelegate::CreateSP(this, &TStateChartExecutor::OnActionCompleted, CurrentPlanIndex, StepIndex);
+        }
 
-        auto& Step = CurrentPlan.Steps[StepIndex];
+        auto& Step = CurrentPlan->Steps[StepIndex];
 
         switch (Step.Type)
         {
@@ -202,41 +912,52 @@ void FStateChartDefaultExecutor::ProcessPlanSynchronous()
     {
         // all states processed
         bExecutingPlan = false;
-
-        // empty arrays to free up memory, in case it was allocated in the heap
-        CurrentPlan.Steps.Empty();
-        CurrentPlan.StatesForDefaultEntry.Empty();
+        ReleasePlan();
+    }
+    else if constexpr (bHasAsyncActions)
+    {
+        ScheduleActionTimeout();
     }
 }
 
-void FStateChartDefaultExecutor::RecordHistoryStates(const FStateIndexArray& StatesToExit)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::RecordHistoryStates(const FStateIndexArray& StatesToExit)
 {
+    const FStateChartHistoryTable& HistoryTable = Nodes->HistoryTable;
+
     for (FIndex StateIndex : StatesToExit)
     {
-        ForEachChild(StateIndex, [&](FIndex ChildIndex, const FStateNode& ChildNode)
+        GetSolver().ForEachChild(StateIndex, [&](FIndex ChildIndex, const FStateNode& ChildNode)
         {
             if (ChildNode.Type == EStateType::History)
             {
-                FStateIndexArray NewHistory;
+                const FStateChartHistoryTable::FSlot* Slot = HistoryTable.FindSlot(ChildIndex);
+                check(Slot != nullptr);
 
-                if (ChildNode.GetDefinition<UHistoryStateDefinition>()->HistoryType == EHistoryType::Deep)
+                if (HistoryStorage.Num() == 0)
                 {
-                    Algo::CopyIf(ActiveStates, NewHistory, [&](FIndex Index)
+                    HistoryStorage.SetNumZeroed(HistoryTable.NumStorageWords);
+                }
+
+                if (Slot->IsSingleChild())
+                {
+                    const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
+                    for (int32 Index = StateNode.ChildIndex; Index < StateNode.ChildIndex + StateNode.NumChildren; ++Index)
                     {
-                        const FStateNode& Node = Nodes->StateNodes[Index];
-                        return Node.Type == EStateType::Atomic && IsDescendant(Index, StateIndex);
-                    });
+                        if (ActiveStateBits[Index / 32] & (1u << (Index % 32)))
+                        {
+                            HistoryStorage[Slot->StorageOffset] = Index + 1;
+                            break;
+                        }
+                    }
                 }
                 else
                 {
-                    Algo::CopyIf(ActiveStates, NewHistory, [&](FIndex Index)
+                    for (int32 Word = 0; Word < Slot->NumWords; ++Word)
                     {
-                        const FStateNode& Node = Nodes->StateNodes[Index];
-                        return Node.ParentIndex == StateIndex;
-                    });
+                        HistoryStorage[Slot->StorageOffset + Word] = ActiveStateBits[HistoryTable.MaskWords[Slot->MaskOffset + Word]] & HistoryTable.Masks[Slot->MaskOffset + Word];
+                    }
                 }
-
-                HistoryLookup.Emplace(ChildIndex, MoveTemp(NewHistory));
             }
 
             return true;
@@ -244,7 +965,8 @@ void FStateChartDefaultExecutor::RecordHistoryStates(const FStateIndexArray& Sta
     }
 }
 
-EActionContinuationType FStateChartDefaultExecutor::ExitStateAsync(FIndex StateIndex)
+template <EStateChartFeatures Features>
+EActionContinuationType TStateChartExecutor<Features>::ExitStateAsync(FIndex StateIndex)
 {
     const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
 
@@ -257,19 +979,44 @@ EActionContinuationType FStateChartDefaultExecutor::ExitStateAsync(FIndex StateI
     }
 
     // shutdown state handlers
-    for (auto It = StateHandlers.CreateKeyIterator(StateIndex); It; ++It)
+    if constexpr (bHasHandlers)
+    {
+        if (StateHandlers.Num() != 0)
+        {
+            const TPair<int32, int32> Range = Nodes->HandlerTable.GetStateRange(StateIndex);
+            for (int32 Slot = Range.Key; Slot < Range.Key + Range.Value; ++Slot)
+            {
+                if (UStateHandler* Handler = StateHandlers[Slot])
+                {
+                    StateHandlers[Slot] = nullptr;
+
+                    Result = ExecuteAsyncAction([&]() { return Handler->StateExitedAsync(Context, CurrentPlan->ContinuationDelegate); }, Result, Handler->Timeout);
+                    Handler->MarkAsGarbage();
+                }
+            }
+        }
+    }
+
+    if (Nodes->EventTypeIndex.TimedTransitions.Num() != 0)
     {
-        Result = ExecuteAsyncAction([&]() { return It.Value()->StateExitedAsync(Context, CurrentPlan.ContinuationDelegate); }, Result);
-        It.Value()->MarkAsGarbage();
-        It.RemoveCurrent();
+        CancelTimeouts(StateIndex);
     }
 
-    ActiveStates.Remove(StateIndex);
+    if (ActiveStates.Remove(StateIndex) != 0 && EventBus.IsValid())
+    {
+        UpdateEventInterest(StateIndex, -1);
+    }
+
+    if (bHasHistory && ActiveStateBits.Num() != 0)
+    {
+        ActiveStateBits[StateIndex / 32] &= ~(1u << (StateIndex % 32));
+    }
 
     return Result;
 }
 
-EActionContinuationType FStateChartDefaultExecutor::ExecuteTransitionActionsAsync(FIndex TransitionIndex)
+template <EStateChartFeatures Features>
+EActionContinuationType TStateChartExecutor<Features>::ExecuteTransitionActionsAsync(FIndex TransitionIndex)
 {
     EActionContinuationType Result = EActionContinuationType::Immediate;
 
@@ -278,24 +1025,57 @@ EActionContinuationType FStateChartDefaultExecutor::ExecuteTransitionActionsAsyn
     return Result;
 }
 
-EActionContinuationType FStateChartDefaultExecutor::EnterStateAsync(FIndex StateIndex)
+template <EStateChartFeatures Features>
+EActionContinuationType TStateChartExecutor<Features>::EnterStateAsync(FIndex StateIndex)
 {
     const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
+    const int32 NumActiveStates = ActiveStates.Num();
     ActiveStates.AddUnique(StateIndex);
 
+    if (ActiveStates.Num() != NumActiveStates && EventBus.IsValid())
+    {
+        UpdateEventInterest(StateIndex, 1);
+    }
+
+    if (bHasHistory && ActiveStateBits.Num() != 0)
+    {
+        ActiveStateBits[StateIndex / 32] |= 1u << (StateIndex % 32);
+    }
+
+    if (Nodes->EventTypeIndex.TimedTransitions.Num() != 0)
+    {
+        ScheduleTimeouts(StateIndex);
+    }
+
     EActionContinuationType Result = EActionContinuationType::Immediate;
 
     // instantiate state handler
-    if (auto* ActivatableState = StateNode.GetDefinition<UActivatableStateDefinition>())
+    if constexpr (bHasHandlers)
     {
-        for (TObjectPtr<UStateHandler> HandlerTemplate : ActivatableState->Handlers)
+        auto* ActivatableState = StateNode.GetDefinition<UActivatableStateDefinition>();
+        if (ActivatableState != nullptr && ActivatableState->Handlers.Num() != 0)
         {
-            UStateHandler* InstancedHandler = DuplicateObject(HandlerTemplate, HandlerTemplate->GetOuter());
-            StateHandlers.Add(StateIndex, InstancedHandler);
+            const TPair<int32, int32> Range = Nodes->HandlerTable.GetStateRange(StateIndex);
+            check(Range.Value == ActivatableState->Handlers.Num());
+
+            if (StateHandlers.Num() == 0)
+            {
+                StateHandlers.SetNumZeroed(Nodes->HandlerTable.NumHandlers);
+            }
+
+            for (int32 HandlerIndex = 0; HandlerIndex < Range.Value; ++HandlerIndex)
+            {
+                const TObjectPtr<UStateHandler>& HandlerTemplate = ActivatableState->Handlers[HandlerIndex];
+                UStateHandler* InstancedHandler = DuplicateObject(HandlerTemplate, HandlerTemplate->GetOuter());
+                StateHandlers[Range.Key + HandlerIndex] = InstancedHandler;
 
-            StateHandlerCreatedDelegate.Broadcast(*InstancedHandler);
+                if (StateHandlerCreatedDelegate.IsValid())
+                {
+                    StateHandlerCreatedDelegate->Broadcast(*InstancedHandler);
+                }
 
-            Result = ExecuteAsyncAction([&]() { return InstancedHandler->StateEnteredAsync(CurrentPlan.Event, Context, CurrentPlan.ContinuationDelegate); }, Result);
+                Result = ExecuteAsyncAction([&]() { return InstancedHandler->StateEnteredAsync(GetPlanEvent(), Context, CurrentPlan->ContinuationDelegate); }, Result, InstancedHandler->Timeout);
+            }
         }
     }
 
@@ -306,7 +1086,7 @@ EActionContinuationType FStateChartDefaultExecutor::EnterStateAsync(FIndex State
     }
 
     // execute initial transfition actions
-    if (CurrentPlan.StatesForDefaultEntry.Contains(StateIndex))
+    if (CurrentPlan->StatesForDefaultEntry.Contains(StateIndex))
     {
         Result = ExecuteAsyncActionList(Nodes->TransitionNodes[StateNode.InitialTransitionIndex].Definition->Actions, Result);
     }
@@ -327,7 +1107,8 @@ EActionContinuationType FStateChartDefaultExecutor::EnterStateAsync(FIndex State
     return Result;
 }
 
-void FStateChartDefaultExecutor::OnActionCompleted(uint16 PlanIndex, uint16 StepIndex)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::OnActionCompleted(uint16 PlanIndex, uint16 StepIndex)
 {
     if (bInsideExecutionLoop)
     {
@@ -338,17 +1119,17 @@ void FStateChartDefaultExecutor::OnActionCompleted(uint16 PlanIndex, uint16 Step
         return;
     }
 
-    if (PlanIndex != CurrentPlan.PlanIndex || StepIndex < CurrentPlan.StepIndex - 1)
+    if (!bExecutingPlan || PlanIndex != CurrentPlanIndex || StepIndex < CurrentPlan->StepIndex - 1)
     {
-        // this is an action from previous step or plan, we don't care about it anymore
+        // this is an action from previous step or plan, or the one executor stopped waiting for. we don't care about it anymore
         return;
     }
 
-    check(StepIndex == CurrentPlan.StepIndex - 1);
+    check(StepIndex == CurrentPlan->StepIndex - 1);
 
-    CurrentPlan.NumActionsToComplete -= 1;
+    CurrentPlan->NumActionsToComplete -= 1;
 
-    if (CurrentPlan.NumActionsToComplete != 0 && CurrentPlan.ContinuationType == EActionContinuationType::LastFinish)
+    if (CurrentPlan->NumActionsToComplete != 0 && CurrentPlan->ContinuationType == EActionContinuationType::LastFinish)
     {
         // we still have some actions to complete before we can proceed to next step
         return;
@@ -358,390 +1139,323 @@ void FStateChartDefaultExecutor::OnActionCompleted(uint16 PlanIndex, uint16 Step
     ProcessEventsSynchronous();
 }
 
-FStateChartDefaultExecutor::FTransitionIndexArray FStateChartDefaultExecutor::CollectTransitions(FConstStructView Event)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ScheduleActionTimeout()
 {
-    FTransitionIndexArray Result;
-
-    for (FIndex StateIndex : ActiveStates)
+    if (CurrentPlan->bStepWaitsForever || CurrentPlan->StepTimeout <= 0.f || !TimerWheel.IsValid())
     {
-        const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
-        if (StateNode.Type != EStateType::Atomic)
-        {
-            // iterate over Atomic nodes only
-            continue;
-        }
-
-        auto CheckTransitions = [&](FIndex Index, const FStateNode& Node)
-        {
-            for (int32 TransitionIndex = 0; TransitionIndex < Node.NumTransitions; ++TransitionIndex)
-            {
-                const FTransitionNode& TransitionNode = Nodes->TransitionNodes[Node.TransitionIndex + TransitionIndex];
-                if (TransitionNode.EventID == Event.GetScriptStruct())
-                {
-                    if (EvaluateConditions(TransitionNode, Event))
-                    {
-                        Result.Add(Node.TransitionIndex + TransitionIndex);
-                        return false; // stop iteration, we found transition
-                    }
-                }
-            }
+        return;
+    }
 
-            // continue searching
-            return true;
-        };
+    ActionTimeoutTimer = TimerWheel->Schedule(*this, ActionTimeoutCookie, CurrentPlan->StepTimeout);
+}
 
-        if (CheckTransitions(StateIndex, StateNode))
-        {
-            ForEachParent(StateIndex, CheckTransitions);
-        }
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::CancelActionTimeout()
+{
+    if (ActionTimeoutTimer.IsValid())
+    {
+        TimerWheel->Cancel(ActionTimeoutTimer);
+        ActionTimeoutTimer = FStateChartTimerHandle();
     }
-
-    return RemoveConflictingTransitions(Result);
 }
 
-FStateChartDefaultExecutor::FTransitionIndexArray FStateChartDefaultExecutor::RemoveConflictingTransitions(const FTransitionIndexArray& Transitions)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::OnActionTimeout()
 {
-    FTransitionIndexArray Result;
+    ActionTimeoutTimer = FStateChartTimerHandle();
 
-    for (FIndex TransitionIndex : Transitions)
+    if (!bExecutingPlan)
     {
-        bool bPreempted = false;
-        FTransitionIndexArray TransitionsToRemove;
-
-        for (FIndex SecondTransitionIndex : Result)
-        {
-            FStateIndexArray States1;
-            FStateIndexArray States2;
+        return;
+    }
 
-            CollectStatesToExit({ { TransitionIndex } }, States1);
-            CollectStatesToExit({ { SecondTransitionIndex } }, States2);
+    const FExecutionPlanStep& Step = CurrentPlan->Steps[CurrentPlan->StepIndex - 1];
+    const FStateNode& StateNode = Step.Type == EStepType::Transition ?
+        Nodes->StateNodes[Nodes->TransitionNodes[Step.ObjectIndex].SourceNodeIndex] :
+        Nodes->StateNodes[Step.ObjectIndex];
 
-            if (Algo::AnyOf(States1, [&](FIndex Index) { return States2.Contains(Index); }))
-            {
-                if (IsDescendant(Nodes->TransitionNodes[TransitionIndex].SourceNodeIndex, Nodes->TransitionNodes[SecondTransitionIndex].SourceNodeIndex))
-                {
-                    TransitionsToRemove.AddUnique(SecondTransitionIndex);
-                }
-                else
-                {
-                    bPreempted = true;
-                    break;
-                }
-            }
-        }
+    static const TCHAR* StepNames[] = { TEXT("exit of"), TEXT("transition from"), TEXT("entry of") };
 
-        if (!bPreempted)
-        {
-            for (FIndex Index : TransitionsToRemove)
-            {
-                Result.Remove(Index);
-            }
+    UE_LOG(LogDruStateChart, Warning, TEXT("StateChart '%s' did not receive Done from %d action(s) during %s state '%s' in %.2f seconds. Continuing without them"),
+        *Asset->GetPathName(), CurrentPlan->NumActionsToComplete, StepNames[static_cast<uint8>(Step.Type)], *StateNode.Definition->FriendlyName, CurrentPlan->StepTimeout);
 
-            Result.Add(TransitionIndex);
-        }
-    }
+    Stats.NumActionTimeouts += 1;
 
-    return Result;
+    // late Done calls of abandoned actions are ignored, because plan has moved to the next step
+    CurrentPlan->NumActionsToComplete = 0;
+    ProcessEventsSynchronous();
 }
 
-void FStateChartDefaultExecutor::CollectStatesToExit(const FTransitionIndexArray& Transitions, FStateIndexArray& OutStatesToExit) const
+template <EStateChartFeatures Features>
+typename TStateChartExecutor<Features>::FTransitionIndexArray TStateChartExecutor<Features>::CollectTransitions(FConstStructView Event)
 {
-    for (FIndex TransitionIndex : Transitions)
+    if (Event.GetScriptStruct() == FStateChartGenericEvent::StaticStruct())
     {
-        const FTransitionNode& TransitionNode = Nodes->TransitionNodes[TransitionIndex];
-        if (TransitionNode.Definition->TargetStates.Num() != 0)
-        {
-            FIndex DomainStateIndex = GetTransitionDomain(TransitionNode);
-
-            for (FIndex ActiveStateIndex : ActiveStates)
-            {
-                if (IsDescendant(ActiveStateIndex, DomainStateIndex))
-                {
-                    OutStatesToExit.Add(ActiveStateIndex);
-                }
-            }
-        }
+        // tag events check only transitions that may match their tag
+        const FStateChartGenericEvent* GenericEvent = Event.GetPtr<FStateChartGenericEvent>();
+        return CollectTagTransitions(GenericEvent != nullptr ? GenericEvent->GetEventTag() : FGameplayTag(), Event);
     }
-}
 
-void FStateChartDefaultExecutor::CollectStatesToEnter(const FTransitionIndexArray& Transitions, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const
-{
-    for (FIndex TransitionIndex : Transitions)
+    if (Event.GetScriptStruct() == FStateChartTimeoutEvent::StaticStruct())
     {
-        const FTransitionNode& TransitionNode = Nodes->TransitionNodes[TransitionIndex];
-        for (const FGuid& StateID : TransitionNode.Definition->TargetStates)
-        {
-            AddDescendantStatesToEnter(Nodes->StateIDToNodeIndex[StateID], OutStatesToEnter, OutStatesForDefaultEntry);
-        }
-
-        FIndex Ancestor = GetTransitionDomain(TransitionNode);
-        for (FIndex TargetStateIndex : GetTransitionEffectiveTargets(TransitionNode))
-        {
-            AddAncestorStatesToEnter(TargetStateIndex, Ancestor, OutStatesToEnter, OutStatesForDefaultEntry);
-        }
+        const FStateChartTimeoutEvent* TimeoutEvent = Event.GetPtr<FStateChartTimeoutEvent>();
+        return TimeoutEvent != nullptr ? CollectTimeoutTransition(*TimeoutEvent, Event) : FTransitionIndexArray();
     }
-}
 
-void FStateChartDefaultExecutor::AddDescendantStatesToEnter(FIndex StateIndex, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const
-{
-    auto AddStatesToEnter = [&](const FStateIndexArray& StateIndexes, FIndex AncestorIndex)
-    {
-        for (FIndex Index : StateIndexes)
-        {
-            AddDescendantStatesToEnter(Index, OutStatesToEnter, OutStatesForDefaultEntry);
-        }
+    // candidates include transitions on parent types of the event, so derived events cost the same as exact ones
+    TArrayView<const FIndex> Candidates = Nodes->EventTypeIndex.FindCandidates(Event.GetScriptStruct());
 
-        for (FIndex Index : StateIndexes)
+    return CollectActiveTransitions([&](const FStateNode& Node)
+    {
+        return FindStateCandidate(*Nodes, Candidates, Node, [&](const FTransitionNode& TransitionNode)
         {
-            AddAncestorStatesToEnter(Index, AncestorIndex, OutStatesToEnter, OutStatesForDefaultEntry);
-        }
-    };
+            return EvaluateConditions(TransitionNode, Event);
+        });
+    });
+}
 
-    const FStateNode& StateNode = Nodes->StateNodes[StateIndex];
+template <EStateChartFeatures Features>
+typename TStateChartExecutor<Features>::FTransitionIndexArray TStateChartExecutor<Features>::CollectTagTransitions(const FGameplayTag& EventTag, FConstStructView Event)
+{
+    TArrayView<const FIndex> TagCandidates = Nodes->TagIndex.FindCandidates(EventTag);
+    TOptional<FStateChartGenericEvent> CreatedEvent;
 
-    if (StateNode.Type == EStateType::History)
+    return CollectActiveTransitions([&](const FStateNode& Node)
     {
-        const FStateIndexArray* HistoryTargetStates = HistoryLookup.Find(StateIndex);
-        if (HistoryTargetStates != nullptr)
-        {
-            AddStatesToEnter(*HistoryTargetStates, StateNode.ParentIndex);
-        }
-        else
+        return FindStateCandidate(*Nodes, TagCandidates, Node, [&](const FTransitionNode& TransitionNode)
         {
-            const FTransitionNode& HistoryTransition = Nodes->TransitionNodes[StateNode.TransitionIndex];
+            if (TransitionNode.Definition->Conditions.Num() != 0 && Event.GetScriptStruct() == nullptr)
+            {
+                // Conditions may need payload
+                Event = FConstStructView::Make(CreatedEvent.Emplace(EventTag));
+            }
 
-            FStateIndexArray TargetStates;
-            Algo::Transform(HistoryTransition.Definition->TargetStates, TargetStates, [&](const FGuid& StateID) { return Nodes->StateIDToNodeIndex[StateID]; });
-            AddStatesToEnter(TargetStates, StateNode.ParentIndex);
-        }
-    }
-    else
-    {
-        OutStatesToEnter.AddUnique(StateIndex);
+            return EvaluateConditions(TransitionNode, Event);
+        });
+    });
+}
 
-        if (StateNode.Type == EStateType::Compound)
-        {
-            OutStatesForDefaultEntry.AddUnique(StateIndex);
+template <EStateChartFeatures Features>
+typename TStateChartExecutor<Features>::FTransitionIndexArray TStateChartExecutor<Features>::CollectEventlessTransitions(bool bOnlyDirty)
+{
+    TArrayView<const FIndex> Candidates = Nodes->EventTypeIndex.EventlessTransitions;
 
-            FStateIndexArray TargetStates;
-            Algo::Transform(Nodes->TransitionNodes[StateNode.InitialTransitionIndex].Definition->TargetStates, TargetStates, [&](const FGuid& StateID) { return Nodes->StateIDToNodeIndex[StateID]; });
-            AddStatesToEnter(TargetStates, StateIndex);
-        }
-        else if(StateNode.Type == EStateType::Parallel)
+    return CollectActiveTransitions([&](const FStateNode& Node)
+    {
+        return FindStateCandidate(*Nodes, Candidates, Node, [&](const FTransitionNode& TransitionNode)
         {
-            ForEachChild(StateIndex, [&](FIndex ChildIndex, auto)
+            if (bOnlyDirty)
             {
-                if (!Algo::AnyOf(OutStatesToEnter, [&](FIndex ExistingIndex) { return IsDescendant(ExistingIndex, ChildIndex); }))
+                // clean transitions were rejected last time and nothing they depend on changed since then
+                const int32 TransitionIndex = UE_PTRDIFF_TO_INT32(&TransitionNode - Nodes->TransitionNodes.GetData());
+                if (!DirtyTransitions.IsValidIndex(TransitionIndex) || !DirtyTransitions[TransitionIndex])
                 {
-                    AddDescendantStatesToEnter(ChildIndex, OutStatesToEnter, OutStatesForDefaultEntry);
+                    Stats.NumEventlessEvaluationsAvoided += 1;
+                    return false;
                 }
-                return true;
-            });
-        }
-    }
+            }
+
+            Stats.NumEventlessEvaluations += 1;
+            return EvaluateConditions(TransitionNode, FConstStructView());
+        });
+    });
 }
 
-void FStateChartDefaultExecutor::AddAncestorStatesToEnter(FIndex StateIndex, FIndex AncestorIndex, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const
+template <EStateChartFeatures Features>
+typename TStateChartExecutor<Features>::FTransitionIndexArray TStateChartExecutor<Features>::CollectTimeoutTransition(const FStateChartTimeoutEvent& Timeout, FConstStructView Event)
 {
-    ForEachParent(StateIndex, [&](FIndex Index, const FStateNode& StateNode)
+    FTransitionIndexArray Result;
+
+    // timer is reset when source state exits, so stale timeouts do not match
+    const int32 Slot = FindTimeoutSlot(FIndex(Timeout.TransitionIndex));
+    if (Slot == INDEX_NONE || TimeoutTimers[Slot] != Timeout.Timer)
     {
-        if (Index == AncestorIndex)
-        {
-            return false;
-        }
+        return Result;
+    }
 
-        OutStatesToEnter.AddUnique(Index);
+    TimeoutTimers[Slot] = FStateChartTimerHandle();
 
-        if (StateNode.Type == EStateType::Parallel)
-        {
-            ForEachChild(StateIndex, [&](FIndex ChildIndex, auto)
-            {
-                if (!Algo::AnyOf(OutStatesToEnter, [&](FIndex ExistingIndex) { return IsDescendant(ExistingIndex, StateIndex); }))
-                {
-                    AddDescendantStatesToEnter(ChildIndex, OutStatesToEnter, OutStatesForDefaultEntry);
-                }
-                return true;
-            });
-        }
+    if constexpr (bHasConditions)
+    {
+        ResetGuardResults();
+    }
 
-        return true;
-    });
+    if (EvaluateConditions(Nodes->TransitionNodes[Timeout.TransitionIndex], Event))
+    {
+        Result.Add(Timeout.TransitionIndex);
+    }
+
+    return Result;
 }
 
-FIndex FStateChartDefaultExecutor::GetTransitionDomain(const FTransitionNode& Transition) const
+template <EStateChartFeatures Features>
+template <typename TFindTransition>
+typename TStateChartExecutor<Features>::FTransitionIndexArray TStateChartExecutor<Features>::CollectActiveTransitions(TFindTransition&& FindTransition)
 {
-    FStateIndexArray TargetStates = GetTransitionEffectiveTargets(Transition);
+    if constexpr (bHasConditions)
+    {
+        // identical guards of different states are evaluated once per event
+        ResetGuardResults();
+    }
 
-    if (TargetStates.Num() == 0)
+    return GetSolver().CollectActiveTransitions(Forward<TFindTransition>(FindTransition));
+}
+
+template <EStateChartFeatures Features>
+EActionContinuationType TStateChartExecutor<Features>::ExecuteAsyncActionList(TArray<FInstancedStruct>& ActionList, EActionContinuationType ExistingResult)
+{
+    for (FInstancedStruct& ActionStruct : ActionList)
     {
-        return FIndex::None;
+        if (auto* Action = ActionStruct.GetMutablePtr<FStateChartAction>())
+        {
+            ExistingResult = ExecuteAsyncAction([&] { return Action->ExecuteAsync(Context, CurrentPlan->ContinuationDelegate); }, ExistingResult, Action->Timeout);
+        }
     }
 
-    return FindLeastCommonCompoundAncestor(Transition.SourceNodeIndex, TargetStates);
+    return ExistingResult;
 }
 
-FStateChartDefaultExecutor::FStateIndexArray FStateChartDefaultExecutor::GetTransitionEffectiveTargets(const FTransitionNode& Transition) const
+template <EStateChartFeatures Features>
+EActionContinuationType TStateChartExecutor<Features>::ExecuteAsyncAction(TFunctionRef<EActionContinuationType()> Action, EActionContinuationType ExistingResult, float Timeout)
 {
-    FStateIndexArray Result;
+    TGuardValue<bool> Guard(bInsideActionExecution, true);
 
-    for (const FGuid& StateID : Transition.Definition->TargetStates)
+    if constexpr (!bHasAsyncActions)
+    {
+        // every action completes synchronously, nothing to track
+        Action();
+        return ExistingResult;
+    }
+    else
     {
-        FIndex TargetStateIndex = Nodes->StateIDToNodeIndex[StateID];
-        const FStateNode& TargetStateNode = Nodes->StateNodes[TargetStateIndex];
+        bLastActionExecutedSynchronously = false;
+        EActionContinuationType ActionResult = Action();
 
-        if (TargetStateNode.Type == EStateType::History)
+        if (bLastActionExecutedSynchronously)
         {
-            const FStateIndexArray* HistoryTargetStates = HistoryLookup.Find(TargetStateIndex);
-            if (HistoryTargetStates != nullptr)
+            // ignore what was returned because it completed immediately
+            ActionResult = EActionContinuationType::Immediate;
+        }
+        else
+        {
+            // otherwise remember to wait for this action completion
+            CurrentPlan->NumActionsToComplete += 1;
+
+            const float EffectiveTimeout = Timeout > 0.f ? Timeout : Asset->GetDefaultActionTimeout();
+            if (EffectiveTimeout > 0.f)
             {
-                AppendUnique(Result, *HistoryTargetStates);
+                CurrentPlan->StepTimeout = FMath::Max(CurrentPlan->StepTimeout, EffectiveTimeout);
             }
             else
             {
-                auto TA = GetTransitionEffectiveTargets(Nodes->TransitionNodes[TargetStateNode.TransitionIndex]);
-                AppendUnique(Result, TA);
+                CurrentPlan->bStepWaitsForever = true;
             }
         }
-        else
-        {
-            Result.Add(TargetStateIndex);
-        }
-    }
 
-    return Result;
-}
-
-FIndex FStateChartDefaultExecutor::FindLeastCommonCompoundAncestor(FIndex BaseIndex, const FStateIndexArray& States) const
-{
-    FIndex Result;
-
-    ForEachParent(BaseIndex, [&](FIndex Index, const FStateNode& Node)
-    {
-        if (Algo::AllOf(States, [&](FIndex Index2) { return IsDescendant(Index2, Index); }))
+        if (ActionResult == EActionContinuationType::Default)
         {
-            Result = Index;
-            return false;
+            // take value from statechart asset
+            ActionResult = Asset->GetDefaultContinuationType();
         }
 
-        return true;
-    });
-
-    return Result;
+        return FMath::Max(ActionResult, ExistingResult);
+    }
 }
 
-bool FStateChartDefaultExecutor::IsDescendant(FIndex Child, FIndex Parent) const
+template <EStateChartFeatures Features>
+bool TStateChartExecutor<Features>::EvaluateConditions(const FTransitionNode& TransitionNode, FConstStructView Event)
 {
-    bool bResult = false;
-    ForEachParent(Child, [&](FIndex Index, const FStateNode& Node)
+    if constexpr (bHasConditions)
     {
-        if (Parent == Index)
+        const TArray<FInstancedStruct>& Conditions = TransitionNode.Definition->Conditions;
+        if (Conditions.Num() == 0)
         {
-            bResult = true;
-            return false;
+            return true;
         }
 
-        if (Index < Parent)
+        const int32 TransitionIndex = UE_PTRDIFF_TO_INT32(&TransitionNode - Nodes->TransitionNodes.GetData());
+        TArrayView<const FIndex> GuardIDs = Nodes->GuardTable.GetTransitionGuards(TransitionIndex);
+        check(GuardIDs.Num() == Conditions.Num());
+
+        for (int32 Index = 0; Index < Conditions.Num(); ++Index)
         {
-            // Index is at a higher level than Parent, stop iterating
-            return false;
+            if (!EvaluateCondition(Conditions[Index], GuardIDs[Index], Event))
+            {
+                return false;
+            }
         }
+    }
 
-        return true;
-    });
-
-    return bResult;
+    return true;
 }
 
-void FStateChartDefaultExecutor::ForEachParent(FIndex StateIndex, TFunctionRef<bool(FIndex, const FStateNode&)> Action) const
+template <EStateChartFeatures Features>
+bool TStateChartExecutor<Features>::EvaluateCondition(const FInstancedStruct& Struct, FIndex GuardID, FConstStructView Event)
 {
-    if (StateIndex.IsNone())
+    const FStateChartCondition* Condition = Struct.GetPtr<FStateChartCondition>();
+    if (Condition == nullptr)
     {
-        return;
+        return true;
     }
 
-    FIndex CurrentIndex = Nodes->StateNodes[StateIndex].ParentIndex;
-    while (!CurrentIndex.IsNone())
+    if (GuardID.IsNone())
     {
-        auto& CurrentNode = Nodes->StateNodes[CurrentIndex];
-        if (!Action(CurrentIndex, CurrentNode))
-        {
-            break;
-        }
-
-        CurrentIndex = CurrentNode.ParentIndex;
+        return Condition->Evaluate(Context, Event);
     }
-}
 
-void FStateChartDefaultExecutor::ForEachChild(FIndex StateIndex, TFunctionRef<bool(FIndex, const FStateNode&)> Action) const
-{
-    if (StateIndex.IsNone())
+    if (GuardResults.Num() != Nodes->GuardTable.NumGuards)
     {
-        return;
+        // guard table was rebuilt after editing
+        GuardResults.Reset();
+        GuardResults.SetNum(Nodes->GuardTable.NumGuards);
     }
 
-    const FStateNode& Node = Nodes->StateNodes[StateIndex];
-    for (int32 i = 0; i < Node.NumChildren; ++i)
+    FGuardResult& Result = GuardResults[GuardID];
+    if (Result.Epoch != GuardEpoch)
     {
-        const int32 ChildIndex = Node.ChildIndex + i;
-        if (!Action(ChildIndex, Nodes->StateNodes[ChildIndex]))
-        {
-            break;
-        }
+        Result.Epoch = GuardEpoch;
+        Result.bPassed = Condition->Evaluate(Context, Event);
     }
+
+    return Result.bPassed;
 }
 
-EActionContinuationType FStateChartDefaultExecutor::ExecuteAsyncActionList(TArray<FInstancedStruct>& ActionList, EActionContinuationType ExistingResult)
+template <EStateChartFeatures Features>
+void TStateChartExecutor<Features>::ResetGuardResults()
 {
-    for (FInstancedStruct& ActionStruct : ActionList)
+    if (++GuardEpoch == 0)
     {
-        if (auto* Action = ActionStruct.GetMutablePtr<FStateChartAction>())
-        {
-            ExistingResult = ExecuteAsyncAction([&] { return Action->ExecuteAsync(Context, CurrentPlan.ContinuationDelegate); }, ExistingResult);
-        }
+        // epoch wrapped around, old results may look valid again
+        GuardResults.Reset();
+        GuardEpoch = 1;
     }
-
-    return ExistingResult;
 }
 
-EActionContinuationType FStateChartDefaultExecutor::ExecuteAsyncAction(TFunctionRef<EActionContinuationType()> Action, EActionContinuationType ExistingResult)
-{
-    TGuardValue<bool> Guard(bInsideActionExecution, true);
+template class DRUSTATECHART_API TStateChartExecutor<EStateChartFeatures::All>;
 
-    bLastActionExecutedSynchronously = false;
-    EActionContinuationType ActionResult = Action();
+template <EStateChartFeatures Features>
+TSharedRef<IStateChartExecutor> MakeSpecializedExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject)
+{
+    return MakeShared<TStateChartExecutor<Features>>(StateChartAsset, ContextObject);
+}
 
-    if (bLastActionExecutedSynchronously)
-    {
-        // ignore what was returned because it completed immediately
-        ActionResult = EActionContinuationType::Immediate;
-    }
-    else
-    {
-        // otherwise remember to wait for this action completion
-        CurrentPlan.NumActionsToComplete += 1;
-    }
+template <uint8... FeatureMasks>
+TSharedRef<IStateChartExecutor> MakeSpecializedExecutorByMask(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject, EStateChartFeatures Features, TIntegerSequence<uint8, FeatureMasks...>)
+{
+    using FFactory = TSharedRef<IStateChartExecutor>(*)(UStateChartAsset&, TObjectPtr<UObject>);
 
-    if (ActionResult == EActionContinuationType::Default)
-    {
-        // take value from statechart asset
-        ActionResult = Asset->GetDefaultContinuationType();
-    }
+    // one instantiation per combination of features
+    static constexpr FFactory Factories[] = { &MakeSpecializedExecutor<static_cast<EStateChartFeatures>(FeatureMasks)>... };
 
-    return FMath::Max(ActionResult, ExistingResult);
+    return Factories[static_cast<uint8>(Features)](StateChartAsset, ContextObject);
 }
 
-bool FStateChartDefaultExecutor::EvaluateConditions(const FTransitionNode& TransitionNode, FConstStructView Event) const
+TSharedRef<IStateChartExecutor> CreateSpecializedExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject, EStateChartFeatures RequestedFeatures)
 {
-    for (const FInstancedStruct& Struct : TransitionNode.Definition->Conditions)
-    {
-        auto* Condition = Struct.GetPtr<FStateChartCondition>();
-        if (Condition && !Condition->Evaluate(Context, Event))
-        {
-            return false;
-        }
-    }
+    const EStateChartFeatures Features = RequestedFeatures | StateChartAsset.GetAssembledNodes().Features;
 
-    return true;
+    return MakeSpecializedExecutorByMask(StateChartAsset, ContextObject, Features, TMakeIntegerSequence<uint8, static_cast<uint8>(EStateChartFeatures::All) + 1>());
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Impl/StateChartElements.h"
+#include "StateChartAsset.h"
+#include "StateChartEvent.h"
+
+UScriptStruct* UTransitionDefinition::GetTriggerEventType() const
+{
+    if (Delay > 0.f)
+    {
+        return FStateChartTimeoutEvent::StaticStruct();
+    }
+
+    return EventTag.IsValid() ? FStateChartGenericEvent::StaticStruct() : EventID.Get();
+}
+
+#if WITH_EDITOR
+void UStateChartElementAsset::NotifyOwner(EStateChartElementChange Change)
+{
+    if (UStateChartAsset* StateChart = GetTypedOuter<UStateChartAsset>())
+    {
+        StateChart->NotifyElementChanged(*this, Change);
+    }
+}
+
+void UTransitionDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+
+    const bool bReordered = PropertyName == GET_MEMBER_NAME_CHECKED(UTransitionDefinition, SourceState)
+        || PropertyName == GET_MEMBER_NAME_CHECKED(UTransitionDefinition, SortOrder)
+        || PropertyName == GET_MEMBER_NAME_CHECKED(UTransitionDefinition, bInitial);
+
+    NotifyOwner(bReordered ? EStateChartElementChange::Reordered : EStateChartElementChange::Modified);
+}
+
+void UBaseStateDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(UBaseStateDefinition, ParentID))
+    {
+        NotifyOwner(EStateChartElementChange::Reparented);
+    }
+    else if (PropertyName == GET_MEMBER_NAME_CHECKED(UActivatableStateDefinition, SortOrder) || PropertyName == GET_MEMBER_NAME_CHECKED(UBaseStateDefinition, ID))
+    {
+        NotifyOwner(EStateChartElementChange::Reordered);
+    }
+    else
+    {
+        NotifyOwner(EStateChartElementChange::Modified);
+    }
+}
+#endif
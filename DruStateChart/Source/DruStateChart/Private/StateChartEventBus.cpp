@@ -0,0 +1,132 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartEventBus.h"
+#include "StateChartEvent.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "Algo/Unique.h"
+
+int32 FStateChartEventBus::Broadcast(FConstStructView Event)
+{
+    // executors match generic events by tag, same as events sent with BroadcastTag
+    const FStateChartGenericEvent* GenericEvent = Event.GetScriptStruct() == FStateChartGenericEvent::StaticStruct() ? Event.GetPtr<FStateChartGenericEvent>() : nullptr;
+    const FGameplayTag EventTag = GenericEvent != nullptr ? GenericEvent->GetEventTag() : FGameplayTag();
+
+    return Deliver(Event.GetScriptStruct(), EventTag, [&](IStateChartExecutor& Executor) { Executor.ExecuteEvent(Event); });
+}
+
+int32 FStateChartEventBus::BroadcastTag(const FGameplayTag& EventTag)
+{
+    return Deliver(FStateChartGenericEvent::StaticStruct(), EventTag, [&](IStateChartExecutor& Executor) { Executor.ExecuteTagEvent(EventTag); });
+}
+
+void FStateChartEventBus::AddExecutor(IStateChartExecutor& Executor)
+{
+    NumExecutors += 1;
+}
+
+void FStateChartEventBus::RemoveExecutor(IStateChartExecutor& Executor)
+{
+    NumExecutors -= 1;
+    BusyExecutors.Remove(&Executor);
+}
+
+void FStateChartEventBus::AddInterest(IStateChartExecutor& Executor, const UScriptStruct* EventType)
+{
+    InterestedExecutors.FindOrAdd(EventType).Add(&Executor);
+}
+
+void FStateChartEventBus::RemoveInterest(IStateChartExecutor& Executor, const UScriptStruct* EventType)
+{
+    if (TSet<IStateChartExecutor*>* Executors = InterestedExecutors.Find(EventType))
+    {
+        Executors->Remove(&Executor);
+    }
+}
+
+void FStateChartEventBus::AddTagInterest(IStateChartExecutor& Executor, const FGameplayTag& EventTag)
+{
+    TagInterestedExecutors.FindOrAdd(EventTag).Add(&Executor);
+}
+
+void FStateChartEventBus::RemoveTagInterest(IStateChartExecutor& Executor, const FGameplayTag& EventTag)
+{
+    if (TSet<IStateChartExecutor*>* Executors = TagInterestedExecutors.Find(EventTag))
+    {
+        Executors->Remove(&Executor);
+    }
+}
+
+void FStateChartEventBus::SetExecutorBusy(IStateChartExecutor& Executor, bool bBusy)
+{
+    if (bBusy)
+    {
+        BusyExecutors.Add(&Executor);
+    }
+    else
+    {
+        BusyExecutors.Remove(&Executor);
+    }
+}
+
+int32 FStateChartEventBus::GetNumInterested(const UScriptStruct* EventType) const
+{
+    const TSet<IStateChartExecutor*>* Executors = InterestedExecutors.Find(EventType);
+    return Executors != nullptr ? Executors->Num() : 0;
+}
+
+template <typename TDeliver>
+int32 FStateChartEventBus::Deliver(const UScriptStruct* EventType, const FGameplayTag& EventTag, TDeliver&& DeliverToExecutor)
+{
+    // recipients are collected first, because delivery changes interests of executors
+    TArray<TSharedRef<IStateChartExecutor>, TInlineAllocator<16>> Recipients;
+    int32 NumSources = 0;
+
+    auto AddRecipients = [&](const TSet<IStateChartExecutor*>* Executors)
+    {
+        if (Executors != nullptr && Executors->Num() != 0)
+        {
+            NumSources += 1;
+            for (IStateChartExecutor* Executor : *Executors)
+            {
+                Recipients.Add(Executor->AsShared());
+            }
+        }
+    };
+
+    // transitions on parent types are triggered by derived events too
+    for (const UStruct* Type = EventType; Type != nullptr; Type = Type->GetSuperStruct())
+    {
+        AddRecipients(InterestedExecutors.Find(static_cast<const UScriptStruct*>(Type)));
+    }
+
+    AddRecipients(InterestedExecutors.Find(FStateChartAnyEvent::StaticStruct()));
+
+    // transitions on parent tags are triggered by child tags too
+    for (FGameplayTag Tag = EventTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+    {
+        AddRecipients(TagInterestedExecutors.Find(Tag));
+    }
+
+    // their queued events and running plan are handled against states that may differ from active ones
+    AddRecipients(&BusyExecutors);
+
+    if (NumSources > 1)
+    {
+        // executor may be interested in several types and tags of the chain
+        Recipients.Sort([](const TSharedRef<IStateChartExecutor>& A, const TSharedRef<IStateChartExecutor>& B) { return &A.Get() < &B.Get(); });
+        Recipients.SetNum(Algo::Unique(Recipients));
+    }
+
+    for (const TSharedRef<IStateChartExecutor>& Recipient : Recipients)
+    {
+        DeliverToExecutor(*Recipient);
+    }
+
+    Stats.NumBroadcasts += 1;
+    Stats.NumDeliveries += Recipients.Num();
+    Stats.NumDeliveriesAvoided += FMath::Max(NumExecutors - Recipients.Num(), 0);
+    Stats.LastFanOut = Recipients.Num();
+    Stats.MaxFanOut = FMath::Max(Stats.MaxFanOut, Recipients.Num());
+
+    return Recipients.Num();
+}
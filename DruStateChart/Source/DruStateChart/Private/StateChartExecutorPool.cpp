@@ -0,0 +1,85 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartExecutorPool.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "StateChartAsset.h"
+#include "StateChartEventBus.h"
+#include "StateChartTimerWheel.h"
+
+FStateChartExecutorPool::FStateChartExecutorPool(UStateChartAsset& InAsset, TSharedPtr<FStateChartTimerWheel> InTimerWheel, TSharedPtr<FStateChartEventBus> InEventBus)
+    : Asset(&InAsset)
+    , TimerWheel(MoveTemp(InTimerWheel))
+    , EventBus(MoveTemp(InEventBus))
+{
+}
+
+void FStateChartExecutorPool::Reserve(int32 NumExecutors)
+{
+    PooledExecutors.Reserve(NumExecutors);
+
+    while (PooledExecutors.Num() < NumExecutors)
+    {
+        PooledExecutors.Add(CreateExecutor(nullptr));
+    }
+}
+
+TSharedRef<IStateChartExecutor> FStateChartExecutorPool::Acquire(TObjectPtr<UObject> ContextObject)
+{
+    if (PooledExecutors.Num() == 0)
+    {
+        return CreateExecutor(ContextObject);
+    }
+
+    TSharedRef<IStateChartExecutor> Executor = PooledExecutors.Pop();
+    Executor->Reset(ContextObject);
+    NumReused += 1;
+
+    return Executor;
+}
+
+void FStateChartExecutorPool::Release(const TSharedRef<IStateChartExecutor>& Executor)
+{
+    check(Executor->GetExecutingAsset() == Asset);
+
+    // stopped now, so exit actions run while the owner of the executor still exists
+    Executor->Stop();
+    PooledExecutors.Add(Executor);
+}
+
+void FStateChartExecutorPool::Trim(int32 MaxPooled)
+{
+    MaxPooled = FMath::Max(MaxPooled, 0);
+
+    if (PooledExecutors.Num() > MaxPooled)
+    {
+        PooledExecutors.RemoveAt(MaxPooled, PooledExecutors.Num() - MaxPooled);
+    }
+}
+
+void FStateChartExecutorPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    Collector.AddReferencedObject(Asset);
+}
+
+FString FStateChartExecutorPool::GetReferencerName() const
+{
+    return TEXT("StateChartExecutorPool");
+}
+
+TSharedRef<IStateChartExecutor> FStateChartExecutorPool::CreateExecutor(TObjectPtr<UObject> ContextObject)
+{
+    TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*Asset, ContextObject);
+
+    if (TimerWheel.IsValid())
+    {
+        Executor->SetTimerWheel(TimerWheel);
+    }
+
+    if (EventBus.IsValid())
+    {
+        Executor->SetEventBus(EventBus);
+    }
+
+    NumCreated += 1;
+    return Executor;
+}
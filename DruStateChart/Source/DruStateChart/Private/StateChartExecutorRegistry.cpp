@@ -0,0 +1,85 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Impl/StateChartExecutorRegistry.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "StateChartAsset.h"
+
+namespace DruStateChart_Impl
+{
+
+TUniquePtr<FStateChartExecutorRegistry> FStateChartExecutorRegistry::Instance;
+
+FStateChartExecutorRegistry& FStateChartExecutorRegistry::Get()
+{
+    check(Instance.IsValid());
+    return *Instance;
+}
+
+FStateChartExecutorRegistry* FStateChartExecutorRegistry::TryGet()
+{
+    return Instance.Get();
+}
+
+void FStateChartExecutorRegistry::Startup()
+{
+    check(!Instance.IsValid());
+    Instance = MakeUnique<FStateChartExecutorRegistry>();
+}
+
+void FStateChartExecutorRegistry::Shutdown()
+{
+    Instance.Reset();
+}
+
+int32 FStateChartExecutorRegistry::Add(IStateChartExecutor& Executor, UStateChartAsset& Asset)
+{
+    int32 AssetIndex = INDEX_NONE;
+    for (auto It = Assets.CreateIterator(); It; ++It)
+    {
+        if (It->Asset == &Asset)
+        {
+            AssetIndex = It.GetIndex();
+            break;
+        }
+    }
+
+    if (AssetIndex == INDEX_NONE)
+    {
+        AssetIndex = Assets.Add({ &Asset, 0 });
+    }
+
+    Assets[AssetIndex].NumExecutors += 1;
+
+    return Executors.Add({ &Executor, AssetIndex });
+}
+
+void FStateChartExecutorRegistry::Remove(int32 Slot)
+{
+    const int32 AssetIndex = Executors[Slot].AssetIndex;
+    Executors.RemoveAt(Slot);
+
+    if (--Assets[AssetIndex].NumExecutors == 0)
+    {
+        Assets.RemoveAt(AssetIndex);
+    }
+}
+
+void FStateChartExecutorRegistry::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    for (FAssetEntry& Entry : Assets)
+    {
+        Collector.AddReferencedObject(Entry.Asset);
+    }
+
+    for (const FExecutorEntry& Entry : Executors)
+    {
+        Entry.Executor->AddReferencedObjects(Collector);
+    }
+}
+
+FString FStateChartExecutorRegistry::GetReferencerName() const
+{
+    return TEXT("StateChartExecutorRegistry");
+}
+
+}
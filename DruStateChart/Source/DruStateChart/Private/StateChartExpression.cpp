@@ -0,0 +1,439 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Impl/StateChartExpression.h"
+#include "Misc/Char.h"
+#include "UObject/Class.h"
+#include "UObject/UnrealType.h"
+
+namespace DruStateChart_Impl
+{
+
+/*
+ * Recursive descent parser that emits bytecode while parsing.
+ * Result of every subexpression is written to register equal to its depth, so no register allocation is needed
+ */
+class FStateChartExpressionCompiler
+{
+    using EOpCode = FStateChartExpression::EOpCode;
+
+public:
+    FStateChartExpressionCompiler(FStateChartExpression& InExpression, const FString& InSource, const UStruct& InContextType)
+        : Expression(InExpression)
+        , Source(InSource)
+        , ContextType(InContextType)
+    {
+    }
+
+    bool Compile(FString& OutError)
+    {
+        ParseOr(0);
+        SkipWhitespace();
+
+        if (Error.IsEmpty() && Position < Source.Len())
+        {
+            SetError(TEXT("Unexpected character"));
+        }
+
+        OutError = Error;
+        return Error.IsEmpty();
+    }
+
+private:
+    void ParseOr(uint8 Target)
+    {
+        ParseLogical(Target, TEXT("||"), EOpCode::JumpIfTrue, &FStateChartExpressionCompiler::ParseAnd);
+    }
+
+    void ParseAnd(uint8 Target)
+    {
+        ParseLogical(Target, TEXT("&&"), EOpCode::JumpIfFalse, &FStateChartExpressionCompiler::ParseComparison);
+    }
+
+    /* Operands are evaluated into the same register, evaluation stops as soon as result is known */
+    void ParseLogical(uint8 Target, const TCHAR* Operator, EOpCode JumpOpCode, void (FStateChartExpressionCompiler::*ParseOperand)(uint8))
+    {
+        (this->*ParseOperand)(Target);
+
+        TArray<int32, TInlineAllocator<8>> Jumps;
+        while (Error.IsEmpty() && Match(Operator))
+        {
+            Jumps.Add(Emit(JumpOpCode, 0, Target));
+            (this->*ParseOperand)(Target);
+        }
+
+        if (Jumps.Num() != 0)
+        {
+            for (int32 Jump : Jumps)
+            {
+                Expression.Instructions[Jump].Operand = Expression.Instructions.Num();
+            }
+
+            Emit(EOpCode::ToBool, Target, Target);
+        }
+    }
+
+    void ParseComparison(uint8 Target)
+    {
+        ParseAdditive(Target);
+
+        static const TPair<const TCHAR*, EOpCode> Operators[] =
+        {
+            { TEXT("<="), EOpCode::LessEqual },
+            { TEXT(">="), EOpCode::GreaterEqual },
+            { TEXT("=="), EOpCode::Equal },
+            { TEXT("!="), EOpCode::NotEqual },
+            { TEXT("<"), EOpCode::Less },
+            { TEXT(">"), EOpCode::Greater },
+        };
+
+        for (const auto& Operator : Operators)
+        {
+            if (Error.IsEmpty() && Match(Operator.Key))
+            {
+                ParseBinaryOperand(Target, Operator.Value, &FStateChartExpressionCompiler::ParseAdditive);
+                break;
+            }
+        }
+    }
+
+    void ParseAdditive(uint8 Target)
+    {
+        ParseMultiplicative(Target);
+
+        while (Error.IsEmpty())
+        {
+            if (Match(TEXT("+")))
+            {
+                ParseBinaryOperand(Target, EOpCode::Add, &FStateChartExpressionCompiler::ParseMultiplicative);
+            }
+            else if (Match(TEXT("-")))
+            {
+                ParseBinaryOperand(Target, EOpCode::Subtract, &FStateChartExpressionCompiler::ParseMultiplicative);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    void ParseMultiplicative(uint8 Target)
+    {
+        ParseUnary(Target);
+
+        while (Error.IsEmpty())
+        {
+            if (Match(TEXT("*")))
+            {
+                ParseBinaryOperand(Target, EOpCode::Multiply, &FStateChartExpressionCompiler::ParseUnary);
+            }
+            else if (Match(TEXT("/")))
+            {
+                ParseBinaryOperand(Target, EOpCode::Divide, &FStateChartExpressionCompiler::ParseUnary);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /* Parses right operand into next register and combines it with left one */
+    void ParseBinaryOperand(uint8 Target, EOpCode OpCode, void (FStateChartExpressionCompiler::*ParseOperand)(uint8))
+    {
+        if (Target + 1 >= FStateChartExpression::MaxRegisters)
+        {
+            SetError(TEXT("Expression is too complex"));
+            return;
+        }
+
+        (this->*ParseOperand)(Target + 1);
+        Emit(OpCode, Target, Target, Target + 1);
+    }
+
+    void ParseUnary(uint8 Target)
+    {
+        // '!=' is handled by comparison, it never starts an operand
+        if (Match(TEXT("!")))
+        {
+            ParseUnary(Target);
+            Emit(EOpCode::Not, Target, Target);
+        }
+        else if (Match(TEXT("-")))
+        {
+            ParseUnary(Target);
+            Emit(EOpCode::Negate, Target, Target);
+        }
+        else
+        {
+            ParsePrimary(Target);
+        }
+    }
+
+    void ParsePrimary(uint8 Target)
+    {
+        SkipWhitespace();
+
+        if (Position >= Source.Len())
+        {
+            SetError(TEXT("Unexpected end of expression"));
+            return;
+        }
+
+        const TCHAR Char = Source[Position];
+
+        if (Char == TEXT('('))
+        {
+            Position++;
+            ParseOr(Target);
+
+            if (Error.IsEmpty() && !Match(TEXT(")")))
+            {
+                SetError(TEXT("Expected ')'"));
+            }
+        }
+        else if (FChar::IsDigit(Char) || Char == TEXT('.'))
+        {
+            const int32 Start = Position;
+            int32 NumDots = 0;
+            while (Position < Source.Len() && (FChar::IsDigit(Source[Position]) || Source[Position] == TEXT('.')))
+            {
+                NumDots += Source[Position] == TEXT('.') ? 1 : 0;
+                Position++;
+            }
+
+            if (NumDots > 1 || Position - Start == NumDots)
+            {
+                // Atod would silently stop at the second dot
+                Position = Start;
+                SetError(TEXT("Malformed number"));
+                return;
+            }
+
+            EmitConstant(Target, FCString::Atod(*Source.Mid(Start, Position - Start)));
+
+            // allow C++ style float literals
+            if (Position < Source.Len() && (Source[Position] == TEXT('f') || Source[Position] == TEXT('F')))
+            {
+                Position++;
+            }
+        }
+        else if (FChar::IsAlpha(Char) || Char == TEXT('_'))
+        {
+            const int32 Start = Position;
+            while (Position < Source.Len() && (FChar::IsAlnum(Source[Position]) || Source[Position] == TEXT('_') || Source[Position] == TEXT('.')))
+            {
+                Position++;
+            }
+
+            const FString Identifier = Source.Mid(Start, Position - Start);
+
+            if (Identifier == TEXT("true"))
+            {
+                EmitConstant(Target, 1.0);
+            }
+            else if (Identifier == TEXT("false"))
+            {
+                EmitConstant(Target, 0.0);
+            }
+            else
+            {
+                EmitPropertyLoad(Target, Identifier);
+            }
+        }
+        else
+        {
+            SetError(TEXT("Unexpected character"));
+        }
+    }
+
+    void EmitConstant(uint8 Target, double Value)
+    {
+        const int32 Index = Expression.Constants.AddUnique(Value);
+        Emit(EOpCode::LoadConstant, Target, 0, 0, Index);
+    }
+
+    /* Resolves dotted property path to offset from start of context and emits load of matching type */
+    void EmitPropertyLoad(uint8 Target, const FString& Path)
+    {
+        TArray<FString> Names;
+        Path.ParseIntoArray(Names, TEXT("."));
+
+        const UStruct* Struct = &ContextType;
+        const FProperty* Property = nullptr;
+        uint32 Offset = 0;
+
+        for (int32 NameIndex = 0; NameIndex < Names.Num(); ++NameIndex)
+        {
+            Property = Struct != nullptr ? Struct->FindPropertyByName(*Names[NameIndex]) : nullptr;
+            if (Property == nullptr)
+            {
+                SetError(FString::Printf(TEXT("Unknown property '%s'"), *Path));
+                return;
+            }
+
+            if (NameIndex == 0)
+            {
+                Expression.ReferencedProperties.AddUnique(Property->GetFName());
+            }
+
+            Offset += Property->GetOffset_ForInternal();
+
+            const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+            Struct = StructProperty != nullptr ? StructProperty->Struct : nullptr;
+        }
+
+        if (const FBoolProperty* BoolProperty = CastField<FBoolProperty>(Property))
+        {
+            // native bools have full mask, bitfields select their bit. Mask shares Operand with offset, so registers stay valid
+            const uint32 ByteOffset = Offset + BoolProperty->GetByteOffset();
+            if (ByteOffset > (MAX_uint32 >> 8))
+            {
+                SetError(FString::Printf(TEXT("Property '%s' is too far from start of context"), *Path));
+                return;
+            }
+
+            Emit(EOpCode::LoadBool, Target, 0, 0, (ByteOffset << 8) | BoolProperty->GetFieldMask());
+        }
+        else if (Property->IsA<FFloatProperty>())
+        {
+            Emit(EOpCode::LoadFloat, Target, 0, 0, Offset);
+        }
+        else if (Property->IsA<FDoubleProperty>())
+        {
+            Emit(EOpCode::LoadDouble, Target, 0, 0, Offset);
+        }
+        else if (Property->IsA<FIntProperty>())
+        {
+            Emit(EOpCode::LoadInt, Target, 0, 0, Offset);
+        }
+        else if (Property->IsA<FByteProperty>())
+        {
+            Emit(EOpCode::LoadByte, Target, 0, 0, Offset);
+        }
+        else
+        {
+            SetError(FString::Printf(TEXT("Property '%s' has unsupported type %s"), *Path, *Property->GetCPPType()));
+        }
+    }
+
+    int32 Emit(EOpCode OpCode, uint8 Target, uint8 A = 0, uint8 B = 0, uint32 Operand = 0)
+    {
+        // Evaluate reads A and B of every instruction
+        check(Target < FStateChartExpression::MaxRegisters && A < FStateChartExpression::MaxRegisters && B < FStateChartExpression::MaxRegisters);
+
+        return Expression.Instructions.Add({ OpCode, Target, A, B, Operand });
+    }
+
+    bool Match(const TCHAR* Token)
+    {
+        SkipWhitespace();
+
+        const int32 Length = FCString::Strlen(Token);
+        if (FCString::Strncmp(*Source + Position, Token, Length) != 0)
+        {
+            return false;
+        }
+
+        // don't confuse '<' with '<=' and '!' with '!='. Other tokens may be followed by '=' of the next one, like in '(Ammo)==3'
+        const bool bComparisonPrefix = Token[0] == TEXT('<') || Token[0] == TEXT('>') || Token[0] == TEXT('!');
+        if (Length == 1 && bComparisonPrefix && Position + 1 < Source.Len() && Source[Position + 1] == TEXT('='))
+        {
+            return false;
+        }
+
+        Position += Length;
+        return true;
+    }
+
+    void SkipWhitespace()
+    {
+        while (Position < Source.Len() && FChar::IsWhitespace(Source[Position]))
+        {
+            Position++;
+        }
+    }
+
+    void SetError(const FString& Message)
+    {
+        if (Error.IsEmpty())
+        {
+            Error = FString::Printf(TEXT("%s at position %d in '%s'"), *Message, Position, *Source);
+        }
+    }
+
+    FStateChartExpression& Expression;
+    const FString& Source;
+    const UStruct& ContextType;
+
+    int32 Position = 0;
+    FString Error;
+};
+
+bool FStateChartExpression::Compile(const FString& Source, const UStruct& InContextType, FString& OutError)
+{
+    Instructions.Reset();
+    Constants.Reset();
+    ReferencedProperties.Reset();
+    ContextType = &InContextType;
+
+    FStateChartExpressionCompiler Compiler(*this, Source, InContextType);
+    if (!Compiler.Compile(OutError))
+    {
+        Instructions.Reset();
+        Constants.Reset();
+        ReferencedProperties.Reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool FStateChartExpression::Evaluate(const void* ContextData) const
+{
+    checkSlow(IsCompiled());
+
+    const uint8* Data = static_cast<const uint8*>(ContextData);
+    double Registers[MaxRegisters] = {};
+
+    const int32 NumInstructions = Instructions.Num();
+    for (int32 Index = 0; Index < NumInstructions; ++Index)
+    {
+        const FInstruction& Instruction = Instructions[Index];
+        double& Target = Registers[Instruction.Target];
+        const double A = Registers[Instruction.A];
+        const double B = Registers[Instruction.B];
+
+        switch (Instruction.OpCode)
+        {
+        case EOpCode::LoadConstant: Target = Constants[Instruction.Operand]; break;
+        case EOpCode::LoadBool:     Target = (Data[Instruction.Operand >> 8] & (Instruction.Operand & 0xff)) != 0; break;
+        case EOpCode::LoadFloat:    Target = *reinterpret_cast<const float*>(Data + Instruction.Operand); break;
+        case EOpCode::LoadDouble:   Target = *reinterpret_cast<const double*>(Data + Instruction.Operand); break;
+        case EOpCode::LoadInt:      Target = *reinterpret_cast<const int32*>(Data + Instruction.Operand); break;
+        case EOpCode::LoadByte:     Target = Data[Instruction.Operand]; break;
+
+        case EOpCode::Add:          Target = A + B; break;
+        case EOpCode::Subtract:     Target = A - B; break;
+        case EOpCode::Multiply:     Target = A * B; break;
+        case EOpCode::Divide:       Target = A / B; break;
+        case EOpCode::Negate:       Target = -A; break;
+        case EOpCode::Not:          Target = A == 0; break;
+        case EOpCode::ToBool:       Target = A != 0; break;
+
+        case EOpCode::Less:         Target = A < B; break;
+        case EOpCode::LessEqual:    Target = A <= B; break;
+        case EOpCode::Greater:      Target = A > B; break;
+        case EOpCode::GreaterEqual: Target = A >= B; break;
+        case EOpCode::Equal:        Target = A == B; break;
+        case EOpCode::NotEqual:     Target = A != B; break;
+
+        case EOpCode::JumpIfFalse:  Index = A == 0 ? Instruction.Operand - 1 : Index; break;
+        case EOpCode::JumpIfTrue:   Index = A != 0 ? Instruction.Operand - 1 : Index; break;
+        }
+    }
+
+    return Registers[0] != 0;
+}
+
+}
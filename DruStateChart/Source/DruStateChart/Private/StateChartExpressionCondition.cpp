@@ -0,0 +1,66 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartExpressionCondition.h"
+#include "StateChartLog.h"
+
+void FStateChartExpressionCondition::Compile(const FStateChartCompileContext& Context)
+{
+    Program.Reset();
+
+    const UStruct* ContextType = ContextClass != nullptr ? static_cast<const UStruct*>(ContextClass.Get()) : Context.DatamodelType;
+    if (ContextType == nullptr)
+    {
+        UE_LOG(LogDruStateChart, Error, TEXT("Expression '%s' has neither ContextClass nor Datamodel to read"), *Expression);
+        return;
+    }
+
+    TSharedRef<DruStateChart_Impl::FStateChartExpression> NewProgram = MakeShared<DruStateChart_Impl::FStateChartExpression>();
+
+    FString Error;
+    if (!NewProgram->Compile(Expression, *ContextType, Error))
+    {
+        UE_LOG(LogDruStateChart, Error, TEXT("Failed to compile expression of %s: %s"), *ContextType->GetName(), *Error);
+        return;
+    }
+
+    Program = NewProgram;
+}
+
+bool FStateChartExpressionCondition::GetDependencies(TArray<FName>& OutDependencies) const
+{
+    if (ContextClass != nullptr)
+    {
+        // properties of context object change without notice
+        return false;
+    }
+
+    if (Program.IsValid())
+    {
+        OutDependencies.Append(Program->GetReferencedProperties());
+    }
+
+    return true;
+}
+
+bool FStateChartExpressionCondition::Evaluate(const FStateChartExecutionContext& Context, FConstStructView TransitionEvent) const
+{
+    if (!Program.IsValid())
+    {
+        return false;
+    }
+
+    if (ContextClass == nullptr)
+    {
+        // executor always owns Datamodel of its asset
+        return Context.Datamodel.GetScriptStruct() == Program->GetContextType() && Program->Evaluate(Context.Datamodel.GetMemory());
+    }
+
+    // offsets are only valid for ContextClass and its children
+    const UObject* ContextObject = Context.ContextObject;
+    if (ContextObject == nullptr || !ContextObject->IsA(ContextClass))
+    {
+        return false;
+    }
+
+    return Program->Evaluate(ContextObject);
+}
@@ -0,0 +1,263 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Impl/StateChartFlatExecutor.h"
+#include "StateChartAsset.h"
+#include "StateChartAction.h"
+#include "StateChartDatamodel.h"
+#include "StateChartEvent.h"
+#include "Impl/StateChartElements.h"
+#include "Algo/Transform.h"
+
+namespace DruStateChart_Impl
+{
+
+FStateChartFlatExecutor::FStateChartFlatExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject)
+    : Asset(&StateChartAsset)
+    , Context(*this, ContextObject)
+    , Nodes(&StateChartAsset.GetAssembledNodes())
+    , Table(StateChartAsset.GetFlatTable())
+    , Datamodel(StateChartAsset.GetDatamodel())
+{
+    check(Table != nullptr);
+
+    Context.Datamodel = Datamodel.GetMutableValue();
+    bRaiseDatamodelEvents = Nodes->EventTypeIndex.FindListIndex(FStateChartDatamodelChangedEvent::StaticStruct()) != INDEX_NONE;
+
+    EventQueue.SetPolicy(StateChartAsset.GetEventQueueCapacity(), StateChartAsset.GetEventQueueOverflow(), StateChartAsset.GetEventQueuePolicies());
+
+    RegistrySlot = FStateChartExecutorRegistry::Get().Add(*this, StateChartAsset);
+}
+
+FStateChartFlatExecutor::~FStateChartFlatExecutor()
+{
+    SetEventBus(nullptr);
+
+    // executors outliving the module have nothing to unregister from
+    if (FStateChartExecutorRegistry* Registry = FStateChartExecutorRegistry::TryGet())
+    {
+        Registry->Remove(RegistrySlot);
+    }
+}
+
+void FStateChartFlatExecutor::SetEventBus(TSharedPtr<FStateChartEventBus> InEventBus)
+{
+    auto ForEachEventType = [this](TFunctionRef<void(const UScriptStruct*)> Action)
+    {
+        for (const TPair<const UScriptStruct*, int32>& Pair : Nodes->EventTypeIndex.TypeToList)
+        {
+            if (Pair.Key != FStateChartTimeoutEvent::StaticStruct())
+            {
+                Action(Pair.Key);
+            }
+        }
+
+        if (Nodes->EventTypeIndex.AnyEventTransitions.Num() != 0)
+        {
+            Action(FStateChartAnyEvent::StaticStruct());
+        }
+    };
+
+    if (EventBus.IsValid())
+    {
+        ForEachEventType([this](const UScriptStruct* EventType) { EventBus->RemoveInterest(*this, EventType); });
+        EventBus->RemoveExecutor(*this);
+    }
+
+    EventBus = MoveTemp(InEventBus);
+
+    if (EventBus.IsValid())
+    {
+        EventBus->AddExecutor(*this);
+        ForEachEventType([this](const UScriptStruct* EventType) { EventBus->AddInterest(*this, EventType); });
+    }
+}
+
+void FStateChartFlatExecutor::Execute()
+{
+    TGuardValue<bool> Guard(bProcessingEvents, true);
+
+    CurrentConfiguration = INDEX_NONE;
+    ApplyEntry(Table->InitialEntry);
+
+    ProcessQueuedEvents();
+}
+
+void FStateChartFlatExecutor::Stop()
+{
+    checkf(!bProcessingEvents, TEXT("Executor of '%s' cannot be stopped by its own Actions"), *Asset->GetPathName());
+
+    if (CurrentConfiguration != INDEX_NONE)
+    {
+        // events raised by exit actions are queued and discarded below
+        TGuardValue<bool> Guard(bProcessingEvents, true);
+        const FSimpleDelegate Done;
+
+        // configuration states are sorted by index, so children come after their parents and exit first when it is walked backwards
+        const TArrayView<const FIndex> States = Table->GetConfigurationStates(CurrentConfiguration);
+        for (int32 Index = States.Num() - 1; Index >= 0; --Index)
+        {
+            if (auto* Definition = Nodes->StateNodes[States[Index]].GetDefinition<UBaseStateWithActionsDefinition>())
+            {
+                for (FInstancedStruct& ActionStruct : Definition->ExitActions)
+                {
+                    if (auto* Action = ActionStruct.GetMutablePtr<FStateChartAction>())
+                    {
+                        Action->ExecuteAsync(Context, Done);
+                    }
+                }
+            }
+        }
+    }
+
+    CurrentConfiguration = INDEX_NONE;
+    EventQueue.Reset();
+}
+
+void FStateChartFlatExecutor::Reset(TObjectPtr<UObject> ContextObject)
+{
+    Stop();
+
+    Context.ContextObject = ContextObject;
+    Datamodel.CopyMatchingValuesByID(Asset->GetDatamodel());
+
+    EventQueue.ResetStats();
+    Significance = EStateChartSignificance::High;
+}
+
+FStateChartExecutorStats FStateChartFlatExecutor::GetStats() const
+{
+    FStateChartExecutorStats Result;
+    Result.MaxExternalQueueDepth = EventQueue.GetMaxNum();
+    Result.NumDroppedEvents = EventQueue.GetNumDropped();
+    Result.NumCoalescedEvents = EventQueue.GetNumCoalesced();
+    return Result;
+}
+
+FStateChartFlatExecutor::FHandlerCreated& FStateChartFlatExecutor::OnStateHandlerCreated()
+{
+    if (!StateHandlerCreatedDelegate.IsValid())
+    {
+        StateHandlerCreatedDelegate = MakeUnique<FHandlerCreated>();
+    }
+
+    return *StateHandlerCreatedDelegate;
+}
+
+TArray<TObjectPtr<UBaseStateDefinition>> FStateChartFlatExecutor::GetActiveStates() const
+{
+    TArray<TObjectPtr<UBaseStateDefinition>> Result;
+
+    if (CurrentConfiguration != INDEX_NONE)
+    {
+        Algo::Transform(Table->GetConfigurationStates(CurrentConfiguration), Result, [this](FIndex Index) { return Nodes->StateNodes[Index].Definition; });
+    }
+
+    return Result;
+}
+
+void FStateChartFlatExecutor::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    // asset is reported by registry
+    Collector.AddReferencedObject(Context.ContextObject);
+    Datamodel.AddStructReferencedObjects(Collector);
+    EventQueue.AddStructReferencedObjects(Collector);
+}
+
+void FStateChartFlatExecutor::NotifyDatamodelChanged(FName VariableName)
+{
+    if (bRaiseDatamodelEvents)
+    {
+        ExecuteEventImpl(FConstStructView::Make(FStateChartDatamodelChangedEvent(VariableName)));
+    }
+}
+
+void FStateChartFlatExecutor::ExecuteEventImpl(FConstStructView Event)
+{
+    if (bProcessingEvents || bDeferEvents)
+    {
+        // event sent from action or deferred until Pump, we'll process it later
+        EventQueue.Enqueue(Event);
+
+        if (!bProcessingEvents && EventQueue.IsCritical(Event.GetScriptStruct()))
+        {
+            // cannot wait for scheduler. events queued before it are processed too, so order is kept
+            Pump(MAX_int32);
+        }
+
+        return;
+    }
+
+    if (CurrentConfiguration == INDEX_NONE)
+    {
+        // not started yet
+        return;
+    }
+
+    TGuardValue<bool> Guard(bProcessingEvents, true);
+
+    if (EventQueue.Num() != 0)
+    {
+        // events left by previous Pump go first
+        EventQueue.Enqueue(Event);
+    }
+    else if (const FStateChartFlatTable::FEntry* Entry = Table->FindEntry(CurrentConfiguration, Event.GetScriptStruct()))
+    {
+        ApplyEntry(*Entry);
+    }
+
+    ProcessQueuedEvents();
+}
+
+int32 FStateChartFlatExecutor::Pump(int32 MaxMacrosteps, double MaxSeconds)
+{
+    if (bProcessingEvents || CurrentConfiguration == INDEX_NONE)
+    {
+        // called from action or not started yet
+        return 0;
+    }
+
+    TGuardValue<bool> Guard(bProcessingEvents, true);
+
+    return ProcessQueuedEvents(MaxMacrosteps, MaxSeconds > 0.0 ? FPlatformTime::Seconds() + MaxSeconds : 0.0);
+}
+
+int32 FStateChartFlatExecutor::ProcessQueuedEvents(int32 MaxEvents, double Deadline)
+{
+    int32 NumProcessed = 0;
+
+    // tag events are sent as FStateChartGenericEvent, so queue holds struct events only
+    FGameplayTag EventTag;
+    FInstancedStruct Event;
+
+    // actions never complete asynchronously, so each event is a complete macrostep
+    while (!EventQueue.IsEmpty() && NumProcessed < MaxEvents && (Deadline == 0.0 || FPlatformTime::Seconds() < Deadline))
+    {
+        EventQueue.Dequeue(EventTag, Event);
+        NumProcessed += 1;
+
+        if (const FStateChartFlatTable::FEntry* Entry = Table->FindEntry(CurrentConfiguration, Event.GetScriptStruct()))
+        {
+            ApplyEntry(*Entry);
+        }
+    }
+
+    return NumProcessed;
+}
+
+void FStateChartFlatExecutor::ApplyEntry(const FStateChartFlatTable::FEntry& Entry)
+{
+    // completion is not tracked, all actions are expected to be synchronous
+    const FSimpleDelegate Done;
+
+    for (int32 ActionIndex = Entry.ActionIndex; ActionIndex < Entry.ActionIndex + Entry.NumActions; ++ActionIndex)
+    {
+        if (auto* Action = Table->Actions[ActionIndex]->GetMutablePtr<FStateChartAction>())
+        {
+            Action->ExecuteAsync(Context, Done);
+        }
+    }
+
+    CurrentConfiguration = Entry.NextConfiguration;
+}
+
+}
@@ -0,0 +1,221 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Impl/StateChartFlatTable.h"
+#include "Impl/StateChartElements.h"
+#include "Impl/StateChartSolver.h"
+#include "StateChartAsset.h"
+#include "StateChartEvent.h"
+
+namespace DruStateChart_Impl
+{
+
+bool FStateChartFlatTable::Compile(UStateChartAsset& Asset, int32 MaxConfigurations)
+{
+    // eligible StateCharts use no other features
+    using FSolver = TStateChartSolver<EStateChartFeatures::Parallel>;
+
+    Reset();
+
+    const FStateChartNodes& Nodes = Asset.GetAssembledNodes();
+    if (!IsEligible(Nodes))
+    {
+        return false;
+    }
+
+    // every referenced event type has its own candidate list in EventTypeIndex and gets its own column. Last column is for events matching only AnyEvent transitions
+    ColumnEventTypes.SetNumZeroed(Nodes.EventTypeIndex.CandidateLists.Num() + 1);
+    for (const auto& Pair : Nodes.EventTypeIndex.TypeToList)
+    {
+        EventToColumn.Emplace(Pair.Key, Pair.Value);
+        ColumnEventTypes[Pair.Value] = Pair.Key;
+    }
+    ColumnEventTypes.Last() = FStateChartAnyEvent::StaticStruct();
+
+    const int32 NumEvents = ColumnEventTypes.Num();
+
+    // solver is shared with default executor, so both produce identical results
+    TArray<FIndex> ActiveStates;
+
+    TMultiMap<uint32, int32> HashToConfiguration;
+    ConfigurationOffsets.Add(0);
+
+    auto FindOrAddConfiguration = [&](TArray<FIndex>& States)
+    {
+        States.Sort();
+        const uint32 Hash = FCrc::MemCrc32(States.GetData(), States.Num() * States.GetTypeSize());
+
+        for (auto It = HashToConfiguration.CreateConstKeyIterator(Hash); It; ++It)
+        {
+            TArrayView<const FIndex> Existing = GetConfigurationStates(It.Value());
+            if (Existing.Num() == States.Num() && FMemory::Memcmp(Existing.GetData(), States.GetData(), States.Num() * States.GetTypeSize()) == 0)
+            {
+                return It.Value();
+            }
+        }
+
+        const int32 NewConfiguration = NumConfigurations();
+        ConfigurationStates.Append(States);
+        ConfigurationOffsets.Add(ConfigurationStates.Num());
+        HashToConfiguration.Add(Hash, NewConfiguration);
+
+        return NewConfiguration;
+    };
+
+    auto AppendActions = [&](TArray<FInstancedStruct>& ActionList)
+    {
+        for (FInstancedStruct& Action : ActionList)
+        {
+            Actions.Add(&Action);
+        }
+    };
+
+    // replicates StartNewPlan and Enter/Exit steps of default executor, but records actions instead of running them
+    auto Simulate = [&](const FTransitionIndexArray& Transitions, FEntry& OutEntry)
+    {
+        const FSolver Solver(Nodes, ActiveStates);
+
+        FStateIndexArray StatesToExit;
+        Solver.CollectStatesToExit(Transitions, StatesToExit);
+        StatesToExit.Sort([](auto A, auto B) { return B < A; });
+
+        FStateIndexArray StatesToEnter;
+        FStateIndexArray StatesForDefaultEntry;
+        Solver.CollectStatesToEnter(Transitions, StatesToEnter, StatesForDefaultEntry);
+        StatesToEnter.Sort();
+
+        OutEntry.ActionIndex = Actions.Num();
+
+        for (FIndex StateIndex : StatesToExit)
+        {
+            AppendActions(Nodes.StateNodes[StateIndex].GetDefinition<UBaseStateWithActionsDefinition>()->ExitActions);
+        }
+
+        for (FIndex TransitionIndex : Transitions)
+        {
+            AppendActions(Nodes.TransitionNodes[TransitionIndex].Definition->Actions);
+        }
+
+        for (FIndex StateIndex : StatesToEnter)
+        {
+            const FStateNode& StateNode = Nodes.StateNodes[StateIndex];
+            AppendActions(StateNode.GetDefinition<UBaseStateWithActionsDefinition>()->EnterActions);
+
+            if (StatesForDefaultEntry.Contains(StateIndex))
+            {
+                AppendActions(Nodes.TransitionNodes[StateNode.InitialTransitionIndex].Definition->Actions);
+            }
+        }
+
+        OutEntry.NumActions = Actions.Num() - OutEntry.ActionIndex;
+
+        TArray<FIndex> NextStates = ActiveStates;
+        for (FIndex StateIndex : StatesToExit)
+        {
+            NextStates.Remove(StateIndex);
+        }
+
+        for (FIndex StateIndex : StatesToEnter)
+        {
+            NextStates.AddUnique(StateIndex);
+        }
+
+        OutEntry.NextConfiguration = FindOrAddConfiguration(NextStates);
+    };
+
+    // initial configuration
+    Simulate({ { Nodes.StateNodes[0].InitialTransitionIndex } }, InitialEntry);
+    InitialConfiguration = InitialEntry.NextConfiguration;
+
+    // enumerate reachable configurations. newly found ones are appended, so this loop visits all of them
+    for (int32 Configuration = 0; Configuration < NumConfigurations(); ++Configuration)
+    {
+        if (NumConfigurations() > MaxConfigurations)
+        {
+            Reset();
+            return false;
+        }
+
+        Entries.AddDefaulted(NumEvents);
+
+        for (int32 Column = 0; Column < NumEvents; ++Column)
+        {
+            TArrayView<const FIndex> ConfigurationStatesView = GetConfigurationStates(Configuration);
+            ActiveStates.Reset();
+            ActiveStates.Append(ConfigurationStatesView.GetData(), ConfigurationStatesView.Num());
+
+            // same candidates as CollectTransitions of default executor. Eligible StateCharts have no Conditions, so first candidate of each state is taken
+            TArrayView<const FIndex> Candidates = ColumnEventTypes[Column] == FStateChartGenericEvent::StaticStruct()
+                ? Nodes.TagIndex.FindCandidates(FGameplayTag())
+                : Nodes.EventTypeIndex.FindCandidates(ColumnEventTypes[Column]);
+
+            FTransitionIndexArray Transitions = FSolver(Nodes, ActiveStates).CollectActiveTransitions([&](const FStateNode& Node)
+            {
+                return FindStateCandidate(Nodes, Candidates, Node, [](const FTransitionNode&) { return true; });
+            });
+            if (Transitions.Num() != 0)
+            {
+                FEntry Entry;
+                Simulate(Transitions, Entry);
+
+                // Entries may be reallocated by Simulate, don't hold reference
+                Entries[Configuration * NumEvents + Column] = Entry;
+            }
+        }
+    }
+
+    return true;
+}
+
+void FStateChartFlatTable::Reset()
+{
+    InitialConfiguration = INDEX_NONE;
+    InitialEntry = FEntry();
+
+    ConfigurationStates.Reset();
+    ConfigurationOffsets.Reset();
+    EventToColumn.Reset();
+    ColumnEventTypes.Reset();
+    Entries.Reset();
+    Actions.Reset();
+}
+
+const FStateChartFlatTable::FEntry* FStateChartFlatTable::FindEntry(int32 Configuration, const UScriptStruct* EventType) const
+{
+    int32 Column = ColumnEventTypes.Num() - 1;
+
+    // only referenced types are in the map. closest referenced parent has the same transitions
+    for (const UStruct* Type = EventType; Type != nullptr; Type = Type->GetSuperStruct())
+    {
+        if (const int32* TypeColumn = EventToColumn.Find(static_cast<const UScriptStruct*>(Type)))
+        {
+            Column = *TypeColumn;
+            break;
+        }
+    }
+
+    const FEntry& Entry = Entries[Configuration * ColumnEventTypes.Num() + Column];
+    return Entry.NextConfiguration != INDEX_NONE ? &Entry : nullptr;
+}
+
+TArrayView<const FIndex> FStateChartFlatTable::GetConfigurationStates(int32 Configuration) const
+{
+    const int32 Offset = ConfigurationOffsets[Configuration];
+    return TArrayView<const FIndex>(ConfigurationStates.GetData() + Offset, ConfigurationOffsets[Configuration + 1] - Offset);
+}
+
+bool FStateChartFlatTable::IsEligible(const FStateChartNodes& Nodes)
+{
+    if (Nodes.StateNodes.Num() == 0 || Nodes.StateNodes[0].InitialTransitionIndex.IsNone())
+    {
+        return false;
+    }
+
+    // recorded actions are executed back to back, so none of them may complete asynchronously
+    constexpr EStateChartFeatures UnsupportedFeatures = EStateChartFeatures::History | EStateChartFeatures::Handlers | EStateChartFeatures::AsyncActions | EStateChartFeatures::Conditions;
+
+    // table columns are event types, tags would need columns of their own. Eventless and timed transitions are not folded into rows
+    return !EnumHasAnyFlags(Nodes.Features, UnsupportedFeatures) && !Nodes.TagIndex.HasTaggedTransitions()
+        && Nodes.EventTypeIndex.EventlessTransitions.Num() == 0 && Nodes.EventTypeIndex.TimedTransitions.Num() == 0;
+}
+
+}
@@ -0,0 +1,184 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartMessenger.h"
+#include "Interfaces/IStateChartExecutor.h"
+
+FStateChartExecutorHandle FStateChartMessenger::Register(IStateChartExecutor& Executor)
+{
+    const int32 Index = FreeMailboxes.Num() != 0 ? FreeMailboxes.Pop() : Mailboxes.AddDefaulted();
+
+    FMailbox& Mailbox = Mailboxes[Index];
+    Mailbox.Executor = Executor.AsShared();
+    Mailbox.bRegistered = true;
+
+    FStateChartExecutorHandle Handle;
+    Handle.Index = Index;
+    Handle.Serial = Mailbox.Serial;
+
+    return Handle;
+}
+
+void FStateChartMessenger::Unregister(const FStateChartExecutorHandle& Handle)
+{
+    if (FMailbox* Mailbox = FindMailbox(Handle))
+    {
+        Stats.NumDropped += Mailbox->Messages.Num();
+        NumPendingMessages -= Mailbox->Messages.Num();
+
+        // mailbox stays in PendingMailboxes if it is there. Flush skips it while it is empty
+        Mailbox->Executor.Reset();
+        Mailbox->Messages.Reset();
+        Mailbox->bRegistered = false;
+        Mailbox->Serial++;
+
+        FreeMailboxes.Add(Handle.Index);
+    }
+}
+
+TSharedPtr<IStateChartExecutor> FStateChartMessenger::Resolve(const FStateChartExecutorHandle& Handle) const
+{
+    const FMailbox* Mailbox = FindMailbox(Handle);
+    return Mailbox != nullptr ? Mailbox->Executor.Pin() : nullptr;
+}
+
+bool FStateChartMessenger::Send(const FStateChartExecutorHandle& Target, FConstStructView Event)
+{
+    FMessage* Message = AddMessage(Target);
+    if (Message != nullptr)
+    {
+        Message->Event = FInstancedStruct(Event);
+    }
+
+    return Message != nullptr;
+}
+
+bool FStateChartMessenger::SendTag(const FStateChartExecutorHandle& Target, const FGameplayTag& EventTag)
+{
+    check(EventTag.IsValid());
+
+    FMessage* Message = AddMessage(Target);
+    if (Message != nullptr)
+    {
+        Message->EventTag = EventTag;
+    }
+
+    return Message != nullptr;
+}
+
+int32 FStateChartMessenger::Flush()
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    // messages sent during delivery go to fresh PendingMailboxes and wait for next Flush
+    Swap(PendingMailboxes, FlushingMailboxes);
+    PendingMailboxes.Reset();
+
+    int32 NumDelivered = 0;
+
+    for (int32 MailboxIndex : FlushingMailboxes)
+    {
+        // Mailboxes may grow during delivery, so mailbox is not referenced across it
+        TSharedPtr<IStateChartExecutor> Executor;
+        {
+            FMailbox& Mailbox = Mailboxes[MailboxIndex];
+            Mailbox.bPending = false;
+
+            Executor = Mailbox.Executor.Pin();
+            Swap(Mailbox.Messages, DeliveringMessages);
+        }
+
+        NumPendingMessages -= DeliveringMessages.Num();
+
+        if (!Executor.IsValid())
+        {
+            Stats.NumDropped += DeliveringMessages.Num();
+            DeliveringMessages.Reset();
+            continue;
+        }
+
+        for (const FMessage& Message : DeliveringMessages)
+        {
+            const double Latency = FPlatformTime::Seconds() - Message.SendTime;
+            Stats.TotalLatencySeconds += Latency;
+            Stats.MaxLatencySeconds = FMath::Max(Stats.MaxLatencySeconds, Latency);
+
+            if (Message.EventTag.IsValid())
+            {
+                Executor->ExecuteTagEvent(Message.EventTag);
+            }
+            else
+            {
+                Executor->ExecuteEvent(Message.Event);
+            }
+        }
+
+        NumDelivered += DeliveringMessages.Num();
+        DeliveringMessages.Reset();
+    }
+
+    FlushingMailboxes.Reset();
+
+    Stats.NumDelivered += NumDelivered;
+    Stats.NumFlushes += 1;
+    Stats.LastFlushMessages = NumDelivered;
+    Stats.LastFlushSeconds = FPlatformTime::Seconds() - StartTime;
+
+    return NumDelivered;
+}
+
+void FStateChartMessenger::AddStructReferencedObjects(FReferenceCollector& Collector)
+{
+    auto AddMessages = [&Collector](TArray<FMessage>& Messages)
+    {
+        for (FMessage& Message : Messages)
+        {
+            Message.Event.AddStructReferencedObjects(Collector);
+        }
+    };
+
+    for (FMailbox& Mailbox : Mailboxes)
+    {
+        AddMessages(Mailbox.Messages);
+    }
+
+    AddMessages(DeliveringMessages);
+}
+
+FStateChartMessenger::FMailbox* FStateChartMessenger::FindMailbox(const FStateChartExecutorHandle& Handle)
+{
+    return const_cast<FMailbox*>(static_cast<const FStateChartMessenger*>(this)->FindMailbox(Handle));
+}
+
+const FStateChartMessenger::FMailbox* FStateChartMessenger::FindMailbox(const FStateChartExecutorHandle& Handle) const
+{
+    if (!Mailboxes.IsValidIndex(Handle.Index))
+    {
+        return nullptr;
+    }
+
+    const FMailbox& Mailbox = Mailboxes[Handle.Index];
+    return Mailbox.bRegistered && Mailbox.Serial == Handle.Serial ? &Mailbox : nullptr;
+}
+
+FStateChartMessenger::FMessage* FStateChartMessenger::AddMessage(const FStateChartExecutorHandle& Target)
+{
+    FMailbox* Mailbox = FindMailbox(Target);
+    if (Mailbox == nullptr || !Mailbox->Executor.IsValid())
+    {
+        return nullptr;
+    }
+
+    if (!Mailbox->bPending)
+    {
+        Mailbox->bPending = true;
+        PendingMailboxes.Add(Target.Index);
+    }
+
+    FMessage& Message = Mailbox->Messages.AddDefaulted_GetRef();
+    Message.SendTime = FPlatformTime::Seconds();
+
+    NumPendingMessages += 1;
+    Stats.NumSent += 1;
+
+    return &Message;
+}
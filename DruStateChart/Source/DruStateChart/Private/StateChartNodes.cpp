@@ -2,12 +2,107 @@
 
 #include "Impl/StateChartNodes.h"
 #include "Impl/StateChartElements.h"
+#include "StateChartAction.h"
+#include "StateChartCondition.h"
+#include "StateChartEvent.h"
+#include "StateChartLog.h"
+#include "Algo/AnyOf.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
 
 namespace DruStateChart_Impl
 {
 
 const FIndex FIndex::None = 0xffff;
 
+TArrayView<const FIndex> FStateChartTagIndex::FindCandidates(const FGameplayTag& Tag) const
+{
+    if (const TArray<FIndex>* Candidates = ExactTagTransitions.Find(Tag))
+    {
+        return *Candidates;
+    }
+
+    // closest referenced parent tag has all transitions that match its descendants
+    for (FGameplayTag ParentTag = Tag.RequestDirectParent(); ParentTag.IsValid(); ParentTag = ParentTag.RequestDirectParent())
+    {
+        if (const TArray<FIndex>* Candidates = DescendantTagTransitions.Find(ParentTag))
+        {
+            return *Candidates;
+        }
+    }
+
+    return UntaggedTransitions;
+}
+
+void FStateChartTagIndex::Reset()
+{
+    ExactTagTransitions.Reset();
+    DescendantTagTransitions.Reset();
+    UntaggedTransitions.Reset();
+}
+
+TArrayView<const FIndex> FStateChartEventTypeIndex::FindCandidates(const UScriptStruct* EventType) const
+{
+    const int32 ListIndex = FindListIndex(EventType);
+    return ListIndex != INDEX_NONE ? TArrayView<const FIndex>(CandidateLists[ListIndex]) : TArrayView<const FIndex>(AnyEventTransitions);
+}
+
+int32 FStateChartEventTypeIndex::FindListIndex(const UScriptStruct* EventType) const
+{
+    // only referenced types are in the map. closest referenced parent has all transitions of derived type
+    for (const UStruct* Type = EventType; Type != nullptr; Type = Type->GetSuperStruct())
+    {
+        if (const int32* ListIndex = TypeToList.Find(static_cast<const UScriptStruct*>(Type)))
+        {
+            return *ListIndex;
+        }
+    }
+
+    return INDEX_NONE;
+}
+
+void FStateChartEventTypeIndex::Reset()
+{
+    TypeToList.Reset();
+    CandidateLists.Reset();
+    AnyEventTransitions.Reset();
+    EventlessTransitions.Reset();
+    TimedTransitions.Reset();
+}
+
+void FStateChartDependencyIndex::Reset()
+{
+    DependentTransitions.Reset();
+    PollingTransitions.Reset();
+}
+
+void FStateChartGuardTable::Reset()
+{
+    NumGuards = 0;
+    TransitionOffsets.Reset();
+    GuardIDs.Reset();
+}
+
+void FStateChartHandlerTable::Reset()
+{
+    NumHandlers = 0;
+    StateOffsets.Reset();
+}
+
+const FStateChartHistoryTable::FSlot* FStateChartHistoryTable::FindSlot(FIndex StateIndex) const
+{
+    const int32 SlotIndex = Algo::BinarySearchBy(Slots, StateIndex, &FSlot::StateIndex);
+    return SlotIndex != INDEX_NONE ? &Slots[SlotIndex] : nullptr;
+}
+
+void FStateChartHistoryTable::Reset()
+{
+    Slots.Reset();
+    Masks.Reset();
+    MaskWords.Reset();
+    NumStorageWords = 0;
+}
+
 void FStateChartNodes::CreateNodes(const TArray<TObjectPtr<UBaseStateDefinition>>& States, const TArray<TObjectPtr<UTransitionDefinition>>& Transitions)
 {
     StateNodes.Empty(States.Num());
@@ -17,58 +112,162 @@ void FStateChartNodes::CreateNodes(const TArray<TObjectPtr<UBaseStateDefinition>
     StateIDToDefinition.Empty(States.Num());
 
     CreateStateNodes(States);
-    SortStateNodes();
-    UpdateHierarchyReferences();
     MarkAtomicStates();
 
     CreateTransitionNodes(Transitions);
-    SortTransitionNodes();
     UpdateTransitions();
+
+    UpdateFeatures();
+    BuildTagIndex();
+    BuildEventTypeIndex();
+    BuildDependencyIndex();
+    BuildGuardTable();
+    BuildHandlerTable();
+    BuildHistoryTable();
 }
 
 void FStateChartNodes::CreateStateNodes(const TArray<TObjectPtr<UBaseStateDefinition>>& States)
 {
-    // create nodes and add them to array
-    for (int32 StateIndex = 0; StateIndex < States.Num(); ++StateIndex)
+    const int32 NumStates = States.Num();
+
+    if (NumStates >= 0xffff)
+    {
+        UE_LOG(LogDruStateChart, Error, TEXT("StateChart has %d states, but at most %d are supported"), NumStates, 0xffff - 1);
+        return;
+    }
+
+    // map IDs to positions inside input array
+    TMap<FGuid, int32> IDToStateIndex;
+    IDToStateIndex.Reserve(NumStates);
+
+    for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
     {
-        auto State = States[StateIndex];
+        UBaseStateDefinition* State = States[StateIndex];
 
-        int32 NewNodeIdx = StateNodes.Emplace(GetStateType(State), State);
+        if (IDToStateIndex.Contains(State->ID))
+        {
+            UE_LOG(LogDruStateChart, Error, TEXT("State '%s' has duplicate ID %s and will be ignored"), *State->FriendlyName, *State->ID.ToString());
+            continue;
+        }
 
+        IDToStateIndex.Emplace(State->ID, StateIndex);
         StateIDToDefinition.Emplace(State->ID, State);
     }
-}
 
-void FStateChartNodes::SortStateNodes()
-{
-    // sort nodes by hierarchy and sort order
-    StateNodes.Sort([&](const FStateNode& A, const FStateNode& B)
-    {
-        return CompareStates(A.Definition, B.Definition);
-    });
-}
+    // validate parent references and count children of every state
+    TArray<int32> ParentStateIndexes;
+    ParentStateIndexes.Init(INDEX_NONE, NumStates);
 
-void FStateChartNodes::UpdateHierarchyReferences()
-{
-    // update parent/child references and child count
-    for (int32 StateIndex = 0; StateIndex < StateNodes.Num(); ++StateIndex)
+    TArray<int32> ChildOffsets;
+    ChildOffsets.Init(0, NumStates + 1);
+
+    int32 RootStateIndex = INDEX_NONE;
+    int32 NumLinkedStates = 0;
+
+    for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
     {
-        auto& Node = StateNodes[StateIndex];
-        StateIDToNodeIndex.Emplace(Node.Definition->ID, FIndex(StateIndex));
+        UBaseStateDefinition* State = States[StateIndex];
 
-        FIndex ParentIndex = StateIDToNodeIndex.FindRef(Node.Definition->ParentID);
-        if (!ParentIndex.IsNone())
+        if (IDToStateIndex[State->ID] != StateIndex)
         {
-            Node.ParentIndex = ParentIndex;
+            // duplicate, already reported
+            continue;
+        }
 
-            auto& ParentNode = StateNodes[ParentIndex];
-            if (ParentNode.ChildIndex == FIndex(0))
+        if (!State->ParentID.IsValid())
+        {
+            if (RootStateIndex == INDEX_NONE)
+            {
+                RootStateIndex = StateIndex;
+                NumLinkedStates++;
+            }
+            else
             {
-                ParentNode.ChildIndex = StateIndex;
+                UE_LOG(LogDruStateChart, Error, TEXT("State '%s' has no parent, but root state '%s' already exists. It will be ignored"), *State->FriendlyName, *States[RootStateIndex]->FriendlyName);
             }
-            ParentNode.NumChildren++;
+
+            continue;
+        }
+
+        const int32* ParentStateIndex = IDToStateIndex.Find(State->ParentID);
+        if (ParentStateIndex == nullptr)
+        {
+            UE_LOG(LogDruStateChart, Error, TEXT("State '%s' references unknown parent %s and will be ignored"), *State->FriendlyName, *State->ParentID.ToString());
+            continue;
+        }
+
+        ParentStateIndexes[StateIndex] = *ParentStateIndex;
+        ChildOffsets[*ParentStateIndex + 1]++;
+        NumLinkedStates++;
+    }
+
+    if (RootStateIndex == INDEX_NONE)
+    {
+        UE_CLOG(NumStates > 0, LogDruStateChart, Error, TEXT("StateChart does not have root state"));
+        return;
+    }
+
+    // build children lists. they keep input order, so sorting below is deterministic
+    for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+    {
+        ChildOffsets[StateIndex + 1] += ChildOffsets[StateIndex];
+    }
+
+    TArray<int32> Children;
+    Children.SetNumUninitialized(ChildOffsets[NumStates]);
+
+    TArray<int32> InsertPositions = ChildOffsets;
+    for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+    {
+        if (ParentStateIndexes[StateIndex] != INDEX_NONE)
+        {
+            Children[InsertPositions[ParentStateIndexes[StateIndex]]++] = StateIndex;
+        }
+    }
+
+    // emit nodes level by level starting from root. StateNodes array itself acts as a queue here
+    TArray<int32> NodeToStateIndex;
+    NodeToStateIndex.Reserve(NumLinkedStates);
+
+    auto EmitNode = [&](int32 StateIndex, FIndex ParentIndex)
+    {
+        UBaseStateDefinition* State = States[StateIndex];
+
+        const int32 NodeIndex = StateNodes.Emplace(GetStateType(State), State);
+        StateNodes[NodeIndex].ParentIndex = ParentIndex;
+
+        StateIDToNodeIndex.Emplace(State->ID, FIndex(NodeIndex));
+        NodeToStateIndex.Add(StateIndex);
+    };
+
+    EmitNode(RootStateIndex, FIndex::None);
+
+    for (int32 NodeIndex = 0; NodeIndex < StateNodes.Num(); ++NodeIndex)
+    {
+        const int32 StateIndex = NodeToStateIndex[NodeIndex];
+        TArrayView<int32> StateChildren(Children.GetData() + ChildOffsets[StateIndex], ChildOffsets[StateIndex + 1] - ChildOffsets[StateIndex]);
+
+        if (StateChildren.Num() == 0)
+        {
+            continue;
+        }
+
+        Algo::StableSort(StateChildren, [&](int32 A, int32 B)
+        {
+            return CompareSiblingStates(*States[A], *States[B]);
+        });
+
+        StateNodes[NodeIndex].ChildIndex = StateNodes.Num();
+        StateNodes[NodeIndex].NumChildren = static_cast<uint16>(StateChildren.Num());
+
+        for (int32 ChildStateIndex : StateChildren)
+        {
+            EmitNode(ChildStateIndex, NodeIndex);
         }
     }
+
+    // states that form a cycle are never reached from root
+    UE_CLOG(StateNodes.Num() != NumLinkedStates, LogDruStateChart, Error, TEXT("%d states have cyclic parent references and will be ignored"), NumLinkedStates - StateNodes.Num());
 }
 
 void FStateChartNodes::MarkAtomicStates()
@@ -86,47 +285,66 @@ void FStateChartNodes::MarkAtomicStates()
 
 void FStateChartNodes::CreateTransitionNodes(const TArray<TObjectPtr<UTransitionDefinition>>& Transitions)
 {
-    TransitionNodes.Empty(Transitions.Num());
+    const int32 NumStates = StateNodes.Num();
+
+    // resolve source states and count transitions of every state
+    TArray<FIndex> SourceIndexes;
+    SourceIndexes.SetNum(Transitions.Num());
+
+    TArray<int32> TransitionOffsets;
+    TransitionOffsets.Init(0, NumStates + 1);
 
     for (int32 TransitionIndex = 0; TransitionIndex < Transitions.Num(); ++TransitionIndex)
     {
         auto Transition = Transitions[TransitionIndex];
 
         FIndex SourceStateIdx = StateIDToNodeIndex.FindRef(Transition->SourceState);
+        SourceIndexes[TransitionIndex] = SourceStateIdx;
 
-        if (ensure(!SourceStateIdx.IsNone()))
+        if (SourceStateIdx.IsNone())
         {
-            TransitionNodes.Emplace(SourceStateIdx, Transition->EventID, Transition);
+            UE_LOG(LogDruStateChart, Error, TEXT("Transition '%s' references unknown source state %s and will be ignored"), *Transition->GetName(), *Transition->SourceState.ToString());
+            continue;
         }
+
+        TransitionOffsets[SourceStateIdx + 1]++;
     }
-}
 
-void FStateChartNodes::SortTransitionNodes()
-{
-    // sort transitions by their source index and sort order
-    TransitionNodes.Sort([](const FTransitionNode& A, const FTransitionNode& B)
+    // bucket transitions by source state, keeping input order inside each bucket
+    for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+    {
+        TransitionOffsets[StateIndex + 1] += TransitionOffsets[StateIndex];
+    }
+
+    TArray<int32> SortedTransitions;
+    SortedTransitions.SetNumUninitialized(TransitionOffsets[NumStates]);
+
+    TArray<int32> InsertPositions = TransitionOffsets;
+    for (int32 TransitionIndex = 0; TransitionIndex < Transitions.Num(); ++TransitionIndex)
     {
-        if (A.SourceNodeIndex < B.SourceNodeIndex)
+        if (!SourceIndexes[TransitionIndex].IsNone())
         {
-            return true;
+            SortedTransitions[InsertPositions[SourceIndexes[TransitionIndex]]++] = TransitionIndex;
         }
+    }
+
+    // sort each bucket by sort order and emit nodes
+    TransitionNodes.Reserve(SortedTransitions.Num());
+
+    for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+    {
+        TArrayView<int32> StateTransitions(SortedTransitions.GetData() + TransitionOffsets[StateIndex], TransitionOffsets[StateIndex + 1] - TransitionOffsets[StateIndex]);
 
-        if (A.SourceNodeIndex == B.SourceNodeIndex)
+        Algo::StableSort(StateTransitions, [&](int32 A, int32 B)
         {
-            if (!A.Definition->bInitial && B.Definition->bInitial)
-            {
-                // initial transition goes last
-                return true;
-            }
-            
-            if (A.Definition->bInitial == B.Definition->bInitial)
-            {
-                return A.Definition->SortOrder < B.Definition->SortOrder;
-            }
-        }
+            return CompareSiblingTransitions(*Transitions[A], *Transitions[B]);
+        });
 
-        return false;
-    });
+        for (int32 TransitionIndex : StateTransitions)
+        {
+            TransitionNodes.Emplace(FIndex(StateIndex), FIndex(TransitionIndex), Transitions[TransitionIndex]->GetTriggerEventType(), Transitions[TransitionIndex]);
+        }
+    }
 }
 
 void FStateChartNodes::UpdateTransitions()
@@ -154,50 +372,829 @@ void FStateChartNodes::UpdateTransitions()
     }
 }
 
-EStateType FStateChartNodes::GetStateType(TObjectPtr<UBaseStateDefinition> Definition) const
+bool FStateChartNodes::InsertTransition(UTransitionDefinition& Transition)
 {
-    static TMap<UClass*, EStateType, TFixedSetAllocator<4>> Map
+    // added transitions are appended to input array, so they go after all existing ones
+    int32 InputOrder = 0;
+    for (const FTransitionNode& Node : TransitionNodes)
     {
-        { UHistoryStateDefinition::StaticClass(),  EStateType::History  },
-        { UFinalStateDefinition::StaticClass(),    EStateType::Final    },
-        { UCompoundStateDefinition::StaticClass(), EStateType::Compound },
-        { UParallelStateDefinition::StaticClass(), EStateType::Parallel },
-    };
+        InputOrder = FMath::Max<int32>(InputOrder, Node.InputOrder + 1);
+    }
 
-    return Map.FindRef(Definition->GetClass());
+    if (InputOrder >= 0xffff)
+    {
+        // full rebuild renumbers transitions
+        return false;
+    }
+
+    return InsertTransitionNode(Transition, FIndex(InputOrder));
+}
+
+bool FStateChartNodes::InsertTransitionNode(UTransitionDefinition& Transition, FIndex InputOrder)
+{
+    FIndex SourceIndex = StateIDToNodeIndex.FindRef(Transition.SourceState);
+    if (SourceIndex.IsNone())
+    {
+        return false;
+    }
+
+    FStateNode& SourceNode = StateNodes[SourceIndex];
+    if (Transition.bInitial && !SourceNode.InitialTransitionIndex.IsNone())
+    {
+        // second initial transition, let full rebuild decide which one wins
+        return false;
+    }
+
+    // find position after all transitions that go before new one
+    const int32 RangeEnd = SourceNode.TransitionIndex + SourceNode.NumTransitions + (SourceNode.InitialTransitionIndex.IsNone() ? 0 : 1);
+
+    const FTransitionNode NewNode(SourceIndex, InputOrder, Transition.GetTriggerEventType(), &Transition);
+
+    int32 InsertIndex = SourceNode.TransitionIndex;
+    while (InsertIndex < RangeEnd && !CompareSiblingTransitionNodes(NewNode, TransitionNodes[InsertIndex]))
+    {
+        InsertIndex++;
+    }
+
+    TransitionNodes.Insert(NewNode, InsertIndex);
+
+    // shift ranges of all following states
+    for (int32 StateIndex = 0; StateIndex < StateNodes.Num(); ++StateIndex)
+    {
+        FStateNode& Node = StateNodes[StateIndex];
+
+        if (StateIndex > SourceIndex)
+        {
+            Node.TransitionIndex = Node.TransitionIndex + 1;
+        }
+
+        if (!Node.InitialTransitionIndex.IsNone() && Node.InitialTransitionIndex >= InsertIndex)
+        {
+            Node.InitialTransitionIndex = Node.InitialTransitionIndex + 1;
+        }
+    }
+
+    if (Transition.bInitial)
+    {
+        SourceNode.InitialTransitionIndex = InsertIndex;
+    }
+    else
+    {
+        SourceNode.NumTransitions++;
+    }
+
+    return true;
+}
+
+bool FStateChartNodes::RemoveTransition(UTransitionDefinition& Transition)
+{
+    return RemoveTransitionAt(TransitionNodes.IndexOfByPredicate([&](const FTransitionNode& Node) { return Node.Definition == &Transition; }));
 }
 
-bool FStateChartNodes::CompareStates(UBaseStateDefinition* AState, UBaseStateDefinition* BState) const
+bool FStateChartNodes::UpdateTransition(UTransitionDefinition& Transition)
 {
-    if (!AState->ParentID.IsValid() || AState->ID == BState->ParentID)
+    const int32 TransitionIndex = TransitionNodes.IndexOfByPredicate([&](const FTransitionNode& Node) { return Node.Definition == &Transition; });
+    if (TransitionIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    FTransitionNode& TransitionNode = TransitionNodes[TransitionIndex];
+    TransitionNode.EventID = Transition.GetTriggerEventType();
+
+    const FStateNode& SourceNode = StateNodes[TransitionNode.SourceNodeIndex];
+    const bool bSameSource = SourceNode.Definition->ID == Transition.SourceState;
+    const bool bWasInitial = SourceNode.InitialTransitionIndex == FIndex(TransitionIndex);
+
+    if (bSameSource && bWasInitial == Transition.bInitial && IsTransitionInOrder(TransitionIndex))
     {
+        // layout is not affected
         return true;
     }
 
-    if (AState->ParentID == BState->ParentID)
+    const FIndex InputOrder = TransitionNode.InputOrder;
+    return RemoveTransitionAt(TransitionIndex) && InsertTransitionNode(Transition, InputOrder);
+}
+
+bool FStateChartNodes::InsertLeafState(UBaseStateDefinition& State)
+{
+    if (StateIDToNodeIndex.Contains(State.ID) || StateNodes.Num() + 1 >= 0xffff)
+    {
+        return false;
+    }
+
+    FIndex ParentIndex = StateIDToNodeIndex.FindRef(State.ParentID);
+    if (ParentIndex.IsNone())
+    {
+        return false;
+    }
+
+    const FStateNode& ParentNode = StateNodes[ParentIndex];
+    const bool bParentHadChildren = ParentNode.NumChildren > 0;
+    const FIndex ParentChildIndex = ParentNode.ChildIndex;
+
+    int32 InsertIndex = StateNodes.Num();
+    if (bParentHadChildren)
+    {
+        // find position among siblings
+        const int32 RangeEnd = ParentNode.ChildIndex + ParentNode.NumChildren;
+
+        InsertIndex = ParentNode.ChildIndex;
+        while (InsertIndex < RangeEnd && !CompareSiblingStates(State, *StateNodes[InsertIndex].Definition))
+        {
+            InsertIndex++;
+        }
+    }
+    else
+    {
+        // new children range goes right before children of the next state that has any
+        for (int32 StateIndex = ParentIndex + 1; StateIndex < StateNodes.Num(); ++StateIndex)
+        {
+            if (StateNodes[StateIndex].NumChildren > 0)
+            {
+                InsertIndex = StateNodes[StateIndex].ChildIndex;
+                break;
+            }
+        }
+    }
+
+    FStateNode NewNode(GetStateType(&State), &State);
+    NewNode.ParentIndex = ParentIndex;
+    NewNode.TransitionIndex = StateNodes.IsValidIndex(InsertIndex) ? StateNodes[InsertIndex].TransitionIndex : FIndex(TransitionNodes.Num());
+
+    if (NewNode.Type == EStateType::Compound)
+    {
+        NewNode.Type = EStateType::Atomic;
+    }
+
+    ShiftStateIndexes(InsertIndex, 1);
+    StateNodes.Insert(NewNode, InsertIndex);
+
+    // parent precedes its children, so its index did not change
+    FStateNode& Parent = StateNodes[ParentIndex];
+    Parent.ChildIndex = bParentHadChildren ? ParentChildIndex : FIndex(InsertIndex);
+    Parent.NumChildren++;
+
+    if (Parent.Type == EStateType::Atomic)
+    {
+        Parent.Type = GetStateType(Parent.Definition);
+    }
+
+    StateIDToNodeIndex.Emplace(State.ID, FIndex(InsertIndex));
+    StateIDToDefinition.Emplace(State.ID, &State);
+
+    return true;
+}
+
+bool FStateChartNodes::ReparentState(UBaseStateDefinition& State)
+{
+    FIndex StateIndex = StateIDToNodeIndex.FindRef(State.ID);
+    if (StateIndex.IsNone() || StateNodes[StateIndex].NumChildren > 0 || !StateIDToNodeIndex.Contains(State.ParentID))
+    {
+        // moving whole subtrees is not supported
+        return false;
+    }
+
+    // detach transitions, they will be attached back once state is moved
+    TArray<FTransitionNode, TInlineAllocator<8>> Transitions;
+    {
+        const FStateNode& Node = StateNodes[StateIndex];
+        const int32 RangeEnd = Node.TransitionIndex + Node.NumTransitions + (Node.InitialTransitionIndex.IsNone() ? 0 : 1);
+
+        for (int32 TransitionIndex = Node.TransitionIndex; TransitionIndex < RangeEnd; ++TransitionIndex)
+        {
+            Transitions.Add(TransitionNodes[TransitionIndex]);
+        }
+    }
+
+    for (int32 Index = Transitions.Num() - 1; Index >= 0; --Index)
+    {
+        RemoveTransitionAt(StateNodes[StateIndex].TransitionIndex + Index);
+    }
+
+    if (!RemoveLeafStateAt(StateIndex) || !InsertLeafState(State))
+    {
+        return false;
+    }
+
+    for (const FTransitionNode& Transition : Transitions)
+    {
+        if (!InsertTransitionNode(*Transition.Definition, Transition.InputOrder))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FStateChartNodes::IsEquivalent(const FStateChartNodes& Other, FString* OutDifference) const
+{
+    auto Fail = [&](FString Difference)
+    {
+        if (OutDifference != nullptr)
+        {
+            *OutDifference = MoveTemp(Difference);
+        }
+        return false;
+    };
+
+    if (StateNodes.Num() != Other.StateNodes.Num() || TransitionNodes.Num() != Other.TransitionNodes.Num())
+    {
+        return Fail(FString::Printf(TEXT("Node counts differ: %d/%d states, %d/%d transitions"), StateNodes.Num(), Other.StateNodes.Num(), TransitionNodes.Num(), Other.TransitionNodes.Num()));
+    }
+
+    for (int32 StateIndex = 0; StateIndex < StateNodes.Num(); ++StateIndex)
     {
-        auto ASortable = Cast<UActivatableStateDefinition>(AState);
-        auto BSortable = Cast<UActivatableStateDefinition>(BState);
+        const FStateNode& A = StateNodes[StateIndex];
+        const FStateNode& B = Other.StateNodes[StateIndex];
 
-        if (ASortable && !BSortable)
+        const bool bEqual = A.Type == B.Type
+            && A.ParentIndex == B.ParentIndex
+            && A.TransitionIndex == B.TransitionIndex
+            && A.NumTransitions == B.NumTransitions
+            && A.InitialTransitionIndex == B.InitialTransitionIndex
+            && A.ChildIndex == B.ChildIndex
+            && A.NumChildren == B.NumChildren
+            && A.Definition == B.Definition;
+
+        if (!bEqual)
         {
-            return true;
+            return Fail(FString::Printf(TEXT("State node %d differs"), StateIndex));
         }
+    }
+
+    for (int32 TransitionIndex = 0; TransitionIndex < TransitionNodes.Num(); ++TransitionIndex)
+    {
+        const FTransitionNode& A = TransitionNodes[TransitionIndex];
+        const FTransitionNode& B = Other.TransitionNodes[TransitionIndex];
 
-        if (ASortable && BSortable)
+        if (A.SourceNodeIndex != B.SourceNodeIndex || A.EventID != B.EventID || A.Definition != B.Definition)
         {
-            return ASortable->SortOrder < BSortable->SortOrder;
+            return Fail(FString::Printf(TEXT("Transition node %d differs"), TransitionIndex));
         }
     }
 
-    auto AParent = StateIDToDefinition.FindRef(AState->ParentID);
-    auto BParent = StateIDToDefinition.FindRef(BState->ParentID);
-    if (AParent && BParent)
+    if (!StateIDToNodeIndex.OrderIndependentCompareEqual(Other.StateIDToNodeIndex))
     {
-        return CompareStates(AParent, BParent);
+        return Fail(TEXT("State ID lookups differ"));
+    }
+
+    return true;
+}
+
+void FStateChartNodes::UpdateFeatures()
+{
+    auto HasAsyncActions = [](const TArray<FInstancedStruct>& Actions)
+    {
+        return Algo::AnyOf(Actions, [](const FInstancedStruct& Struct)
+        {
+            const FStateChartAction* Action = Struct.GetPtr<FStateChartAction>();
+            return Action != nullptr && Action->IsAsync();
+        });
+    };
+
+    Features = EStateChartFeatures::None;
+
+    for (const FStateNode& StateNode : StateNodes)
+    {
+        if (StateNode.Type == EStateType::History)
+        {
+            Features |= EStateChartFeatures::History;
+        }
+        else if (StateNode.Type == EStateType::Parallel)
+        {
+            Features |= EStateChartFeatures::Parallel;
+        }
+
+        if (const UActivatableStateDefinition* Activatable = Cast<UActivatableStateDefinition>(StateNode.Definition))
+        {
+            if (Activatable->Handlers.Num() != 0)
+            {
+                // handlers may complete asynchronously too
+                Features |= EStateChartFeatures::Handlers | EStateChartFeatures::AsyncActions;
+            }
+        }
+
+        if (const UBaseStateWithActionsDefinition* WithActions = Cast<UBaseStateWithActionsDefinition>(StateNode.Definition))
+        {
+            if (HasAsyncActions(WithActions->EnterActions) || HasAsyncActions(WithActions->ExitActions))
+            {
+                Features |= EStateChartFeatures::AsyncActions;
+            }
+        }
+    }
+
+    for (const FTransitionNode& TransitionNode : TransitionNodes)
+    {
+        if (TransitionNode.Definition->Conditions.Num() != 0)
+        {
+            Features |= EStateChartFeatures::Conditions;
+        }
+
+        if (HasAsyncActions(TransitionNode.Definition->Actions))
+        {
+            Features |= EStateChartFeatures::AsyncActions;
+        }
+    }
+}
+
+void FStateChartNodes::BuildTagIndex()
+{
+    TagIndex.Reset();
+
+    const UScriptStruct* GenericEventType = FStateChartGenericEvent::StaticStruct();
+    const UScriptStruct* AnyEventType = FStateChartAnyEvent::StaticStruct();
+
+    TArray<FIndex> GenericTransitions;
+    for (int32 TransitionIndex = 0; TransitionIndex < TransitionNodes.Num(); ++TransitionIndex)
+    {
+        const FTransitionNode& TransitionNode = TransitionNodes[TransitionIndex];
+        if ((TransitionNode.EventID == GenericEventType || TransitionNode.EventID == AnyEventType) && !TransitionNode.Definition->bInitial)
+        {
+            GenericTransitions.Add(TransitionIndex);
+        }
+    }
+
+    for (FIndex TransitionIndex : GenericTransitions)
+    {
+        const FGameplayTag& Tag = TransitionNodes[TransitionIndex].Definition->EventTag;
+        if (!Tag.IsValid())
+        {
+            TagIndex.UntaggedTransitions.Add(TransitionIndex);
+            continue;
+        }
+
+        if (TagIndex.ExactTagTransitions.Contains(Tag))
+        {
+            continue;
+        }
+
+        TArray<FIndex> ExactCandidates;
+        TArray<FIndex> DescendantCandidates;
+
+        // GenericTransitions are sorted, so candidates are sorted too
+        for (FIndex CandidateIndex : GenericTransitions)
+        {
+            const UTransitionDefinition& Candidate = *TransitionNodes[CandidateIndex].Definition;
+
+            if (!Candidate.EventTag.IsValid())
+            {
+                ExactCandidates.Add(CandidateIndex);
+                DescendantCandidates.Add(CandidateIndex);
+            }
+            else if (Candidate.bMatchTagExact)
+            {
+                if (Candidate.EventTag == Tag)
+                {
+                    ExactCandidates.Add(CandidateIndex);
+                }
+            }
+            else if (Tag.MatchesTag(Candidate.EventTag))
+            {
+                ExactCandidates.Add(CandidateIndex);
+                DescendantCandidates.Add(CandidateIndex);
+            }
+        }
+
+        TagIndex.ExactTagTransitions.Emplace(Tag, MoveTemp(ExactCandidates));
+        TagIndex.DescendantTagTransitions.Emplace(Tag, MoveTemp(DescendantCandidates));
+    }
+}
+
+void FStateChartNodes::BuildEventTypeIndex()
+{
+    EventTypeIndex.Reset();
+
+    const UScriptStruct* AnyEventType = FStateChartAnyEvent::StaticStruct();
+    const UScriptStruct* TimeoutEventType = FStateChartTimeoutEvent::StaticStruct();
+
+    TArray<FIndex> TypedTransitions;
+    TSet<const UScriptStruct*> ReferencedTypes;
+
+    for (int32 TransitionIndex = 0; TransitionIndex < TransitionNodes.Num(); ++TransitionIndex)
+    {
+        const FTransitionNode& TransitionNode = TransitionNodes[TransitionIndex];
+        if (TransitionNode.Definition->bInitial)
+        {
+            continue;
+        }
+
+        if (TransitionNode.EventID == TimeoutEventType)
+        {
+            // timeout events are matched to their transition directly
+            EventTypeIndex.TimedTransitions.Add(TransitionIndex);
+            continue;
+        }
+
+        if (TransitionNode.Definition->EventTag.IsValid())
+        {
+            continue;
+        }
+
+        if (TransitionNode.EventID == nullptr)
+        {
+            EventTypeIndex.EventlessTransitions.Add(TransitionIndex);
+            continue;
+        }
+
+        if (TransitionNode.EventID == AnyEventType)
+        {
+            EventTypeIndex.AnyEventTransitions.Add(TransitionIndex);
+        }
+        else
+        {
+            ReferencedTypes.Add(TransitionNode.EventID);
+        }
+
+        TypedTransitions.Add(TransitionIndex);
+    }
+
+    // TypedTransitions are sorted, so candidates are sorted too
+    for (const UScriptStruct* Type : ReferencedTypes)
+    {
+        TArray<FIndex>& Candidates = EventTypeIndex.CandidateLists.AddDefaulted_GetRef();
+
+        for (FIndex CandidateIndex : TypedTransitions)
+        {
+            const UScriptStruct* CandidateType = TransitionNodes[CandidateIndex].EventID;
+            if (CandidateType == AnyEventType || Type->IsChildOf(CandidateType))
+            {
+                Candidates.Add(CandidateIndex);
+            }
+        }
+
+        // derived types are not added, FindListIndex resolves them to list of their closest referenced parent
+        EventTypeIndex.TypeToList.Emplace(Type, EventTypeIndex.CandidateLists.Num() - 1);
+    }
+}
+
+void FStateChartNodes::BuildDependencyIndex()
+{
+    DependencyIndex.Reset();
+
+    TArray<FName> Dependencies;
+
+    for (FIndex TransitionIndex : EventTypeIndex.EventlessTransitions)
+    {
+        // transitions without Conditions are taken as soon as possible, they never wait for a change
+        Dependencies.Reset();
+        bool bKnownDependencies = true;
+
+        for (const FInstancedStruct& Struct : TransitionNodes[TransitionIndex].Definition->Conditions)
+        {
+            const FStateChartCondition* Condition = Struct.GetPtr<FStateChartCondition>();
+            if (Condition != nullptr && !Condition->GetDependencies(Dependencies))
+            {
+                bKnownDependencies = false;
+                break;
+            }
+        }
+
+        if (!bKnownDependencies)
+        {
+            DependencyIndex.PollingTransitions.Add(TransitionIndex);
+            continue;
+        }
+
+        for (FName Dependency : Dependencies)
+        {
+            DependencyIndex.DependentTransitions.FindOrAdd(Dependency).AddUnique(TransitionIndex);
+        }
+    }
+}
+
+void FStateChartNodes::BuildGuardTable()
+{
+    GuardTable.Reset();
+    GuardTable.TransitionOffsets.Reserve(TransitionNodes.Num() + 1);
+
+    // distinct conditions of each type, index in array is guard id
+    TMap<const UScriptStruct*, TArray<TPair<const FInstancedStruct*, FIndex>>> Guards;
+
+    for (const FTransitionNode& TransitionNode : TransitionNodes)
+    {
+        GuardTable.TransitionOffsets.Add(GuardTable.GuardIDs.Num());
+
+        for (const FInstancedStruct& Struct : TransitionNode.Definition->Conditions)
+        {
+            const FStateChartCondition* Condition = Struct.GetPtr<FStateChartCondition>();
+            if (Condition == nullptr || !Condition->IsPure())
+            {
+                GuardTable.GuardIDs.Add(FIndex::None);
+                continue;
+            }
+
+            const UScriptStruct* Type = Struct.GetScriptStruct();
+            TArray<TPair<const FInstancedStruct*, FIndex>>& SameTypeGuards = Guards.FindOrAdd(Type);
+
+            const TPair<const FInstancedStruct*, FIndex>* Existing = SameTypeGuards.FindByPredicate([&](const TPair<const FInstancedStruct*, FIndex>& Guard)
+            {
+                return Type->CompareScriptStruct(Guard.Key->GetMemory(), Struct.GetMemory(), PPF_None);
+            });
+
+            if (Existing != nullptr)
+            {
+                GuardTable.GuardIDs.Add(Existing->Value);
+            }
+            else if (GuardTable.NumGuards < 0xffff)
+            {
+                SameTypeGuards.Emplace(&Struct, GuardTable.NumGuards);
+                GuardTable.GuardIDs.Add(GuardTable.NumGuards++);
+            }
+            else
+            {
+                // out of ids, evaluate it every time
+                GuardTable.GuardIDs.Add(FIndex::None);
+            }
+        }
+    }
+
+    GuardTable.TransitionOffsets.Add(GuardTable.GuardIDs.Num());
+}
+
+void FStateChartNodes::BuildHandlerTable()
+{
+    HandlerTable.Reset();
+
+    if (!EnumHasAnyFlags(Features, EStateChartFeatures::Handlers))
+    {
+        return;
+    }
+
+    HandlerTable.StateOffsets.Reserve(StateNodes.Num() + 1);
+
+    for (const FStateNode& StateNode : StateNodes)
+    {
+        HandlerTable.StateOffsets.Add(HandlerTable.NumHandlers);
+
+        if (const UActivatableStateDefinition* Activatable = Cast<UActivatableStateDefinition>(StateNode.Definition))
+        {
+            HandlerTable.NumHandlers += Activatable->Handlers.Num();
+        }
+    }
+
+    HandlerTable.StateOffsets.Add(HandlerTable.NumHandlers);
+}
+
+void FStateChartNodes::BuildHistoryTable()
+{
+    HistoryTable.Reset();
+
+    TArray<FIndex> RememberedStates;
+    TArray<FIndex, TInlineAllocator<16>> PendingStates;
+
+    for (int32 StateIndex = 0; StateIndex < StateNodes.Num(); ++StateIndex)
+    {
+        const FStateNode& StateNode = StateNodes[StateIndex];
+        if (StateNode.Type != EStateType::History || StateNode.ParentIndex.IsNone())
+        {
+            continue;
+        }
+
+        FStateChartHistoryTable::FSlot& Slot = HistoryTable.Slots.AddDefaulted_GetRef();
+        Slot.StateIndex = StateIndex;
+        Slot.ParentIndex = StateNode.ParentIndex;
+        Slot.StorageOffset = HistoryTable.NumStorageWords;
+
+        const FStateNode& ParentNode = StateNodes[StateNode.ParentIndex];
+        const bool bDeep = StateNode.GetDefinition<UHistoryStateDefinition>()->HistoryType == EHistoryType::Deep;
+
+        if (!bDeep && ParentNode.Type == EStateType::Compound)
+        {
+            // compound state has single active child
+            Slot.bSingleChild = true;
+            HistoryTable.NumStorageWords += 1;
+            continue;
+        }
+
+        RememberedStates.Reset();
+
+        if (bDeep)
+        {
+            PendingStates.Reset();
+            PendingStates.Add(StateNode.ParentIndex);
+
+            while (PendingStates.Num() != 0)
+            {
+                const FStateNode& Node = StateNodes[PendingStates.Pop()];
+                for (int32 ChildIndex = Node.ChildIndex; ChildIndex < Node.ChildIndex + Node.NumChildren; ++ChildIndex)
+                {
+                    if (StateNodes[ChildIndex].Type == EStateType::Atomic)
+                    {
+                        RememberedStates.Add(ChildIndex);
+                    }
+                    else if (StateNodes[ChildIndex].NumChildren != 0)
+                    {
+                        PendingStates.Add(ChildIndex);
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (int32 ChildIndex = ParentNode.ChildIndex; ChildIndex < ParentNode.ChildIndex + ParentNode.NumChildren; ++ChildIndex)
+            {
+                if (StateNodes[ChildIndex].Type != EStateType::History)
+                {
+                    RememberedStates.Add(ChildIndex);
+                }
+            }
+        }
+
+        // descendants of a state are spread over its whole level order range, so only words holding remembered states are stored
+        RememberedStates.Sort();
+        Slot.MaskOffset = HistoryTable.Masks.Num();
+
+        for (FIndex RememberedIndex : RememberedStates)
+        {
+            const int32 Word = RememberedIndex / 32;
+            if (HistoryTable.MaskWords.Num() == Slot.MaskOffset || HistoryTable.MaskWords.Last() != Word)
+            {
+                HistoryTable.MaskWords.Add(Word);
+                HistoryTable.Masks.Add(0);
+            }
+
+            HistoryTable.Masks.Last() |= 1u << (RememberedIndex % 32);
+        }
+
+        Slot.NumWords = HistoryTable.Masks.Num() - Slot.MaskOffset;
+        HistoryTable.NumStorageWords += Slot.NumWords;
+    }
+}
+
+bool FStateChartNodes::RemoveTransitionAt(int32 TransitionIndex)
+{
+    if (!TransitionNodes.IsValidIndex(TransitionIndex))
+    {
+        return false;
+    }
+
+    const FIndex SourceIndex = TransitionNodes[TransitionIndex].SourceNodeIndex;
+    FStateNode& SourceNode = StateNodes[SourceIndex];
+
+    if (SourceNode.InitialTransitionIndex == FIndex(TransitionIndex))
+    {
+        SourceNode.InitialTransitionIndex = FIndex::None;
+    }
+    else
+    {
+        SourceNode.NumTransitions--;
+    }
+
+    TransitionNodes.RemoveAt(TransitionIndex);
+
+    // shift ranges of all following states
+    for (int32 StateIndex = 0; StateIndex < StateNodes.Num(); ++StateIndex)
+    {
+        FStateNode& Node = StateNodes[StateIndex];
+
+        if (StateIndex > SourceIndex)
+        {
+            Node.TransitionIndex = Node.TransitionIndex - 1;
+        }
+
+        if (!Node.InitialTransitionIndex.IsNone() && Node.InitialTransitionIndex > FIndex(TransitionIndex))
+        {
+            Node.InitialTransitionIndex = Node.InitialTransitionIndex - 1;
+        }
+    }
+
+    return true;
+}
+
+bool FStateChartNodes::RemoveLeafStateAt(int32 StateIndex)
+{
+    const FStateNode& Node = StateNodes[StateIndex];
+    if (Node.NumChildren > 0 || Node.NumTransitions > 0 || !Node.InitialTransitionIndex.IsNone() || Node.ParentIndex.IsNone())
+    {
+        return false;
+    }
+
+    FStateNode& Parent = StateNodes[Node.ParentIndex];
+    Parent.NumChildren--;
+
+    if (Parent.NumChildren == 0)
+    {
+        Parent.ChildIndex = 0;
+
+        if (Parent.Type == EStateType::Compound)
+        {
+            Parent.Type = EStateType::Atomic;
+        }
+    }
+
+    StateIDToNodeIndex.Remove(Node.Definition->ID);
+    StateNodes.RemoveAt(StateIndex);
+    ShiftStateIndexes(StateIndex + 1, -1);
+
+    return true;
+}
+
+bool FStateChartNodes::IsTransitionInOrder(int32 TransitionIndex) const
+{
+    const FTransitionNode& Node = TransitionNodes[TransitionIndex];
+
+    if (TransitionNodes.IsValidIndex(TransitionIndex - 1))
+    {
+        const FTransitionNode& Prev = TransitionNodes[TransitionIndex - 1];
+        if (Prev.SourceNodeIndex == Node.SourceNodeIndex && CompareSiblingTransitionNodes(Node, Prev))
+        {
+            return false;
+        }
+    }
+
+    if (TransitionNodes.IsValidIndex(TransitionIndex + 1))
+    {
+        const FTransitionNode& Next = TransitionNodes[TransitionIndex + 1];
+        if (Next.SourceNodeIndex == Node.SourceNodeIndex && CompareSiblingTransitionNodes(Next, Node))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FStateChartNodes::ShiftStateIndexes(int32 FirstIndex, int32 Delta)
+{
+    // update every reference to states at FirstIndex and after
+    auto Shift = [&](FIndex& Index)
+    {
+        if (!Index.IsNone() && Index >= FirstIndex)
+        {
+            Index = Index + Delta;
+        }
+    };
+
+    for (FStateNode& Node : StateNodes)
+    {
+        Shift(Node.ParentIndex);
+
+        if (Node.NumChildren > 0)
+        {
+            Shift(Node.ChildIndex);
+        }
+    }
+
+    for (FTransitionNode& Node : TransitionNodes)
+    {
+        Shift(Node.SourceNodeIndex);
+    }
+
+    for (auto& Pair : StateIDToNodeIndex)
+    {
+        Shift(Pair.Value);
+    }
+}
+
+EStateType FStateChartNodes::GetStateType(TObjectPtr<UBaseStateDefinition> Definition) const
+{
+    static TMap<UClass*, EStateType, TFixedSetAllocator<4>> Map
+    {
+        { UHistoryStateDefinition::StaticClass(),  EStateType::History  },
+        { UFinalStateDefinition::StaticClass(),    EStateType::Final    },
+        { UCompoundStateDefinition::StaticClass(), EStateType::Compound },
+        { UParallelStateDefinition::StaticClass(), EStateType::Parallel },
+    };
+
+    return Map.FindRef(Definition->GetClass());
+}
+
+bool FStateChartNodes::CompareSiblingStates(const UBaseStateDefinition& AState, const UBaseStateDefinition& BState)
+{
+    // activatable states go first ordered by their SortOrder, other states keep their relative order
+    auto ASortable = Cast<UActivatableStateDefinition>(&AState);
+    auto BSortable = Cast<UActivatableStateDefinition>(&BState);
+
+    if (ASortable && BSortable)
+    {
+        return ASortable->SortOrder < BSortable->SortOrder;
+    }
+
+    return ASortable && !BSortable;
+}
+
+bool FStateChartNodes::CompareSiblingTransitions(const UTransitionDefinition& ATransition, const UTransitionDefinition& BTransition)
+{
+    if (ATransition.bInitial != BTransition.bInitial)
+    {
+        // initial transition goes last
+        return !ATransition.bInitial;
+    }
+
+    return ATransition.SortOrder < BTransition.SortOrder;
+}
+
+bool FStateChartNodes::CompareSiblingTransitionNodes(const FTransitionNode& ANode, const FTransitionNode& BNode)
+{
+    if (CompareSiblingTransitions(*ANode.Definition, *BNode.Definition))
+    {
+        return true;
     }
 
-    return false;
+    // equal transitions keep their input order
+    return !CompareSiblingTransitions(*BNode.Definition, *ANode.Definition) && ANode.InputOrder < BNode.InputOrder;
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartSubsystem.h"
+#include "StateChartAsset.h"
+
+TSharedRef<IStateChartExecutor> UStateChartSubsystem::CreateExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject)
+{
+    TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(StateChartAsset, ContextObject);
+    Executor->SetTimerWheel(TimerWheel);
+    Executor->SetEventBus(EventBus);
+
+    return Executor;
+}
+
+FStateChartExecutorPool& UStateChartSubsystem::GetExecutorPool(UStateChartAsset& StateChartAsset)
+{
+    if (TSharedRef<FStateChartExecutorPool>* Pool = ExecutorPools.Find(&StateChartAsset))
+    {
+        return **Pool;
+    }
+
+    return *ExecutorPools.Add(&StateChartAsset, MakeShared<FStateChartExecutorPool>(StateChartAsset, TimerWheel, EventBus));
+}
+
+void UStateChartSubsystem::RegisterExecutor(const TSharedRef<IStateChartExecutor>& Executor)
+{
+    Executors.AddUnique(Executor);
+    Executor->SetDeferredProcessing(true);
+}
+
+void UStateChartSubsystem::UnregisterExecutor(const TSharedRef<IStateChartExecutor>& Executor)
+{
+    if (Executors.Remove(Executor) != 0)
+    {
+        Executor->SetDeferredProcessing(false);
+        Executor->Pump(MAX_int32);
+    }
+}
+
+void UStateChartSubsystem::PumpExecutors(double BudgetSeconds)
+{
+    const double StartTime = FPlatformTime::Seconds();
+    const double Deadline = StartTime + BudgetSeconds;
+
+    Executors.RemoveAll([](const TWeakPtr<IStateChartExecutor>& Executor) { return !Executor.IsValid(); });
+
+    UpdateSignificance();
+
+    // scan starts from the executor following the last one processed, so all of them get their turn when budget is short
+    int32 Backlog = 0;
+    for (int32 Offset = 0; Offset < Executors.Num(); ++Offset)
+    {
+        const int32 ExecutorIndex = (NextExecutorIndex + Offset) % Executors.Num();
+        TSharedPtr<IStateChartExecutor> Executor = Executors[ExecutorIndex].Pin();
+
+        if (Executor.IsValid() && Executor->GetNumQueuedEvents() != 0)
+        {
+            if (IsDue(Executor->GetSignificance(), ExecutorIndex))
+            {
+                DueExecutors.Add({ MoveTemp(Executor), ExecutorIndex });
+            }
+            else
+            {
+                Backlog += Executor->GetNumQueuedEvents();
+            }
+        }
+    }
+
+    int32 NumMacrosteps = 0;
+    int32 NumIdleInRow = 0;
+    double Now = FPlatformTime::Seconds();
+
+    // every turn processes single event of one executor. Loop ends when whole round found nothing to do
+    for (int32 Turn = 0; NumIdleInRow < DueExecutors.Num() && Now < Deadline; ++Turn)
+    {
+        const FDueExecutor& DueExecutor = DueExecutors[Turn % DueExecutors.Num()];
+        const int32 NumProcessed = DueExecutor.Executor->Pump(1, Deadline - Now);
+
+        if (NumProcessed != 0)
+        {
+            NumMacrosteps += NumProcessed;
+            NumIdleInRow = 0;
+            NextExecutorIndex = DueExecutor.Index + 1;
+        }
+        else
+        {
+            NumIdleInRow += 1;
+        }
+
+        Now = FPlatformTime::Seconds();
+    }
+
+    for (const FDueExecutor& DueExecutor : DueExecutors)
+    {
+        Backlog += DueExecutor.Executor->GetNumQueuedEvents();
+    }
+
+    DueExecutors.Reset();
+    FrameCounter += 1;
+
+    SchedulerStats.LastFrameSeconds = Now - StartTime;
+    SchedulerStats.LastFrameMacrosteps = NumMacrosteps;
+    SchedulerStats.Backlog = Backlog;
+    SchedulerStats.MaxBacklog = FMath::Max(SchedulerStats.MaxBacklog, Backlog);
+
+    // executors waiting for async actions or for their frame keep events without exceeding the budget
+    SchedulerStats.NumBudgetOverruns += Backlog != 0 && Now >= Deadline ? 1 : 0;
+}
+
+void UStateChartSubsystem::SetSignificanceInterval(EStateChartSignificance Significance, int32 NumFrames)
+{
+    switch (Significance)
+    {
+        case EStateChartSignificance::Medium:
+            MediumSignificanceInterval = FMath::Max(NumFrames, 1);
+            break;
+
+        case EStateChartSignificance::Low:
+            LowSignificanceInterval = FMath::Max(NumFrames, 1);
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool UStateChartSubsystem::IsDue(EStateChartSignificance Significance, int32 ExecutorIndex) const
+{
+    int32 Interval = 1;
+
+    switch (Significance)
+    {
+        case EStateChartSignificance::Medium:
+            Interval = MediumSignificanceInterval;
+            break;
+
+        case EStateChartSignificance::Low:
+            Interval = LowSignificanceInterval;
+            break;
+
+        default:
+            break;
+    }
+
+    // executors of one significance are spread over frames of their interval, so load stays even
+    return Interval <= 1 || (FrameCounter + uint32(ExecutorIndex)) % uint32(Interval) == 0;
+}
+
+void UStateChartSubsystem::UpdateSignificance()
+{
+    if (!SignificanceCallback.IsBound() || Executors.Num() == 0)
+    {
+        return;
+    }
+
+    const int32 NumUpdates = FMath::Min(MaxSignificanceUpdatesPerFrame, Executors.Num());
+    for (int32 Update = 0; Update < NumUpdates; ++Update)
+    {
+        NextSignificanceIndex = NextSignificanceIndex % Executors.Num();
+
+        if (TSharedPtr<IStateChartExecutor> Executor = Executors[NextSignificanceIndex].Pin())
+        {
+            Executor->SetSignificance(SignificanceCallback.Execute(*Executor));
+        }
+
+        NextSignificanceIndex += 1;
+    }
+}
+
+void UStateChartSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+    Super::AddReferencedObjects(InThis, Collector);
+
+    CastChecked<UStateChartSubsystem>(InThis)->Messenger->AddStructReferencedObjects(Collector);
+}
+
+void UStateChartSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    TimerWheel->Advance(DeltaTime);
+    Messenger->Flush();
+    PumpExecutors(FrameBudgetMilliseconds / 1000.0);
+}
+
+TStatId UStateChartSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UStateChartSubsystem, STATGROUP_Tickables);
+}
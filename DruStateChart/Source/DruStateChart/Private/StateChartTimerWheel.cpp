@@ -0,0 +1,264 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "StateChartTimerWheel.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "Algo/StableSort.h"
+
+FStateChartTimerWheel::FStateChartTimerWheel(double InTickInterval)
+    : TickInterval(InTickInterval)
+{
+    check(TickInterval > 0.0);
+
+    for (int32& Slot : Slots)
+    {
+        Slot = INDEX_NONE;
+    }
+}
+
+FStateChartTimerHandle FStateChartTimerWheel::Schedule(IStateChartExecutor& Owner, uint32 Cookie, double DelaySeconds)
+{
+    int32 TimerIndex = FirstFree;
+    if (TimerIndex != INDEX_NONE)
+    {
+        FirstFree = Timers[TimerIndex].Next;
+    }
+    else
+    {
+        TimerIndex = Timers.AddDefaulted();
+    }
+
+    // time accumulated since last tick counts too, so timer never expires before its delay
+    const uint64 DelayTicks = FMath::Max<uint64>(1, FMath::CeilToInt64((FMath::Max(DelaySeconds, 0.0) + AccumulatedTime) / TickInterval));
+
+    FTimer& Timer = Timers[TimerIndex];
+    Timer.Owner = Owner.AsShared();
+    Timer.DueTick = CurrentTick + DelayTicks;
+    Timer.Sequence = NextSequence++;
+    Timer.Cookie = Cookie;
+
+    Link(TimerIndex);
+    NumTimers++;
+
+    FStateChartTimerHandle Handle;
+    Handle.Index = TimerIndex;
+    Handle.Serial = Timer.Serial;
+    return Handle;
+}
+
+bool FStateChartTimerWheel::Cancel(const FStateChartTimerHandle& Handle)
+{
+    if (!Timers.IsValidIndex(Handle.Index))
+    {
+        return false;
+    }
+
+    FTimer& Timer = Timers[Handle.Index];
+    if (Timer.Serial != Handle.Serial || Timer.Slot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    Unlink(Handle.Index);
+    Free(Handle.Index);
+    return true;
+}
+
+const uint32* FStateChartTimerWheel::FindCookie(const FStateChartTimerHandle& Handle) const
+{
+    if (!Timers.IsValidIndex(Handle.Index))
+    {
+        return nullptr;
+    }
+
+    const FTimer& Timer = Timers[Handle.Index];
+    return Timer.Serial == Handle.Serial && Timer.Slot != INDEX_NONE ? &Timer.Cookie : nullptr;
+}
+
+void FStateChartTimerWheel::Advance(double DeltaSeconds)
+{
+    checkf(!bDelivering, TEXT("Timer wheel cannot be advanced from timer callback"));
+
+    AccumulatedTime += DeltaSeconds;
+
+    const uint64 NumTicks = static_cast<uint64>(FMath::Max(AccumulatedTime / TickInterval, 0.0));
+    AccumulatedTime -= NumTicks * TickInterval;
+
+    if (NumTimers == 0)
+    {
+        // nothing to cascade or expire
+        CurrentTick += NumTicks;
+        return;
+    }
+
+    uint64 Tick = 0;
+    for (; Tick < NumTicks && NumTimers != 0; ++Tick)
+    {
+        ProcessTick();
+    }
+
+    CurrentTick += NumTicks - Tick;
+
+    if (PendingDeliveries.Num() == 0)
+    {
+        return;
+    }
+
+    // deliver in order of expiration, grouped by executor, so each of them gets single call
+    PendingDeliveries.Sort([](const FPendingDelivery& A, const FPendingDelivery& B)
+    {
+        return A.DueTick != B.DueTick ? A.DueTick < B.DueTick : A.Sequence < B.Sequence;
+    });
+
+    Algo::StableSortBy(PendingDeliveries, [](const FPendingDelivery& Delivery) { return Delivery.Owner.Get(); });
+
+    TGuardValue<bool> Guard(bDelivering, true);
+    TArray<FPendingDelivery> Deliveries = MoveTemp(PendingDeliveries);
+    TArray<FStateChartExpiredTimer, TInlineAllocator<16>> Batch;
+
+    for (int32 Index = 0; Index < Deliveries.Num();)
+    {
+        IStateChartExecutor* Owner = Deliveries[Index].Owner.Get();
+
+        Batch.Reset();
+        for (; Index < Deliveries.Num() && Deliveries[Index].Owner.Get() == Owner; ++Index)
+        {
+            Batch.Add(Deliveries[Index].Timer);
+        }
+
+        Owner->OnTimersExpired(Batch);
+    }
+
+    // keep allocation for the next call
+    Deliveries.Reset();
+    PendingDeliveries = MoveTemp(Deliveries);
+}
+
+void FStateChartTimerWheel::ProcessTick()
+{
+    ++CurrentTick;
+
+    // timers of higher levels move down when range of their slot starts. Top levels go first, because they may fill lower slots that cascade in the same tick
+    int32 TopLevel = 0;
+    while (TopLevel < NumLevels - 1 && (CurrentTick & ((uint64(1) << (SlotBits * (TopLevel + 1))) - 1)) == 0)
+    {
+        ++TopLevel;
+    }
+
+    for (int32 Level = TopLevel; Level > 0; --Level)
+    {
+        Cascade(Level);
+    }
+
+    int32 TimerIndex = DetachSlot(CurrentTick & (NumSlots - 1));
+    while (TimerIndex != INDEX_NONE)
+    {
+        FTimer& Timer = Timers[TimerIndex];
+        const int32 NextIndex = Timer.Next;
+
+        if (Timer.DueTick > CurrentTick)
+        {
+            // was placed into far slot because its delay exceeds range of the wheel
+            Link(TimerIndex);
+        }
+        else
+        {
+            if (TSharedPtr<IStateChartExecutor> Owner = Timer.Owner.Pin())
+            {
+                FStateChartTimerHandle Handle;
+                Handle.Index = TimerIndex;
+                Handle.Serial = Timer.Serial;
+
+                PendingDeliveries.Add({ MoveTemp(Owner), Timer.DueTick, Timer.Sequence, { Handle, Timer.Cookie } });
+            }
+
+            Free(TimerIndex);
+        }
+
+        TimerIndex = NextIndex;
+    }
+}
+
+void FStateChartTimerWheel::Cascade(int32 Level)
+{
+    const int32 Slot = Level * NumSlots + ((CurrentTick >> (SlotBits * Level)) & (NumSlots - 1));
+
+    int32 TimerIndex = DetachSlot(Slot);
+    while (TimerIndex != INDEX_NONE)
+    {
+        const int32 NextIndex = Timers[TimerIndex].Next;
+        Link(TimerIndex);
+        TimerIndex = NextIndex;
+    }
+}
+
+void FStateChartTimerWheel::Link(int32 TimerIndex)
+{
+    FTimer& Timer = Timers[TimerIndex];
+
+    // lowest level whose slots cover distance to DueTick
+    int32 Level = 0;
+    while (Level < NumLevels - 1 && (Timer.DueTick >> (SlotBits * Level)) - (CurrentTick >> (SlotBits * Level)) >= NumSlots)
+    {
+        ++Level;
+    }
+
+    const uint64 LevelTick = CurrentTick >> (SlotBits * Level);
+    const uint64 LevelDueTick = FMath::Min(Timer.DueTick >> (SlotBits * Level), LevelTick + NumSlots - 1);
+
+    const int32 Slot = Level * NumSlots + (LevelDueTick & (NumSlots - 1));
+
+    Timer.Slot = Slot;
+    Timer.Prev = INDEX_NONE;
+    Timer.Next = Slots[Slot];
+
+    if (Timer.Next != INDEX_NONE)
+    {
+        Timers[Timer.Next].Prev = TimerIndex;
+    }
+
+    Slots[Slot] = TimerIndex;
+}
+
+void FStateChartTimerWheel::Unlink(int32 TimerIndex)
+{
+    FTimer& Timer = Timers[TimerIndex];
+
+    if (Timer.Prev != INDEX_NONE)
+    {
+        Timers[Timer.Prev].Next = Timer.Next;
+    }
+    else
+    {
+        Slots[Timer.Slot] = Timer.Next;
+    }
+
+    if (Timer.Next != INDEX_NONE)
+    {
+        Timers[Timer.Next].Prev = Timer.Prev;
+    }
+
+    Timer.Prev = INDEX_NONE;
+    Timer.Next = INDEX_NONE;
+}
+
+int32 FStateChartTimerWheel::DetachSlot(int32 Slot)
+{
+    const int32 First = Slots[Slot];
+    Slots[Slot] = INDEX_NONE;
+    return First;
+}
+
+void FStateChartTimerWheel::Free(int32 TimerIndex)
+{
+    FTimer& Timer = Timers[TimerIndex];
+    Timer.Owner.Reset();
+    Timer.Slot = INDEX_NONE;
+    Timer.Prev = INDEX_NONE;
+    Timer.Next = FirstFree;
+
+    // invalidates all handles of this timer
+    Timer.Serial++;
+
+    FirstFree = TimerIndex;
+    NumTimers--;
+}
@@ -138,12 +138,21 @@ namespace DruStateChart_Impl
         template <typename... TChildren>
         T& Children(TChildren&... InChildren)
         {
-            int32 Index = 0;
-            (AddChildBuilder(InChildren, Index++), ...);
+            (AddChildBuilder(InChildren, NumChildren++), ...);
+            return *static_cast<T*>(this);
+        }
+
+        /* Adds single Child state or transition after already added ones. Useful when children are generated in a loop */
+        template <typename TChild>
+        T& Child(TChild& InChild)
+        {
+            AddChildBuilder(InChild, NumChildren++);
             return *static_cast<T*>(this);
         }
 
     protected:
+        int32 NumChildren = 0;
+
         template <typename TBuilder>
         void AddChildBuilder(TBuilder& Builder, int32 Index)
         {
@@ -201,6 +210,12 @@ namespace DruStateChart_Impl
             return *static_cast<T*>(this);
         }
 
+        /* Sets transition to be triggered by event of any type */
+        T& AnyEvent()
+        {
+            return Event<FStateChartAnyEvent>();
+        }
+
     protected:
         TObjectPtr<UScriptStruct> EventStruct;
     };
@@ -219,11 +234,30 @@ namespace DruStateChart_Impl
         {
             check(EventTag.IsValid());
 
-            T& CastedThis = *static_cast<T*>(this);
-            CastedThis.Event<FStateChartGenericEvent>();
-            CastedThis.Condition(FStateChartGenericEventCondition(EventTag, bMatchExact));
-            return CastedThis;
+            TriggerTag = EventTag;
+            bMatchTagExact = bMatchExact;
+            return *static_cast<T*>(this);
         }
+
+    protected:
+        FGameplayTag TriggerTag;
+        bool bMatchTagExact = false;
+    };
+
+    template <typename T>
+    struct TDelayOp
+    {
+        /* Sets transition to be taken after its source state was active for given time */
+        T& After(float Seconds)
+        {
+            check(Seconds > 0.f);
+
+            Delay = Seconds;
+            return *static_cast<T*>(this);
+        }
+
+    protected:
+        float Delay = 0.f;
     };
 
     template<typename T>
@@ -281,6 +315,7 @@ namespace DruStateChart_Impl
         , public DruStateChart_Impl::TInitialTransitionOp<FTransitionBuilder>
         , public DruStateChart_Impl::TEventOp<FTransitionBuilder>
         , public DruStateChart_Impl::TEventTagOp<FTransitionBuilder>
+        , public DruStateChart_Impl::TDelayOp<FTransitionBuilder>
         , public DruStateChart_Impl::TTargetOp<FTransitionBuilder>
         , public DruStateChart_Impl::TConditionOp<FTransitionBuilder>
         , public DruStateChart_Impl::TActionOp<FTransitionBuilder>
@@ -2,42 +2,72 @@
 
 #pragma once
 
-#include "UObject/GCObject.h"
+#include "Containers/BitArray.h"
 #include "Interfaces/IStateChartExecutor.h"
+#include "Impl/StateChartExecutorRegistry.h"
 #include "StateChartTypes.h"
 #include "Impl/StateChartNodes.h"
+#include "Impl/StateChartEventQueue.h"
+#include "Impl/StateChartSolver.h"
+#include "StateChartTimerWheel.h"
+#include "StateChartEventBus.h"
+#include "Containers/SparseArray.h"
 #include "UObject/ObjectPtr.h"
-#include "Containers/RingBuffer.h"
 #include "InstancedStruct.h"
+#include "PropertyBag.h"
 #include "StructView.h"
 #include "Concepts/StaticStructProvider.h"
 
+struct FStateChartTimeoutEvent;
+
 namespace DruStateChart_Impl
 {
 
 /*
- * Default implementation of an executor
+ * Default implementation of an executor.
+ * Paths for features not present in Features are compiled out
  */
-class DRUSTATECHART_API FStateChartDefaultExecutor : public FGCObject, public IStateChartExecutor
+template <EStateChartFeatures Features>
+class TStateChartExecutor : public IStateChartExecutor
 {
 public:
     using FHandlerCreated = TMulticastDelegate<void(UStateHandler& NewHandler)>;
 
-    FStateChartDefaultExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject = nullptr);
+    TStateChartExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject = nullptr);
+    ~TStateChartExecutor();
 
     TObjectPtr<UStateChartAsset> GetExecutingAsset() const override { return Asset; }
+    TObjectPtr<UObject> GetContextObject() const override { return Context.ContextObject; }
     void Execute() override;
+    void Stop() override;
+    void Reset(TObjectPtr<UObject> ContextObject = nullptr) override;
     TArray<TObjectPtr<UBaseStateDefinition>> GetActiveStates() const override;
-    FHandlerCreated& OnStateHandlerCreated() override { return StateHandlerCreatedDelegate; }
+    FHandlerCreated& OnStateHandlerCreated() override;
+    FStructView GetDatamodel() override { return Context.Datamodel; }
+    void NotifyDatamodelChanged(FName VariableName) override;
+    void Update() override;
+    void InvalidateDependency(FName Dependency) override;
+    FStateChartExecutorStats GetStats() const override;
+    void SetDeferredProcessing(bool bDeferred) override { bDeferEvents = bDeferred; }
+    int32 Pump(int32 MaxMacrosteps, double MaxSeconds = 0.0) override;
+    int32 GetNumQueuedEvents() const override { return ExternalEventQueue.Num() + InternalEventQueue.Num(); }
+    void SetSignificance(EStateChartSignificance InSignificance) override { Significance = InSignificance; }
+    EStateChartSignificance GetSignificance() const override { return Significance; }
+    void CancelDelayedEvent(const FStateChartTimerHandle& Handle) override;
+    void SetTimerWheel(TSharedPtr<FStateChartTimerWheel> InTimerWheel) override;
+    void SetEventBus(TSharedPtr<FStateChartEventBus> InEventBus) override;
 
-    // Begin FGCObject overrides
     void AddReferencedObjects(FReferenceCollector& Collector) override;
-    FString GetReferencerName() const override;
-    //~End FGCObject overrides
 
 private:
-    class FStateIndexArray : public TArray<FIndex, TInlineAllocator<24>> {};
-    class FTransitionIndexArray : public TArray<FIndex, TInlineAllocator<24>> {};
+    static constexpr bool bHasHistory = EnumHasAnyFlags(Features, EStateChartFeatures::History);
+    static constexpr bool bHasParallel = EnumHasAnyFlags(Features, EStateChartFeatures::Parallel);
+    static constexpr bool bHasHandlers = EnumHasAnyFlags(Features, EStateChartFeatures::Handlers);
+    static constexpr bool bHasAsyncActions = EnumHasAnyFlags(Features, EStateChartFeatures::AsyncActions);
+    static constexpr bool bHasConditions = EnumHasAnyFlags(Features, EStateChartFeatures::Conditions);
+
+    using FStateIndexArray = DruStateChart_Impl::FStateIndexArray;
+    using FTransitionIndexArray = DruStateChart_Impl::FTransitionIndexArray;
 
     enum class EStepType : uint8
     {
@@ -50,29 +80,73 @@ private:
         FIndex ObjectIndex;
     };
 
+    /* Cached result of pure condition. Valid only if Epoch matches GuardEpoch */
+    struct FGuardResult
+    {
+        uint32 Epoch = 0;
+        bool bPassed = false;
+    };
+
+    struct FDelayedEvent
+    {
+        FStateChartTimerHandle Timer;
+        FInstancedStruct Event;
+    };
+
+    // cookies of timeout timers have this bit set and store index of transition, others store index in DelayedEvents
+    static constexpr uint32 TimeoutCookieFlag = 0x80000000u;
+
+    // cookie of the timer limiting how long current step waits for its Actions
+    static constexpr uint32 ActionTimeoutCookie = 0xffffffffu;
+
+    /* Scratch data of a running plan. Taken from shared pool when plan starts and returned when it completes, so idle executors do not carry it */
     struct FExecutionPlan
     {
-        FExecutionPlan() = default;
-        FExecutionPlan(uint16 NewIndex) : PlanIndex(NewIndex) {}
+        /* Clears plan before it returns to the pool. Allocations are kept */
+        void Reset();
 
-        uint16 PlanIndex = 0;
         uint16 StepIndex = 0;
         uint16 NumActionsToComplete = 0;
         EActionContinuationType ContinuationType = EActionContinuationType::Default;
 
+        // longest timeout of Actions current step waits for. Step waits forever if any of them has no timeout
+        float StepTimeout = 0.f;
+        bool bStepWaitsForever = false;
+
         TArray<FExecutionPlanStep, TInlineAllocator<32>> Steps;
         FStateIndexArray StatesForDefaultEntry;
 
         FSimpleDelegate ContinuationDelegate;
+
+        // only one of them is set. Event is created from EventTag on demand
         FInstancedStruct Event;
+        FGameplayTag EventTag;
     };
 
     void ExecuteEventImpl(FConstStructView Event) override;
-    void StartNewPlan(const FTransitionIndexArray& Transitions, FInstancedStruct Event);
+    void ExecuteTagEventImpl(const FGameplayTag& EventTag) override;
+    FStateChartTimerHandle ExecuteEventDelayedImpl(FConstStructView Event, float DelaySeconds) override;
+    void OnTimersExpired(TArrayView<const FStateChartExpiredTimer> Timers) override;
+    void StartNewPlan(const FTransitionIndexArray& Transitions, FInstancedStruct Event, const FGameplayTag& EventTag = FGameplayTag());
+
+    /* Plans are shared by all executors of this type. Executors run on game thread, so pool needs no locking */
+    static TArray<TUniquePtr<FExecutionPlan>>& GetPlanPool();
+    void AcquirePlan();
+    void ReleasePlan();
+
+    /* Returns event of CurrentPlan, creating it from EventTag if needed */
+    FConstStructView GetPlanEvent();
 
     void ProcessEventsSynchronous();
     void ProcessPlanSynchronous();
 
+    /* Returns true if next external event may be processed now. Deferred executors process them inside Pump only */
+    bool CanProcessExternalEvent() const;
+
+    /* Starts plan for enabled eventless transitions. Returns false if there are none or limit of the macrostep is reached */
+    bool StartEventlessPlan();
+    void FinishMacrostep();
+
     void RecordHistoryStates(const FStateIndexArray& StatesToExit);
 
     EActionContinuationType ExitStateAsync(FIndex NodeIndex);
@@ -81,47 +155,144 @@ private:
 
     void OnActionCompleted(uint16 PlanIndex, uint16 StepIndex);
 
+    /* Limits how long current step waits for its Actions. Expired timeout continues the plan without them */
+    void ScheduleActionTimeout();
+    void CancelActionTimeout();
+    void OnActionTimeout();
+
     FTransitionIndexArray CollectTransitions(FConstStructView Event);
-    FTransitionIndexArray RemoveConflictingTransitions(const FTransitionIndexArray& Transitions);
 
-    void CollectStatesToExit(const FTransitionIndexArray& Transitions, FStateIndexArray& OutStatesToExit) const;
-    void CollectStatesToEnter(const FTransitionIndexArray& Transitions, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const;
-    void AddDescendantStatesToEnter(FIndex StateIndex, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const;
-    void AddAncestorStatesToEnter(FIndex StateIndex, FIndex AncestorIndex, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const;
+    /* Collects transitions for FStateChartGenericEvent with given tag. Event may be empty, it is created only if any Condition needs it */
+    FTransitionIndexArray CollectTagTransitions(const FGameplayTag& EventTag, FConstStructView Event);
+
+    /* Collects enabled eventless transitions. If bOnlyDirty is set, only transitions marked in DirtyTransitions are evaluated */
+    FTransitionIndexArray CollectEventlessTransitions(bool bOnlyDirty = false);
+
+    /* Returns transition that scheduled Timeout, if it is still pending and its Conditions pass */
+    FTransitionIndexArray CollectTimeoutTransition(const FStateChartTimeoutEvent& Timeout, FConstStructView Event);
+
+    /* Starts timers of timed transitions of entered state and cancels them when it exits */
+    void ScheduleTimeouts(FIndex StateIndex);
+    void CancelTimeouts(FIndex StateIndex);
+    void CancelAllTimers();
+
+    /* Returns index in TimeoutTimers of given timed transition, or INDEX_NONE if none was scheduled yet */
+    int32 FindTimeoutSlot(FIndex TransitionIndex) const;
+
+    /* Adds or removes interest of event bus in event types and tags of transitions of given state */
+    void UpdateEventInterest(FIndex StateIndex, int32 Delta);
+
+    /* Tells event bus whether this executor has queued events or running plan, which may need events regardless of active states */
+    void UpdateBusyInterest();
 
-    FIndex GetTransitionDomain(const FTransitionNode& Transition) const;
-    FStateIndexArray GetTransitionEffectiveTargets(const FTransitionNode& Transition) const;
-    FIndex FindLeastCommonCompoundAncestor(FIndex BaseIndex, const FStateIndexArray& States) const;
-    bool IsDescendant(FIndex Child, FIndex Parent) const;
+    void InvalidateTransition(FIndex TransitionIndex);
+    void ClearDirtyTransitions();
 
-    void ForEachParent(FIndex StateIndex, TFunctionRef<bool(FIndex, const FStateNode&)> Action) const;
-    void ForEachChild(FIndex StateIndex, TFunctionRef<bool(FIndex, const FStateNode&)> Action) const;
+    template <typename TFindTransition>
+    FTransitionIndexArray CollectActiveTransitions(TFindTransition&& FindTransition);
+
+    /* Returns solver over current active states and recorded history */
+    TStateChartSolver<Features> GetSolver() const { return TStateChartSolver<Features>(*Nodes, ActiveStates, HistoryStorage); }
 
     EActionContinuationType ExecuteAsyncActionList(TArray<FInstancedStruct>& ActionList, EActionContinuationType ExistingResult);
-    EActionContinuationType ExecuteAsyncAction(TFunctionRef<EActionContinuationType()> Action, EActionContinuationType ExistingResult);
-    bool EvaluateConditions(const FTransitionNode& TransitionNode, FConstStructView Event) const;
+    EActionContinuationType ExecuteAsyncAction(TFunctionRef<EActionContinuationType()> Action, EActionContinuationType ExistingResult, float Timeout = 0.f);
+    bool EvaluateConditions(const FTransitionNode& TransitionNode, FConstStructView Event);
+    bool EvaluateCondition(const FInstancedStruct& Struct, FIndex GuardID, FConstStructView Event);
+
+    /* Invalidates cached results of pure conditions. Called once per event */
+    void ResetGuardResults();
 
     TObjectPtr<UStateChartAsset> Asset;
     FStateChartExecutionContext Context;
-    FHandlerCreated StateHandlerCreatedDelegate;
+
+    // slot in FStateChartExecutorRegistry, which reports references of this executor
+    int32 RegistrySlot = INDEX_NONE;
+
+    // created on first subscription, most executors never have one
+    TUniquePtr<FHandlerCreated> StateHandlerCreatedDelegate;
 
     const FStateChartNodes* Nodes;
 
+    FInstancedPropertyBag Datamodel;
+    bool bRaiseDatamodelEvents = false;
+
     // all active states
     TArray<FIndex> ActiveStates;
 
-    TMap<FIndex, FStateIndexArray> HistoryLookup;
-    TMultiMap<FIndex, TObjectPtr<UStateHandler>> StateHandlers;
+    // bitset of ActiveStates, maintained only when asset has history states
+    TArray<uint32> ActiveStateBits;
+
+    // recorded value of every slot of HistoryTable. Single child slots hold child index plus one. Allocated on first record
+    TArray<uint32> HistoryStorage;
+
+    // instances of StateHandlers of active states, at slots given by HandlerTable. Allocated on first entry into state with handlers
+    TArray<TObjectPtr<UStateHandler>> StateHandlers;
+
+    TSharedPtr<FStateChartTimerWheel> TimerWheel;
+
+    // pending timer of every timed transition, in order of TimedTransitions of the asset
+    TArray<FStateChartTimerHandle> TimeoutTimers;
+    TSparseArray<FDelayedEvent> DelayedEvents;
+    FStateChartTimerHandle ActionTimeoutTimer;
+
+    TSharedPtr<FStateChartEventBus> EventBus;
+
+    // number of active states having transitions on each event type. Bus is notified when it changes from or to zero
+    TArray<TPair<const UScriptStruct*, int32>> EventInterest;
+
+    // same for event tags of transitions on FStateChartGenericEvent
+    TArray<TPair<FGameplayTag, int32>> TagInterest;
 
-    TRingBuffer<FInstancedStruct, TInlineAllocator<8>> ExternalEventQueue;
-    TRingBuffer<FInstancedStruct, TInlineAllocator<8>> InternalEventQueue;
+    // whether bus was last told this executor is busy
+    bool bBusyOnEventBus = false;
 
-    FExecutionPlan CurrentPlan;
+    // external events are bounded by queue policies of the asset. internal ones are never dropped
+    FStateChartEventQueue ExternalEventQueue;
+    FStateChartEventQueue InternalEventQueue;
+
+    // results of pure conditions evaluated for current event
+    TArray<FGuardResult> GuardResults;
+    uint32 GuardEpoch = 0;
+
+    // set while bExecutingPlan is set
+    TUniquePtr<FExecutionPlan> CurrentPlan;
+    uint16 CurrentPlanIndex = 0;
     bool bExecutingPlan = false;
 
+    FStateChartExecutorStats Stats;
+    int32 MacrostepMicrosteps = 0;
+    int32 MacrostepEventlessMicrosteps = 0;
+
+    // eventless transitions whose dependencies changed since last evaluation
+    TBitArray<> DirtyTransitions;
+    bool bHasDirtyTransitions = false;
+
+    // eventless transitions may still be enabled, because last macrostep hit the limit
+    bool bEventlessPending = false;
+
+    // external events are processed by Pump only
+    bool bDeferEvents = false;
+    EStateChartSignificance Significance = EStateChartSignificance::High;
+
+    // limits of current Pump call
+    bool bPumping = false;
+    int32 PumpMacrostepsLeft = 0;
+    double PumpDeadline = 0.0;
+
     bool bInsideExecutionLoop = false;
     bool bLastActionExecutedSynchronously = false;
     bool bInsideActionExecution = false;
 };
 
+/* Executor supporting all features. It may run any StateChart */
+using FStateChartDefaultExecutor = TStateChartExecutor<EStateChartFeatures::All>;
+
+extern template class DRUSTATECHART_API TStateChartExecutor<EStateChartFeatures::All>;
+
+/*
+ * Creates executor specialized for features used by given StateChart.
+ * Features required by StateChart are always added to RequestedFeatures
+ */
+DRUSTATECHART_API TSharedRef<IStateChartExecutor> CreateSpecializedExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject, EStateChartFeatures RequestedFeatures = EStateChartFeatures::None);
+
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "InstancedStruct.h"
+#include "GameplayTagContainer.h"
 #include "StateChartTypes.h"
 #include "StateChartElements.generated.h"
 
@@ -16,6 +17,12 @@ public:
     {
         return !GetPackage()->HasAnyFlags(RF_Transient) && !HasAnyFlags(RF_Transient | RF_ClassDefaultObject);
     }
+
+#if WITH_EDITOR
+protected:
+    /* Notifies owning StateChart that this element was edited */
+    void NotifyOwner(EStateChartElementChange Change);
+#endif
 };
 
 UCLASS(EditInlineNew, DefaultToInstanced)
@@ -36,6 +43,18 @@ public:
     UPROPERTY(EditAnywhere)
     TObjectPtr<UScriptStruct> EventID;
 
+    /* When set, transition is triggered by FStateChartGenericEvent with this tag or any of its child tags. EventID is ignored */
+    UPROPERTY(EditAnywhere)
+    FGameplayTag EventTag;
+
+    /* Only FStateChartGenericEvent with exactly the same tag triggers transition */
+    UPROPERTY(EditAnywhere)
+    bool bMatchTagExact = false;
+
+    /* When positive, transition is taken after its source state was active for this many seconds. EventID and EventTag are ignored */
+    UPROPERTY(EditAnywhere, meta = (ClampMin = 0, Units = "s"))
+    float Delay = 0.f;
+
     UPROPERTY(EditAnywhere)
     TArray<FGuid> TargetStates;
 
@@ -44,6 +63,13 @@ public:
 
     UPROPERTY(EditAnywhere, meta = (BaseStruct = "/Script/DruStateChart.StateChartAction"))
     TArray<FInstancedStruct> Actions;
+
+    /* Returns type of event that triggers this transition */
+    UScriptStruct* GetTriggerEventType() const;
+
+#if WITH_EDITOR
+    void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 };
 
 
@@ -61,6 +87,10 @@ public:
 
     UPROPERTY(EditAnywhere, Category = "State")
     FString FriendlyName;
+
+#if WITH_EDITOR
+    void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 };
 
 UCLASS()
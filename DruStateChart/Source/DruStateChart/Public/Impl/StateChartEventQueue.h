@@ -0,0 +1,248 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "StateChartTypes.h"
+#include "Containers/RingBuffer.h"
+#include "GameplayTagContainer.h"
+#include "InstancedStruct.h"
+#include "StructView.h"
+
+namespace DruStateChart_Impl
+{
+    /*
+     * Queue of pending events.
+     * Tag events are stored as a tag only, struct events keep their payload in a separate ring.
+     * Invalid tag in Order marks position of struct event.
+     * Queue is unbounded unless SetPolicy is called.
+     * Nothing but type policies is allocated until first event is queued, so idle executors stay small
+     */
+    class FStateChartEventQueue
+    {
+    public:
+        /* Capacity and Overflow apply to all events. TypePolicies apply to events of matching type, they are copied */
+        void SetPolicy(int32 InCapacity, EStateChartQueueOverflow InOverflow, TConstArrayView<FStateChartEventQueuePolicy> InTypePolicies)
+        {
+            check(IsEmpty());
+
+            Capacity = InCapacity;
+            Overflow = InOverflow;
+            TypePolicies.Reset();
+            TypePolicies.Append(InTypePolicies.GetData(), InTypePolicies.Num());
+            TypeCounts.SetNumZeroed(TypePolicies.Num());
+        }
+
+        /* Returns false if event was dropped because queue is full */
+        bool Enqueue(FConstStructView Event)
+        {
+            const int32 PolicyIndex = FindTypePolicy(Event.GetScriptStruct());
+            if (PolicyIndex != INDEX_NONE)
+            {
+                const FStateChartEventQueuePolicy& Policy = TypePolicies[PolicyIndex];
+
+                if (Policy.bCoalesce && TypeCounts[PolicyIndex] != 0)
+                {
+                    // only latest value matters, it takes place of queued one
+                    Payloads[FindPayload(Event.GetScriptStruct(), false)] = FInstancedStruct(Event);
+                    NumCoalesced += 1;
+                    return true;
+                }
+
+                if (Policy.Capacity > 0 && TypeCounts[PolicyIndex] >= Policy.Capacity)
+                {
+                    NumDropped += 1;
+
+                    if (Policy.Overflow == EStateChartQueueOverflow::DropNewest)
+                    {
+                        return false;
+                    }
+
+                    RemovePayload(FindPayload(Event.GetScriptStruct(), true));
+                }
+            }
+
+            if (!MakeRoom())
+            {
+                return false;
+            }
+
+            Order.Add(FGameplayTag());
+            Payloads.Emplace(Event);
+
+            if (PolicyIndex != INDEX_NONE)
+            {
+                TypeCounts[PolicyIndex] += 1;
+            }
+
+            MaxNum = FMath::Max(MaxNum, Order.Num());
+            return true;
+        }
+
+        /* Returns false if event was dropped because queue is full */
+        bool EnqueueTag(const FGameplayTag& EventTag)
+        {
+            check(EventTag.IsValid());
+
+            if (!MakeRoom())
+            {
+                return false;
+            }
+
+            Order.Add(EventTag);
+
+            MaxNum = FMath::Max(MaxNum, Order.Num());
+            return true;
+        }
+
+        /* Removes first event from the queue. OutEventTag is set for tag events, OutEvent is set otherwise */
+        bool Dequeue(FGameplayTag& OutEventTag, FInstancedStruct& OutEvent)
+        {
+            if (Order.IsEmpty())
+            {
+                return false;
+            }
+
+            OutEventTag = Order.PopFrontValue();
+
+            if (!OutEventTag.IsValid())
+            {
+                OutEvent = Payloads.PopFrontValue();
+                OnPayloadRemoved(OutEvent.GetScriptStruct());
+            }
+
+            return true;
+        }
+
+        /* Returns true if events of given type must not wait for scheduler */
+        bool IsCritical(const UScriptStruct* EventType) const
+        {
+            const int32 PolicyIndex = FindTypePolicy(EventType);
+            return PolicyIndex != INDEX_NONE && TypePolicies[PolicyIndex].bCritical;
+        }
+
+        /* Discards all events. Allocations are kept */
+        void Reset()
+        {
+            Order.Reset();
+            Payloads.Reset();
+
+            for (int32& Count : TypeCounts)
+            {
+                Count = 0;
+            }
+        }
+
+        void ResetStats()
+        {
+            MaxNum = 0;
+            NumDropped = 0;
+            NumCoalesced = 0;
+        }
+
+        int32 Num() const { return Order.Num(); }
+        bool IsEmpty() const { return Order.IsEmpty(); }
+
+        /* Largest number of events ever queued at once */
+        int32 GetMaxNum() const { return MaxNum; }
+        int32 GetNumDropped() const { return NumDropped; }
+        int32 GetNumCoalesced() const { return NumCoalesced; }
+
+        void AddStructReferencedObjects(FReferenceCollector& Collector)
+        {
+            for (FInstancedStruct& Event : Payloads)
+            {
+                Event.AddStructReferencedObjects(Collector);
+            }
+        }
+
+    private:
+        /* Discards oldest event if queue is full and policy allows it. Returns false if incoming event must be dropped instead */
+        bool MakeRoom()
+        {
+            if (Capacity <= 0 || Order.Num() < Capacity)
+            {
+                return true;
+            }
+
+            NumDropped += 1;
+
+            if (Overflow == EStateChartQueueOverflow::DropNewest)
+            {
+                return false;
+            }
+
+            if (!Order.PopFrontValue().IsValid())
+            {
+                OnPayloadRemoved(Payloads.PopFrontValue().GetScriptStruct());
+            }
+
+            return true;
+        }
+
+        int32 FindTypePolicy(const UScriptStruct* EventType) const
+        {
+            return TypePolicies.IndexOfByPredicate([&](const FStateChartEventQueuePolicy& Policy) { return Policy.EventType == EventType; });
+        }
+
+        /* Returns index of first or last queued payload of given type */
+        int32 FindPayload(const UScriptStruct* EventType, bool bFirst) const
+        {
+            for (int32 Index = 0; Index < Payloads.Num(); ++Index)
+            {
+                const int32 PayloadIndex = bFirst ? Index : Payloads.Num() - 1 - Index;
+                if (Payloads[PayloadIndex].GetScriptStruct() == EventType)
+                {
+                    return PayloadIndex;
+                }
+            }
+
+            checkNoEntry();
+            return INDEX_NONE;
+        }
+
+        /* Removes payload from the middle of the queue together with its position in Order */
+        void RemovePayload(int32 PayloadIndex)
+        {
+            int32 NumStructEvents = 0;
+            for (int32 OrderIndex = 0; OrderIndex < Order.Num(); ++OrderIndex)
+            {
+                if (!Order[OrderIndex].IsValid() && NumStructEvents++ == PayloadIndex)
+                {
+                    Order.RemoveAt(OrderIndex);
+                    break;
+                }
+            }
+
+            OnPayloadRemoved(Payloads[PayloadIndex].GetScriptStruct());
+            Payloads.RemoveAt(PayloadIndex);
+        }
+
+        void OnPayloadRemoved(const UScriptStruct* EventType)
+        {
+            if (TypePolicies.Num() != 0)
+            {
+                const int32 PolicyIndex = FindTypePolicy(EventType);
+                if (PolicyIndex != INDEX_NONE)
+                {
+                    TypeCounts[PolicyIndex] -= 1;
+                }
+            }
+        }
+
+        TRingBuffer<FGameplayTag> Order;
+        TRingBuffer<FInstancedStruct> Payloads;
+
+        int32 Capacity = 0;
+        EStateChartQueueOverflow Overflow = EStateChartQueueOverflow::DropNewest;
+
+        // copied, because asset may be edited while executor runs. Empty for most assets, so nothing is allocated
+        TArray<FStateChartEventQueuePolicy> TypePolicies;
+
+        // number of queued events of each type with a policy
+        TArray<int32> TypeCounts;
+
+        int32 MaxNum = 0;
+        int32 NumDropped = 0;
+        int32 NumCoalesced = 0;
+    };
+}
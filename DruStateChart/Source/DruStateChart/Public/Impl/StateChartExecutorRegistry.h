@@ -0,0 +1,66 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/GCObject.h"
+#include "UObject/ObjectPtr.h"
+#include "Containers/SparseArray.h"
+#include "Templates/UniquePtr.h"
+
+class IStateChartExecutor;
+class UStateChartAsset;
+
+namespace DruStateChart_Impl
+{
+    /*
+     * Reports references of all executors to garbage collector from a single FGCObject.
+     * Collection visits one referencer in one pass instead of one referencer per executor.
+     * Assets are reported once for all executors running them, executors report only references they own.
+     * Executors are added on construction and removed on destruction, both on game thread.
+     * Instance is owned by DruStateChart module, so it is released while garbage collector still exists
+     */
+    class DRUSTATECHART_API FStateChartExecutorRegistry : public FGCObject
+    {
+    public:
+        static FStateChartExecutorRegistry& Get();
+
+        /* Returns nullptr after module shutdown */
+        static FStateChartExecutorRegistry* TryGet();
+
+        /* Called by module */
+        static void Startup();
+        static void Shutdown();
+
+        /* Returns slot that must be passed to Remove */
+        int32 Add(IStateChartExecutor& Executor, UStateChartAsset& Asset);
+        void Remove(int32 Slot);
+
+        int32 GetNumExecutors() const { return Executors.Num(); }
+        int32 GetNumAssets() const { return Assets.Num(); }
+
+        // Begin FGCObject overrides
+        void AddReferencedObjects(FReferenceCollector& Collector) override;
+        FString GetReferencerName() const override;
+        //~End FGCObject overrides
+
+    private:
+        struct FExecutorEntry
+        {
+            IStateChartExecutor* Executor;
+            int32 AssetIndex;
+        };
+
+        struct FAssetEntry
+        {
+            TObjectPtr<UStateChartAsset> Asset;
+            int32 NumExecutors;
+        };
+
+        TSparseArray<FExecutorEntry> Executors;
+
+        // distinct assets of registered executors. few of them exist, so lookup is a linear scan
+        TSparseArray<FAssetEntry> Assets;
+
+        static TUniquePtr<FStateChartExecutorRegistry> Instance;
+    };
+}
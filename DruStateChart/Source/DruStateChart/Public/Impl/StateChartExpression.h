@@ -0,0 +1,89 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "UObject/NameTypes.h"
+
+class UStruct;
+
+namespace DruStateChart_Impl
+{
+    /*
+     * Boolean expression compiled into bytecode of a small register machine.
+     * Supports bool, float, double, int32 and uint8 properties of context type, numeric literals, true and false,
+     * arithmetic (+ - * /), comparisons (< <= > >= == !=), logical operators (! && ||) and parentheses.
+     * Members of struct properties are accessed with '.'.
+     *
+     * Property offsets are resolved during compilation, so evaluation only reads memory at fixed offsets.
+     * Example: "Health < 0.3 && bHasAmmo"
+     */
+    class DRUSTATECHART_API FStateChartExpression
+    {
+    public:
+        /* Compiles Source against properties of ContextType. Returns false and fills OutError if Source is invalid */
+        bool Compile(const FString& Source, const UStruct& ContextType, FString& OutError);
+
+        /* Evaluates expression over memory of ContextType instance. Must be compiled */
+        bool Evaluate(const void* ContextData) const;
+
+        bool IsCompiled() const { return Instructions.Num() != 0; }
+
+        const UStruct* GetContextType() const { return ContextType; }
+
+        int32 GetNumInstructions() const { return Instructions.Num(); }
+
+        /* Returns names of top level properties of context type read by expression */
+        const TArray<FName>& GetReferencedProperties() const { return ReferencedProperties; }
+
+        /* Limits nesting depth of expressions */
+        static constexpr int32 MaxRegisters = 16;
+
+    private:
+        friend class FStateChartExpressionCompiler;
+
+        enum class EOpCode : uint8
+        {
+            LoadConstant,   // Target = Constants[Operand]
+            LoadBool,       // Target = (Data[Operand >> 8] & (Operand & 0xff)) != 0
+            LoadFloat,      // Target = *(float*)(Data + Operand)
+            LoadDouble,     // Target = *(double*)(Data + Operand)
+            LoadInt,        // Target = *(int32*)(Data + Operand)
+            LoadByte,       // Target = *(uint8*)(Data + Operand)
+
+            Add,            // Target = A + B
+            Subtract,
+            Multiply,
+            Divide,
+            Negate,         // Target = -A
+            Not,            // Target = !A
+            ToBool,         // Target = A != 0
+
+            Less,           // Target = A < B
+            LessEqual,
+            Greater,
+            GreaterEqual,
+            Equal,
+            NotEqual,
+
+            JumpIfFalse,    // if (!A) jump to Operand
+            JumpIfTrue,     // if (A) jump to Operand
+        };
+
+        /* Target, A and B are always valid register indexes, even for instructions that do not read A or B */
+        struct FInstruction
+        {
+            EOpCode OpCode;
+            uint8 Target;
+            uint8 A;
+            uint8 B;
+            uint32 Operand;
+        };
+
+        TArray<FInstruction> Instructions;
+        TArray<double> Constants;
+        TArray<FName> ReferencedProperties;
+        const UStruct* ContextType = nullptr;
+    };
+}
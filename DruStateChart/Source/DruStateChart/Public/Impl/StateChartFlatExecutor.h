@@ -0,0 +1,86 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Interfaces/IStateChartExecutor.h"
+#include "Impl/StateChartExecutorRegistry.h"
+#include "StateChartTypes.h"
+#include "Impl/StateChartEventQueue.h"
+#include "Impl/StateChartFlatTable.h"
+#include "StateChartEventBus.h"
+#include "UObject/ObjectPtr.h"
+#include "InstancedStruct.h"
+#include "PropertyBag.h"
+#include "StructView.h"
+
+namespace DruStateChart_Impl
+{
+
+/*
+ * Executor that runs precompiled FStateChartFlatTable. Every event is processed with a single table lookup.
+ * All actions are expected to complete synchronously
+ */
+class DRUSTATECHART_API FStateChartFlatExecutor : public IStateChartExecutor
+{
+public:
+    FStateChartFlatExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject = nullptr);
+    ~FStateChartFlatExecutor();
+
+    TObjectPtr<UStateChartAsset> GetExecutingAsset() const override { return Asset; }
+    TObjectPtr<UObject> GetContextObject() const override { return Context.ContextObject; }
+    void Execute() override;
+    void Stop() override;
+    void Reset(TObjectPtr<UObject> ContextObject = nullptr) override;
+    TArray<TObjectPtr<UBaseStateDefinition>> GetActiveStates() const override;
+    FHandlerCreated& OnStateHandlerCreated() override;
+    FStructView GetDatamodel() override { return Context.Datamodel; }
+    void NotifyDatamodelChanged(FName VariableName) override;
+    void SetDeferredProcessing(bool bDeferred) override { bDeferEvents = bDeferred; }
+    int32 Pump(int32 MaxMacrosteps, double MaxSeconds = 0.0) override;
+    int32 GetNumQueuedEvents() const override { return EventQueue.Num(); }
+    void SetSignificance(EStateChartSignificance InSignificance) override { Significance = InSignificance; }
+    EStateChartSignificance GetSignificance() const override { return Significance; }
+
+    /* Events raised by actions share the queue with external ones, so only external queue stats are filled */
+    FStateChartExecutorStats GetStats() const override;
+
+    /* Executor subscribes to all event types of the StateChart, because its configurations are not tracked per state */
+    void SetEventBus(TSharedPtr<FStateChartEventBus> InEventBus) override;
+
+    void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+    void ExecuteEventImpl(FConstStructView Event) override;
+
+    /* Processes queued events until MaxEvents of them were processed or Deadline is reached. Returns number of processed events */
+    int32 ProcessQueuedEvents(int32 MaxEvents = MAX_int32, double Deadline = 0.0);
+    void ApplyEntry(const FStateChartFlatTable::FEntry& Entry);
+
+    TObjectPtr<UStateChartAsset> Asset;
+    FStateChartExecutionContext Context;
+
+    // slot in FStateChartExecutorRegistry, which reports references of this executor
+    int32 RegistrySlot = INDEX_NONE;
+
+    // flat tables have no StateHandlers, so it is never broadcast. Created only to satisfy subscribers
+    TUniquePtr<FHandlerCreated> StateHandlerCreatedDelegate;
+
+    const FStateChartNodes* Nodes;
+    const FStateChartFlatTable* Table;
+
+    FInstancedPropertyBag Datamodel;
+    bool bRaiseDatamodelEvents = false;
+
+    int32 CurrentConfiguration = INDEX_NONE;
+
+    TSharedPtr<FStateChartEventBus> EventBus;
+
+    FStateChartEventQueue EventQueue;
+    bool bProcessingEvents = false;
+
+    // external events are processed by Pump only
+    bool bDeferEvents = false;
+    EStateChartSignificance Significance = EStateChartSignificance::High;
+};
+
+}
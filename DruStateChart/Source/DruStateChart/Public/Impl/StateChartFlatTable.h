@@ -0,0 +1,60 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Impl/StateChartNodes.h"
+
+class UStateChartAsset;
+class UScriptStruct;
+struct FInstancedStruct;
+
+namespace DruStateChart_Impl
+{
+    /*
+     * Precompiled table of all reachable configurations of a StateChart.
+     * Maps (configuration, event type) pair to next configuration and list of actions to execute. Event types that trigger the same transitions share a column.
+     * Only StateCharts without History states, StateHandlers, Conditions, tag triggers and asynchronous Actions can be compiled
+     */
+    struct DRUSTATECHART_API FStateChartFlatTable
+    {
+        struct FEntry
+        {
+            int32 NextConfiguration = INDEX_NONE;
+            int32 ActionIndex = 0;
+            int32 NumActions = 0;
+        };
+
+        /* Tries to compile table for given asset. Returns false if asset is not eligible or has more than MaxConfigurations reachable configurations */
+        bool Compile(UStateChartAsset& Asset, int32 MaxConfigurations);
+
+        void Reset();
+
+        bool IsValid() const { return InitialConfiguration != INDEX_NONE; }
+
+        /* Returns entry for given configuration and event type. Returns null if no transition is taken */
+        const FEntry* FindEntry(int32 Configuration, const UScriptStruct* EventType) const;
+
+        /* Returns states that are active in given configuration */
+        TArrayView<const FIndex> GetConfigurationStates(int32 Configuration) const;
+
+        int32 NumConfigurations() const { return ConfigurationOffsets.Num() - 1; }
+
+        int32 InitialConfiguration = INDEX_NONE;
+        FEntry InitialEntry;
+
+        TArray<FIndex> ConfigurationStates;
+        TArray<int32> ConfigurationOffsets;
+
+        /* Event types with their columns. Types not found here and among their parents use last column */
+        TMap<const UScriptStruct*, int32> EventToColumn;
+        TArray<const UScriptStruct*> ColumnEventTypes;
+        TArray<FEntry> Entries;
+
+        TArray<FInstancedStruct*> Actions;
+
+    private:
+        static bool IsEligible(const FStateChartNodes& Nodes);
+    };
+}
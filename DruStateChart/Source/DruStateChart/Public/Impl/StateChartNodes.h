@@ -4,6 +4,8 @@
 
 #include "Containers/Array.h"
 #include "Containers/Map.h"
+#include "Misc/EnumClassFlags.h"
+#include "GameplayTagContainer.h"
 
 class UBaseStateDefinition;
 class UTransitionDefinition;
@@ -19,6 +21,20 @@ namespace DruStateChart_Impl
         History,
     };
 
+    /* Optional parts of execution algorithm used by StateChart. Executor compiles out paths for features that are not used */
+    enum class EStateChartFeatures : uint8
+    {
+        None = 0,
+        History = 1 << 0,
+        Parallel = 1 << 1,
+        Handlers = 1 << 2,
+        AsyncActions = 1 << 3,
+        Conditions = 1 << 4,
+
+        All = History | Parallel | Handlers | AsyncActions | Conditions,
+    };
+    ENUM_CLASS_FLAGS(EStateChartFeatures)
+
     struct DRUSTATECHART_API FIndex
     {
         static const FIndex None;
@@ -90,40 +106,247 @@ namespace DruStateChart_Impl
 
     struct DRUSTATECHART_API FTransitionNode
     {
-        FTransitionNode(FIndex InSourceNodeIndex, UScriptStruct* InEventID, UTransitionDefinition* InDefinition)
+        FTransitionNode(FIndex InSourceNodeIndex, FIndex InInputOrder, UScriptStruct* InEventID, UTransitionDefinition* InDefinition)
             : SourceNodeIndex(InSourceNodeIndex)
+            , InputOrder(InInputOrder)
             , EventID(InEventID)
             , Definition(InDefinition)
         {}
 
         FIndex SourceNodeIndex;
 
+        /* Relative position of Definition in input array. Orders transitions with equal SortOrder like stable sort of full rebuild does */
+        FIndex InputOrder;
+
         UScriptStruct* EventID;
         UTransitionDefinition* Definition;
     };
 
+    /*
+     * Transitions triggered by FStateChartGenericEvent, indexed by event tag.
+     * Every list is sorted by transition index, so transitions of each state occupy contiguous range
+     */
+    struct DRUSTATECHART_API FStateChartTagIndex
+    {
+        /* Returns transitions that may be triggered by event with given tag */
+        TArrayView<const FIndex> FindCandidates(const FGameplayTag& Tag) const;
+
+        void Reset();
+
+        bool HasTaggedTransitions() const { return ExactTagTransitions.Num() != 0; }
+
+        /* Candidates for events with exactly this tag */
+        TMap<FGameplayTag, TArray<FIndex>> ExactTagTransitions;
+
+        /* Candidates for events with child tag, which is not referenced by any transition */
+        TMap<FGameplayTag, TArray<FIndex>> DescendantTagTransitions;
+
+        /* Transitions without EventTag, including ones triggered by any event. They are included into every list above */
+        TArray<FIndex> UntaggedTransitions;
+    };
+
+    /*
+     * Transitions triggered by event types, indexed by every type that may trigger them.
+     * Candidates of a type include transitions on that type, on its parent types and FStateChartAnyEvent, sorted by transition index.
+     * Tag triggered transitions are handled by FStateChartTagIndex and are not included
+     */
+    struct DRUSTATECHART_API FStateChartEventTypeIndex
+    {
+        /* Returns transitions that may be triggered by event of given type */
+        TArrayView<const FIndex> FindCandidates(const UScriptStruct* EventType) const;
+
+        /* Returns index of list in CandidateLists for given type or INDEX_NONE if only AnyEventTransitions match it */
+        int32 FindListIndex(const UScriptStruct* EventType) const;
+
+        void Reset();
+
+        /* Maps event types referenced by transitions to CandidateLists. Derived types are resolved through their parents by FindListIndex */
+        TMap<const UScriptStruct*, int32> TypeToList;
+        TArray<TArray<FIndex>> CandidateLists;
+
+        /* Transitions triggered by any event. They are included into every list above */
+        TArray<FIndex> AnyEventTransitions;
+
+        /* Transitions without trigger event. Executor checks them after every microstep, only states that have them evaluate their Conditions */
+        TArray<FIndex> EventlessTransitions;
+
+        /* Transitions with Delay. Executor schedules them when their source state is entered */
+        TArray<FIndex> TimedTransitions;
+    };
+
+    /*
+     * Pure conditions of transitions, deduplicated by struct type and property values.
+     * Identical conditions share guard id, so executor may evaluate each of them once per event and reuse the result
+     */
+    struct DRUSTATECHART_API FStateChartGuardTable
+    {
+        /* Returns guard ids of Conditions of given transition, in the same order. Impure conditions have None id */
+        TArrayView<const FIndex> GetTransitionGuards(int32 TransitionIndex) const
+        {
+            const int32 Offset = TransitionOffsets[TransitionIndex];
+            return TArrayView<const FIndex>(GuardIDs.GetData() + Offset, TransitionOffsets[TransitionIndex + 1] - Offset);
+        }
+
+        void Reset();
+
+        /* Number of distinct guards */
+        int32 NumGuards = 0;
+
+        /* Range of GuardIDs for every transition. Has one extra element at the end */
+        TArray<int32> TransitionOffsets;
+        TArray<FIndex> GuardIDs;
+    };
+
+    /*
+     * Eventless transitions indexed by values their Conditions depend on.
+     * Executor re-evaluates them on Update only after one of those values changes
+     */
+    struct DRUSTATECHART_API FStateChartDependencyIndex
+    {
+        void Reset();
+
+        /* Eventless transitions depending on each value */
+        TMap<FName, TArray<FIndex>> DependentTransitions;
+
+        /* Eventless transitions with Conditions that do not declare dependencies. They are re-evaluated on every Update */
+        TArray<FIndex> PollingTransitions;
+    };
+
+    /*
+     * Positions of StateHandlers of every state in flat handler array of executor.
+     * Handlers of each state occupy contiguous range, so executor writes them on entry and clears them on exit without lookups
+     */
+    struct DRUSTATECHART_API FStateChartHandlerTable
+    {
+        /* Returns first slot and number of slots of given state */
+        TPair<int32, int32> GetStateRange(int32 StateIndex) const
+        {
+            const int32 Offset = StateOffsets[StateIndex];
+            return { Offset, StateOffsets[StateIndex + 1] - Offset };
+        }
+
+        void Reset();
+
+        /* Total number of handlers of all states */
+        int32 NumHandlers = 0;
+
+        /* Range of handler slots for every state. Has one extra element at the end. Empty if StateChart has no handlers */
+        TArray<int32> StateOffsets;
+    };
+
+    /*
+     * Fixed storage layout of history states.
+     * Shallow history of compound state records one word holding its active child.
+     * Deep history, and shallow history of parallel state, records window of active states bitset masked by states it remembers
+     */
+    struct DRUSTATECHART_API FStateChartHistoryTable
+    {
+        struct FSlot
+        {
+            FIndex StateIndex;
+            FIndex ParentIndex;
+
+            /* Number of words of active states bitset containing remembered states. Zero for single child slots */
+            int32 NumWords = 0;
+
+            /* Position of remembered states masks in Masks and MaskWords, and of recorded value in storage of executor */
+            int32 MaskOffset = 0;
+            int32 StorageOffset = 0;
+
+            /* Slot records index of single active child instead of masks */
+            bool bSingleChild = false;
+
+            bool IsSingleChild() const { return bSingleChild; }
+        };
+
+        /* Returns slot of given history state or nullptr */
+        const FSlot* FindSlot(FIndex StateIndex) const;
+
+        void Reset();
+
+        /* Sorted by StateIndex */
+        TArray<FSlot> Slots;
+
+        /* Remembered states of each slot, one entry per word of active states bitset that contains any of them */
+        TArray<uint32> Masks;
+        TArray<int32> MaskWords;
+
+        /* Number of words executor needs to record all slots */
+        int32 NumStorageWords = 0;
+    };
+
     struct DRUSTATECHART_API FStateChartNodes
     {
         void CreateNodes(const TArray<TObjectPtr<UBaseStateDefinition>>& States, const TArray<TObjectPtr<UTransitionDefinition>>& Transitions);
 
+        /*
+         * Incremental updates used by editor. They patch only affected ranges of nodes instead of rebuilding everything.
+         * Each returns false if change cannot be applied in place. Nodes must be fully rebuilt in that case
+         */
+        bool InsertTransition(UTransitionDefinition& Transition);
+        bool RemoveTransition(UTransitionDefinition& Transition);
+        bool UpdateTransition(UTransitionDefinition& Transition);
+        bool InsertLeafState(UBaseStateDefinition& State);
+        bool ReparentState(UBaseStateDefinition& State);
+
+        /* Returns true if both node trees have identical layout. Used to verify incremental updates */
+        bool IsEquivalent(const FStateChartNodes& Other, FString* OutDifference = nullptr) const;
+
+        /* Recomputes Features from current nodes. Called by CreateNodes, must be called after incremental updates */
+        void UpdateFeatures();
+
+        /* Rebuilds TagIndex from current nodes. Called by CreateNodes, must be called after incremental updates */
+        void BuildTagIndex();
+
+        /* Rebuilds EventTypeIndex from current nodes. Called by CreateNodes, must be called after incremental updates */
+        void BuildEventTypeIndex();
+
+        /* Rebuilds DependencyIndex from current nodes and EventTypeIndex. Called by CreateNodes, must be called after incremental updates */
+        void BuildDependencyIndex();
+
+        /* Rebuilds GuardTable from current nodes. Called by CreateNodes, must be called after incremental updates and edits of Conditions */
+        void BuildGuardTable();
+
+        /* Rebuilds HandlerTable from current nodes. Called by CreateNodes, must be called after incremental updates and edits of Handlers */
+        void BuildHandlerTable();
+
+        /* Rebuilds HistoryTable from current nodes. Called by CreateNodes, must be called after incremental updates and edits of HistoryType */
+        void BuildHistoryTable();
+
         TArray<FStateNode> StateNodes;
         TArray<FTransitionNode> TransitionNodes;
 
         TMap<FGuid, FIndex> StateIDToNodeIndex;
         TMap<FGuid, TObjectPtr<UBaseStateDefinition>> StateIDToDefinition;
 
+        EStateChartFeatures Features = EStateChartFeatures::All;
+
+        FStateChartTagIndex TagIndex;
+        FStateChartEventTypeIndex EventTypeIndex;
+        FStateChartDependencyIndex DependencyIndex;
+        FStateChartGuardTable GuardTable;
+        FStateChartHandlerTable HandlerTable;
+        FStateChartHistoryTable HistoryTable;
+
     private:
+        /* Lays out states level by level, so children of every state occupy contiguous range and parents always precede their children */
         void CreateStateNodes(const TArray<TObjectPtr<UBaseStateDefinition>>& States);
-        void SortStateNodes();
-        void UpdateHierarchyReferences();
         void MarkAtomicStates();
 
+        /* Groups transitions by their source state, so transitions of every state occupy contiguous range */
         void CreateTransitionNodes(const TArray<TObjectPtr<UTransitionDefinition>>& Transitions);
-        void SortTransitionNodes();
         void UpdateTransitions();
 
+        bool InsertTransitionNode(UTransitionDefinition& Transition, FIndex InputOrder);
+        bool RemoveTransitionAt(int32 TransitionIndex);
+        bool RemoveLeafStateAt(int32 StateIndex);
+        bool IsTransitionInOrder(int32 TransitionIndex) const;
+        void ShiftStateIndexes(int32 FirstIndex, int32 Delta);
+
         EStateType GetStateType(TObjectPtr<UBaseStateDefinition> Definition) const;
-        bool CompareStates(UBaseStateDefinition* AState, UBaseStateDefinition* BState) const;
+        static bool CompareSiblingStates(const UBaseStateDefinition& AState, const UBaseStateDefinition& BState);
+        static bool CompareSiblingTransitions(const UTransitionDefinition& ATransition, const UTransitionDefinition& BTransition);
+        static bool CompareSiblingTransitionNodes(const FTransitionNode& ANode, const FTransitionNode& BNode);
     };
 }
 
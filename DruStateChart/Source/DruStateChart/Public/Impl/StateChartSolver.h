@@ -0,0 +1,444 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Impl/StateChartNodes.h"
+#include "Impl/StateChartElements.h"
+#include "Algo/AllOf.h"
+#include "Algo/AnyOf.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Transform.h"
+#include "Templates/Function.h"
+
+namespace DruStateChart_Impl
+{
+    class FStateIndexArray : public TArray<FIndex, TInlineAllocator<24>> {};
+    class FTransitionIndexArray : public TArray<FIndex, TInlineAllocator<24>> {};
+
+    /* Returns first candidate transition of given state accepted by Predicate. Candidates must be sorted by transition index */
+    template <typename TPredicate>
+    FIndex FindStateCandidate(const FStateChartNodes& Nodes, TArrayView<const FIndex> Candidates, const FStateNode& Node, TPredicate&& Predicate)
+    {
+        // transitions of each state form contiguous range
+        const int32 RangeEnd = Node.TransitionIndex + Node.NumTransitions;
+
+        for (int32 CandidateIndex = Algo::LowerBound(Candidates, Node.TransitionIndex); CandidateIndex < Candidates.Num() && int32(Candidates[CandidateIndex]) < RangeEnd; ++CandidateIndex)
+        {
+            if (Predicate(Nodes.TransitionNodes[Candidates[CandidateIndex]]))
+            {
+                return Candidates[CandidateIndex];
+            }
+        }
+
+        return FIndex::None;
+    }
+
+    /*
+     * Selects transitions and computes states they exit and enter for given active states, following SCXML algorithm.
+     * Works over nodes and views of executor data only, so default executor and flat table compiler share it without creating executors.
+     * Paths for features not present in Features are compiled out
+     */
+    template <EStateChartFeatures Features>
+    class TStateChartSolver
+    {
+    public:
+        static constexpr bool bHasHistory = EnumHasAnyFlags(Features, EStateChartFeatures::History);
+        static constexpr bool bHasParallel = EnumHasAnyFlags(Features, EStateChartFeatures::Parallel);
+
+        /* HistoryStorage holds recorded values of slots of HistoryTable and may be empty if nothing was recorded */
+        TStateChartSolver(const FStateChartNodes& InNodes, TConstArrayView<FIndex> InActiveStates, TConstArrayView<uint32> InHistoryStorage = TConstArrayView<uint32>())
+            : Nodes(InNodes)
+            , ActiveStates(InActiveStates)
+            , HistoryStorage(InHistoryStorage)
+        {}
+
+        /* Returns transitions found by FindTransition for active Atomic states and their ancestors, without conflicting ones */
+        template <typename TFindTransition>
+        FTransitionIndexArray CollectActiveTransitions(TFindTransition&& FindTransition) const
+        {
+            FTransitionIndexArray Result;
+
+            for (FIndex StateIndex : ActiveStates)
+            {
+                const FStateNode& StateNode = Nodes.StateNodes[StateIndex];
+                if (StateNode.Type != EStateType::Atomic)
+                {
+                    // iterate over Atomic nodes only
+                    continue;
+                }
+
+                auto CheckTransitions = [&](FIndex Index, const FStateNode& Node)
+                {
+                    const FIndex TransitionIndex = FindTransition(Node);
+                    if (!TransitionIndex.IsNone())
+                    {
+                        Result.Add(TransitionIndex);
+                        return false; // stop iteration, we found transition
+                    }
+
+                    // continue searching
+                    return true;
+                };
+
+                if (CheckTransitions(StateIndex, StateNode))
+                {
+                    ForEachParent(StateIndex, CheckTransitions);
+                }
+
+                if constexpr (!bHasParallel)
+                {
+                    // without parallel states only one Atomic state may be active
+                    break;
+                }
+            }
+
+            if constexpr (bHasParallel)
+            {
+                return RemoveConflictingTransitions(Result);
+            }
+            else
+            {
+                // single transition cannot conflict with anything
+                return Result;
+            }
+        }
+
+        FTransitionIndexArray RemoveConflictingTransitions(const FTransitionIndexArray& Transitions) const
+        {
+            FTransitionIndexArray Result;
+
+            for (FIndex TransitionIndex : Transitions)
+            {
+                bool bPreempted = false;
+                FTransitionIndexArray TransitionsToRemove;
+
+                for (FIndex SecondTransitionIndex : Result)
+                {
+                    FStateIndexArray States1;
+                    FStateIndexArray States2;
+
+                    CollectStatesToExit({ { TransitionIndex } }, States1);
+                    CollectStatesToExit({ { SecondTransitionIndex } }, States2);
+
+                    if (Algo::AnyOf(States1, [&](FIndex Index) { return States2.Contains(Index); }))
+                    {
+                        if (IsDescendant(Nodes.TransitionNodes[TransitionIndex].SourceNodeIndex, Nodes.TransitionNodes[SecondTransitionIndex].SourceNodeIndex))
+                        {
+                            TransitionsToRemove.AddUnique(SecondTransitionIndex);
+                        }
+                        else
+                        {
+                            bPreempted = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (!bPreempted)
+                {
+                    for (FIndex Index : TransitionsToRemove)
+                    {
+                        Result.Remove(Index);
+                    }
+
+                    Result.Add(TransitionIndex);
+                }
+            }
+
+            return Result;
+        }
+
+        void CollectStatesToExit(const FTransitionIndexArray& Transitions, FStateIndexArray& OutStatesToExit) const
+        {
+            for (FIndex TransitionIndex : Transitions)
+            {
+                const FTransitionNode& TransitionNode = Nodes.TransitionNodes[TransitionIndex];
+                if (TransitionNode.Definition->TargetStates.Num() != 0)
+                {
+                    FIndex DomainStateIndex = GetTransitionDomain(TransitionNode);
+
+                    for (FIndex ActiveStateIndex : ActiveStates)
+                    {
+                        if (IsDescendant(ActiveStateIndex, DomainStateIndex))
+                        {
+                            OutStatesToExit.Add(ActiveStateIndex);
+                        }
+                    }
+                }
+            }
+        }
+
+        void CollectStatesToEnter(const FTransitionIndexArray& Transitions, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const
+        {
+            for (FIndex TransitionIndex : Transitions)
+            {
+                const FTransitionNode& TransitionNode = Nodes.TransitionNodes[TransitionIndex];
+                for (const FGuid& StateID : TransitionNode.Definition->TargetStates)
+                {
+                    AddDescendantStatesToEnter(Nodes.StateIDToNodeIndex[StateID], OutStatesToEnter, OutStatesForDefaultEntry);
+                }
+
+                FIndex Ancestor = GetTransitionDomain(TransitionNode);
+                for (FIndex TargetStateIndex : GetTransitionEffectiveTargets(TransitionNode))
+                {
+                    AddAncestorStatesToEnter(TargetStateIndex, Ancestor, OutStatesToEnter, OutStatesForDefaultEntry);
+                }
+            }
+        }
+
+        /* Appends states remembered by given history state. Returns false if it has nothing recorded */
+        bool GetHistoryStates(FIndex HistoryIndex, FStateIndexArray& OutStates) const
+        {
+            if (HistoryStorage.Num() == 0)
+            {
+                return false;
+            }
+
+            const FStateChartHistoryTable::FSlot* Slot = Nodes.HistoryTable.FindSlot(HistoryIndex);
+            check(Slot != nullptr);
+
+            if (Slot->IsSingleChild())
+            {
+                const uint32 Value = HistoryStorage[Slot->StorageOffset];
+                if (Value != 0)
+                {
+                    OutStates.Add(FIndex(int32(Value - 1)));
+                }
+
+                return Value != 0;
+            }
+
+            const int32 NumStates = OutStates.Num();
+            for (int32 Word = 0; Word < Slot->NumWords; ++Word)
+            {
+                for (uint32 Bits = HistoryStorage[Slot->StorageOffset + Word]; Bits != 0; Bits &= Bits - 1)
+                {
+                    OutStates.Add(FIndex(int32(Nodes.HistoryTable.MaskWords[Slot->MaskOffset + Word] * 32 + FMath::CountTrailingZeros(Bits))));
+                }
+            }
+
+            return OutStates.Num() != NumStates;
+        }
+
+        bool IsDescendant(FIndex Child, FIndex Parent) const
+        {
+            bool bResult = false;
+            ForEachParent(Child, [&](FIndex Index, const FStateNode& Node)
+            {
+                if (Parent == Index)
+                {
+                    bResult = true;
+                    return false;
+                }
+
+                if (Index < Parent)
+                {
+                    // Index is at a higher level than Parent, stop iterating
+                    return false;
+                }
+
+                return true;
+            });
+
+            return bResult;
+        }
+
+        void ForEachParent(FIndex StateIndex, TFunctionRef<bool(FIndex, const FStateNode&)> Action) const
+        {
+            if (StateIndex.IsNone())
+            {
+                return;
+            }
+
+            FIndex CurrentIndex = Nodes.StateNodes[StateIndex].ParentIndex;
+            while (!CurrentIndex.IsNone())
+            {
+                auto& CurrentNode = Nodes.StateNodes[CurrentIndex];
+                if (!Action(CurrentIndex, CurrentNode))
+                {
+                    break;
+                }
+
+                CurrentIndex = CurrentNode.ParentIndex;
+            }
+        }
+
+        void ForEachChild(FIndex StateIndex, TFunctionRef<bool(FIndex, const FStateNode&)> Action) const
+        {
+            if (StateIndex.IsNone())
+            {
+                return;
+            }
+
+            const FStateNode& Node = Nodes.StateNodes[StateIndex];
+            for (int32 i = 0; i < Node.NumChildren; ++i)
+            {
+                const int32 ChildIndex = Node.ChildIndex + i;
+                if (!Action(ChildIndex, Nodes.StateNodes[ChildIndex]))
+                {
+                    break;
+                }
+            }
+        }
+
+    private:
+        template <typename TSourceAllocator>
+        static void AppendUnique(FStateIndexArray& Target, const TArray<FIndex, TSourceAllocator>& Source)
+        {
+            for (FIndex Item : Source)
+            {
+                Target.AddUnique(Item);
+            }
+        }
+
+        void AddDescendantStatesToEnter(FIndex StateIndex, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const
+        {
+            auto AddStatesToEnter = [&](const FStateIndexArray& StateIndexes, FIndex AncestorIndex)
+            {
+                for (FIndex Index : StateIndexes)
+                {
+                    AddDescendantStatesToEnter(Index, OutStatesToEnter, OutStatesForDefaultEntry);
+                }
+
+                for (FIndex Index : StateIndexes)
+                {
+                    AddAncestorStatesToEnter(Index, AncestorIndex, OutStatesToEnter, OutStatesForDefaultEntry);
+                }
+            };
+
+            const FStateNode& StateNode = Nodes.StateNodes[StateIndex];
+
+            if (bHasHistory && StateNode.Type == EStateType::History)
+            {
+                FStateIndexArray HistoryTargetStates;
+                if (GetHistoryStates(StateIndex, HistoryTargetStates))
+                {
+                    AddStatesToEnter(HistoryTargetStates, StateNode.ParentIndex);
+                }
+                else
+                {
+                    const FTransitionNode& HistoryTransition = Nodes.TransitionNodes[StateNode.TransitionIndex];
+
+                    FStateIndexArray TargetStates;
+                    Algo::Transform(HistoryTransition.Definition->TargetStates, TargetStates, [&](const FGuid& StateID) { return Nodes.StateIDToNodeIndex[StateID]; });
+                    AddStatesToEnter(TargetStates, StateNode.ParentIndex);
+                }
+            }
+            else
+            {
+                OutStatesToEnter.AddUnique(StateIndex);
+
+                if (StateNode.Type == EStateType::Compound)
+                {
+                    OutStatesForDefaultEntry.AddUnique(StateIndex);
+
+                    FStateIndexArray TargetStates;
+                    Algo::Transform(Nodes.TransitionNodes[StateNode.InitialTransitionIndex].Definition->TargetStates, TargetStates, [&](const FGuid& StateID) { return Nodes.StateIDToNodeIndex[StateID]; });
+                    AddStatesToEnter(TargetStates, StateIndex);
+                }
+                else if (bHasParallel && StateNode.Type == EStateType::Parallel)
+                {
+                    ForEachChild(StateIndex, [&](FIndex ChildIndex, auto)
+                    {
+                        if (!Algo::AnyOf(OutStatesToEnter, [&](FIndex ExistingIndex) { return IsDescendant(ExistingIndex, ChildIndex); }))
+                        {
+                            AddDescendantStatesToEnter(ChildIndex, OutStatesToEnter, OutStatesForDefaultEntry);
+                        }
+                        return true;
+                    });
+                }
+            }
+        }
+
+        void AddAncestorStatesToEnter(FIndex StateIndex, FIndex AncestorIndex, FStateIndexArray& OutStatesToEnter, FStateIndexArray& OutStatesForDefaultEntry) const
+        {
+            ForEachParent(StateIndex, [&](FIndex Index, const FStateNode& StateNode)
+            {
+                if (Index == AncestorIndex)
+                {
+                    return false;
+                }
+
+                OutStatesToEnter.AddUnique(Index);
+
+                if (bHasParallel && StateNode.Type == EStateType::Parallel)
+                {
+                    ForEachChild(StateIndex, [&](FIndex ChildIndex, auto)
+                    {
+                        if (!Algo::AnyOf(OutStatesToEnter, [&](FIndex ExistingIndex) { return IsDescendant(ExistingIndex, StateIndex); }))
+                        {
+                            AddDescendantStatesToEnter(ChildIndex, OutStatesToEnter, OutStatesForDefaultEntry);
+                        }
+                        return true;
+                    });
+                }
+
+                return true;
+            });
+        }
+
+        FIndex GetTransitionDomain(const FTransitionNode& Transition) const
+        {
+            FStateIndexArray TargetStates = GetTransitionEffectiveTargets(Transition);
+
+            if (TargetStates.Num() == 0)
+            {
+                return FIndex::None;
+            }
+
+            return FindLeastCommonCompoundAncestor(Transition.SourceNodeIndex, TargetStates);
+        }
+
+        FStateIndexArray GetTransitionEffectiveTargets(const FTransitionNode& Transition) const
+        {
+            FStateIndexArray Result;
+
+            for (const FGuid& StateID : Transition.Definition->TargetStates)
+            {
+                FIndex TargetStateIndex = Nodes.StateIDToNodeIndex[StateID];
+                const FStateNode& TargetStateNode = Nodes.StateNodes[TargetStateIndex];
+
+                if (bHasHistory && TargetStateNode.Type == EStateType::History)
+                {
+                    FStateIndexArray HistoryTargetStates;
+                    if (GetHistoryStates(TargetStateIndex, HistoryTargetStates))
+                    {
+                        AppendUnique(Result, HistoryTargetStates);
+                    }
+                    else
+                    {
+                        AppendUnique(Result, GetTransitionEffectiveTargets(Nodes.TransitionNodes[TargetStateNode.TransitionIndex]));
+                    }
+                }
+                else
+                {
+                    Result.Add(TargetStateIndex);
+                }
+            }
+
+            return Result;
+        }
+
+        FIndex FindLeastCommonCompoundAncestor(FIndex BaseIndex, const FStateIndexArray& States) const
+        {
+            FIndex Result;
+
+            ForEachParent(BaseIndex, [&](FIndex Index, const FStateNode& Node)
+            {
+                if (Algo::AllOf(States, [&](FIndex Index2) { return IsDescendant(Index2, Index); }))
+                {
+                    Result = Index;
+                    return false;
+                }
+
+                return true;
+            });
+
+            return Result;
+        }
+
+        const FStateChartNodes& Nodes;
+        TConstArrayView<FIndex> ActiveStates;
+        TConstArrayView<uint32> HistoryStorage;
+    };
+}
@@ -0,0 +1,122 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include <type_traits>
+
+namespace DruStateChart_Impl
+{
+    /* Wraps type into a value, so it can be passed to generic lambdas */
+    template <typename T>
+    struct TStaticType
+    {
+        using Type = T;
+    };
+
+    /* Returns index of T in Ts or INDEX_NONE. void is never found */
+    template <typename T, typename... Ts>
+    constexpr int32 StaticIndexOf()
+    {
+        // leading element avoids zero-sized array
+        constexpr bool Matches[] = { false, std::is_same_v<T, Ts>... };
+
+        for (int32 Index = 0; Index < int32(sizeof...(Ts)); ++Index)
+        {
+            if (Matches[Index + 1])
+            {
+                return Index;
+            }
+        }
+
+        return INDEX_NONE;
+    }
+
+    /* Returns how many times T is listed in Ts */
+    template <typename T, typename... Ts>
+    constexpr int32 StaticCountOf()
+    {
+        return (0 + ... + (std::is_same_v<T, Ts> ? 1 : 0));
+    }
+
+    /*
+     * Node tables of static StateChart.
+     * States are referenced by their index in TStaticStates list
+     */
+    template <int32 NumStates>
+    struct TStaticStateTables
+    {
+        int32 ParentIndex[NumStates] = {};
+        int32 InitialIndex[NumStates] = {}; // INDEX_NONE for Atomic states
+
+        bool bRootIsFirst = false;
+        bool bAcyclic = true;
+        bool bInitialIsChild = true;
+    };
+
+    template <int32 NumStates>
+    constexpr TStaticStateTables<NumStates> MakeStaticStateTables(const int32 (&ParentIndex)[NumStates], const int32 (&ExplicitInitialIndex)[NumStates])
+    {
+        TStaticStateTables<NumStates> Result;
+        Result.bRootIsFirst = ParentIndex[0] == INDEX_NONE;
+
+        for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+        {
+            Result.ParentIndex[StateIndex] = ParentIndex[StateIndex];
+
+            int32 Depth = 0;
+            for (int32 Index = ParentIndex[StateIndex]; Index != INDEX_NONE && Result.bAcyclic; Index = ParentIndex[Index])
+            {
+                Result.bAcyclic = ++Depth < NumStates;
+            }
+
+            int32 InitialIndex = ExplicitInitialIndex[StateIndex];
+            if (InitialIndex == INDEX_NONE)
+            {
+                // first listed child is initial, same as first child by SortOrder in assets
+                for (int32 ChildIndex = 0; ChildIndex < NumStates && InitialIndex == INDEX_NONE; ++ChildIndex)
+                {
+                    InitialIndex = ParentIndex[ChildIndex] == StateIndex ? ChildIndex : INDEX_NONE;
+                }
+            }
+            else
+            {
+                Result.bInitialIsChild &= ParentIndex[InitialIndex] == StateIndex;
+            }
+
+            Result.InitialIndex[StateIndex] = InitialIndex;
+        }
+
+        return Result;
+    }
+
+    template <int32 NumStates>
+    constexpr bool IsStaticDescendant(const TStaticStateTables<NumStates>& Tables, int32 Child, int32 Parent)
+    {
+        for (int32 Index = Tables.ParentIndex[Child]; Index != INDEX_NONE; Index = Tables.ParentIndex[Index])
+        {
+            if (Index == Parent)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Returns state that is not exited by transition. Matches FStateChartDefaultExecutor::GetTransitionDomain */
+    template <int32 NumStates>
+    constexpr int32 GetStaticTransitionDomain(const TStaticStateTables<NumStates>& Tables, int32 Source, int32 Target)
+    {
+        for (int32 Index = Tables.ParentIndex[Source]; Index != INDEX_NONE; Index = Tables.ParentIndex[Index])
+        {
+            if (IsStaticDescendant(Tables, Target, Index))
+            {
+                return Index;
+            }
+        }
+
+        // only transitions from root get here. TStaticStateChart rejects ones targeting root, so Target is its descendant
+        return Source;
+    }
+}
@@ -4,10 +4,16 @@
 
 #include "Templates/SharedPointer.h"
 #include "StructView.h"
+#include "GameplayTagContainer.h"
+#include "StateChartTypes.h"
 
 class UStateHandler;
 class UStateChartAsset;
 class UBaseStateDefinition;
+class FStateChartTimerWheel;
+class FStateChartEventBus;
+class FReferenceCollector;
+struct FStateChartExpiredTimer;
 
 /*
  * Executes StateChart. Intended to be stored inside TSharedRef
@@ -19,15 +25,30 @@ public:
 
     virtual ~IStateChartExecutor() = default;
 
-    /* Creates new Executor from given Asset and optional Context object*/
+    /* Creates new Executor from given Asset and optional Context object. Uses precompiled table of Asset when available, otherwise executor specialized for features used by Asset */
     static TSharedRef<IStateChartExecutor> CreateDefault(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject = nullptr);
 
     /* Returns StateChart that are being executed */
     virtual TObjectPtr<UStateChartAsset> GetExecutingAsset() const = 0;
 
+    /* Returns object passed when executor was created */
+    virtual TObjectPtr<UObject> GetContextObject() const { return nullptr; }
+
     /* Starts asset execution */
     virtual void Execute() = 0;
 
+    /*
+     * Exits all active states, running their exit Actions, and cancels pending timers. Queued events and recorded history are discarded.
+     * Allocations are kept, so Execute may start it again cheaply. Must not be called from Actions of this executor
+     */
+    virtual void Stop() {}
+
+    /*
+     * Stops executor and returns it to the state it was created in, with given Context object. Datamodel gets default values and stats are cleared.
+     * Timer wheel, event bus and deferred processing are kept. Lets executors be reused instead of created again
+     */
+    virtual void Reset(TObjectPtr<UObject> ContextObject = nullptr) {}
+
     /* Executes Event with provided payload */
     template <typename T, TEMPLATE_REQUIRES(TModels<CStaticStructProvider, T>::Value)>
     void ExecuteEvent(const T& Event)
@@ -54,12 +75,93 @@ public:
         ExecuteEventImpl(FConstStructView(&EventType, nullptr));
     }
 
+    /* Executes FStateChartGenericEvent with given tag. Its payload is created only if a Condition or StateHandler needs it */
+    void ExecuteTagEvent(const FGameplayTag& EventTag)
+    {
+        ExecuteTagEventImpl(EventTag);
+    }
+
+    /* Executes Event after DelaySeconds. Returns handle that may be passed to CancelDelayedEvent. Requires timer wheel */
+    template <typename T, TEMPLATE_REQUIRES(TModels<CStaticStructProvider, T>::Value)>
+    FStateChartTimerHandle ExecuteEventDelayed(const T& Event, float DelaySeconds)
+    {
+        return ExecuteEventDelayedImpl(FConstStructView::Make(Event), DelaySeconds);
+    }
+
+    /* Executes Event after DelaySeconds. Returns handle that may be passed to CancelDelayedEvent. Requires timer wheel */
+    FStateChartTimerHandle ExecuteEventDelayed(FConstStructView Event, float DelaySeconds)
+    {
+        return ExecuteEventDelayedImpl(Event, DelaySeconds);
+    }
+
+    /* Cancels event scheduled by ExecuteEventDelayed of this executor, if it was not executed yet */
+    virtual void CancelDelayedEvent(const FStateChartTimerHandle& Handle) {}
+
+    /* Sets timer wheel used by delayed events and timed transitions. Should be set before Execute. Executors of one group may share it */
+    virtual void SetTimerWheel(TSharedPtr<FStateChartTimerWheel> TimerWheel) {}
+
+    /* Attaches executor to event bus, so events broadcast on it reach executor while its active states may react to them. Null detaches it */
+    virtual void SetEventBus(TSharedPtr<FStateChartEventBus> EventBus) {}
+
     /* Returns definitions of all active states */
     virtual TArray<TObjectPtr<UBaseStateDefinition>> GetActiveStates() const = 0;
 
     /* Called when new instance of StateHandler is created */
     virtual FHandlerCreated& OnStateHandlerCreated() = 0;
 
+    /* Returns Datamodel owned by this executor. It is empty if StateChart declares no variables */
+    virtual FStructView GetDatamodel() { return FStructView(); }
+
+    /* Called after variable of Datamodel was changed through FStateChartDatamodelSlot */
+    virtual void NotifyDatamodelChanged(FName VariableName) {}
+
+    /*
+     * Re-evaluates eventless transitions of active states whose dependencies changed since they were last evaluated,
+     * together with ones that do not declare dependencies. Costs nothing when no dependency changed
+     */
+    virtual void Update() {}
+
+    /* Marks Conditions depending on given value as changed. They are re-evaluated on next Update */
+    virtual void InvalidateDependency(FName Dependency) {}
+
+    /* Returns delegate calling InvalidateDependency. It may be bound to change notifications of game objects */
+    FSimpleDelegate CreateInvalidationDelegate(FName Dependency)
+    {
+        return FSimpleDelegate::CreateSP(this, &IStateChartExecutor::InvalidateDependency, Dependency);
+    }
+
+    /*
+     * When set, events are queued instead of being processed inside ExecuteEvent, and only Pump processes them.
+     * Lets scheduler spread bursts of events across frames
+     */
+    virtual void SetDeferredProcessing(bool bDeferred) {}
+
+    /*
+     * Processes queued events until MaxMacrosteps of them were processed or MaxSeconds passed. Zero MaxSeconds means no time limit.
+     * Events raised by Actions are processed within macrostep of the event that raised them. Returns number of processed macrosteps
+     */
+    virtual int32 Pump(int32 MaxMacrosteps, double MaxSeconds = 0.0) { return 0; }
+
+    /* Returns number of events waiting to be processed */
+    virtual int32 GetNumQueuedEvents() const { return 0; }
+
+    /* Scheduler processes events of less significant executors less often. Executors that do not support it are always High */
+    virtual void SetSignificance(EStateChartSignificance InSignificance) {}
+    virtual EStateChartSignificance GetSignificance() const { return EStateChartSignificance::High; }
+
+    /* Returns execution counters. Executors that do not track them return zeroes */
+    virtual FStateChartExecutorStats GetStats() const { return FStateChartExecutorStats(); }
+
+    /* Reports UObjects owned by executor, except its asset. Called for all executors at once by FStateChartExecutorRegistry during garbage collection */
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) {}
+
 protected:
+    friend class FStateChartTimerWheel;
+
     virtual void ExecuteEventImpl(FConstStructView Event) = 0;
+    virtual void ExecuteTagEventImpl(const FGameplayTag& EventTag);
+    virtual FStateChartTimerHandle ExecuteEventDelayedImpl(FConstStructView Event, float DelaySeconds);
+
+    /* Called by timer wheel with timers of this executor that expired during last Advance, in order of expiration */
+    virtual void OnTimersExpired(TArrayView<const FStateChartExpiredTimer> Timers) {}
 };
\ No newline at end of file
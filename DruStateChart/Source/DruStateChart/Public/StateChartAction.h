@@ -19,6 +19,11 @@ struct DRUSTATECHART_API FStateChartAction
 public:
     virtual ~FStateChartAction() = default;
 
+    /* Called when StateChart is assembled. Action may precompute data used by Execute */
+    virtual void Compile(const FStateChartCompileContext& Context)
+    {
+    }
+
     /*
      * Override this method if your Action needs asynchronous execution.
      * Return value tells executor when next action in the list should be executed.
@@ -37,4 +42,35 @@ public:
      * Context contains info about executing object
      */
     virtual void Execute(const FStateChartExecutionContext& Context) {}
+
+    /*
+     * Returns false if this Action always completes synchronously.
+     * Executor skips continuation bookkeeping for StateCharts without asynchronous Actions
+     */
+    virtual bool IsAsync() const { return true; }
+
+    /*
+     * Seconds executor waits for Done before continuing without it. Zero means default timeout of StateChart is used.
+     * Ignored if Action completes synchronously
+     */
+    UPROPERTY(EditAnywhere, meta = (ClampMin = 0, Units = "s"))
+    float Timeout = 0.f;
+};
+
+/*
+ * Action that always completes synchronously.
+ * Override Execute only
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartSyncAction : public FStateChartAction
+{
+    GENERATED_BODY()
+
+public:
+    EActionContinuationType ExecuteAsync(const FStateChartExecutionContext& Context, const FSimpleDelegate& Done) override final
+    {
+        return Execute(Context), EActionContinuationType::Immediate;
+    }
+
+    bool IsAsync() const override final { return false; }
 };
\ No newline at end of file
@@ -3,10 +3,13 @@
 #pragma once
 
 #include "Engine/DataAsset.h"
+#include "PropertyBag.h"
 #include "StateChartTypes.h"
 #include "Impl/StateChartNodes.h"
+#include "Impl/StateChartFlatTable.h"
 #include "StateChartAsset.generated.h"
 
+class UStateChartElementAsset;
 class UBaseStateDefinition;
 class UTransitionDefinition;
 
@@ -22,18 +25,60 @@ public:
     void Serialize(FStructuredArchive::FRecord Record) override;
     void PostLoad() override;
 
+#if WITH_EDITOR
+    void PreEditChange(FProperty* PropertyAboutToChange) override;
+    void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
     /* Returns default type of Continuation used in this StateChart */
     EActionContinuationType GetDefaultContinuationType() const { return DefaultContinuationType; }
 
+    int32 GetMaxEventlessMicrosteps() const { return MaxEventlessMicrosteps; }
+
+    int32 GetEventQueueCapacity() const { return EventQueueCapacity; }
+    EStateChartQueueOverflow GetEventQueueOverflow() const { return EventQueueOverflow; }
+    const TArray<FStateChartEventQueuePolicy>& GetEventQueuePolicies() const { return EventQueuePolicies; }
+
+    /* Returns timeout used by asynchronous Actions and StateHandlers that do not specify their own */
+    float GetDefaultActionTimeout() const { return DefaultActionTimeout; }
+
     /* Returns assembled tree of nodes used by StateChartExecutor */
     const DruStateChart_Impl::FStateChartNodes& GetAssembledNodes() const;
 
+    /* Returns precompiled table of configurations, or null if it is disabled or StateChart is not eligible */
+    const DruStateChart_Impl::FStateChartFlatTable* GetFlatTable() const;
+
+    /* Returns Datamodel declared by StateChart. Every executor starts with its own copy of it */
+    const FInstancedPropertyBag& GetDatamodel() const { return Datamodel; }
+
+#if WITH_EDITOR
+    DECLARE_MULTICAST_DELEGATE_TwoParams(FOnElementChanged, UStateChartElementAsset*, EStateChartElementChange);
+
+    /*
+     * Updates assembled nodes after State or Transition was edited. Only affected nodes and derived tables are patched when possible.
+     * Property edits report themselves. Added and Removed must be reported by code that creates or deletes elements
+     */
+    void NotifyElementChanged(UStateChartElementAsset& Element, EStateChartElementChange Change);
+
+    /* Called after State or Transition was edited */
+    FOnElementChanged& OnElementChanged() { return ElementChangedDelegate; }
+#endif
+
 protected:
     UFUNCTION(CallInEditor)
     void AssembleNodeTree();
 
+    void CompileFlatTable();
+
+    /* Lets Conditions and Actions of Element precompute their data */
+    void CompileElement(UStateChartElementAsset& Element) const;
+
 #if WITH_EDITOR
     void MoveSubObjectsToExternalPackage();
+    bool PatchNodes(UStateChartElementAsset& Element, EStateChartElementChange Change);
+
+    /* Reports elements that differ between PreEditStates/PreEditTransitions and current lists as Added or Removed */
+    void NotifyElementListChanged();
 #endif
 
 private:
@@ -44,6 +89,45 @@ private:
     UPROPERTY(EditAnywhere)
     EActionContinuationType DefaultContinuationType = EActionContinuationType::FirstFinish;
 
+    /* Limits number of eventless transitions taken in a row, so they cannot loop forever. Pending events are processed after reaching it */
+    UPROPERTY(EditAnywhere, meta = (ClampMin = 1))
+    int32 MaxEventlessMicrosteps = 100;
+
+    /*
+     * Seconds executor waits for asynchronous Actions and StateHandlers to call Done before continuing without them.
+     * Zero waits forever. Requires executor to have a timer wheel
+     */
+    UPROPERTY(EditAnywhere, meta = (ClampMin = 0, Units = "s"))
+    float DefaultActionTimeout = 0.f;
+
+    /* Maximum number of external events queued while executor is busy. Zero means unlimited */
+    UPROPERTY(EditAnywhere, Category = "Event Queue", meta = (ClampMin = 0))
+    int32 EventQueueCapacity = 0;
+
+    /* Determines which event is discarded when EventQueueCapacity is reached */
+    UPROPERTY(EditAnywhere, Category = "Event Queue")
+    EStateChartQueueOverflow EventQueueOverflow = EStateChartQueueOverflow::DropNewest;
+
+    /* Capacity and coalescing of individual event types */
+    UPROPERTY(EditAnywhere, Category = "Event Queue")
+    TArray<FStateChartEventQueuePolicy> EventQueuePolicies;
+
+    /*
+     * Precompiles all reachable configurations into a table, so each event is processed with a single lookup.
+     * Applies only to StateCharts without History states, StateHandlers and Conditions, whose Actions derive from FStateChartSyncAction.
+     * Default executor is used when StateChart is not eligible
+     */
+    UPROPERTY(EditAnywhere, Category = "Optimization")
+    bool bCompileFlatTable = false;
+
+    /* Compilation is abandoned when StateChart has more reachable configurations than this */
+    UPROPERTY(EditAnywhere, Category = "Optimization", meta = (EditCondition = "bCompileFlatTable", ClampMin = 1))
+    int32 MaxFlatTableConfigurations = 256;
+
+    /* Variables available to Conditions and Actions with their initial values. Each executor owns its own copy */
+    UPROPERTY(EditAnywhere, Category = "Datamodel")
+    FInstancedPropertyBag Datamodel;
+
     UPROPERTY(EditAnywhere, Transient, SkipSerialization)
     TArray<TObjectPtr<UBaseStateDefinition>> AllStates;
 
@@ -51,5 +135,14 @@ private:
     TArray<TObjectPtr<UTransitionDefinition>> AllTransitions;
 
     DruStateChart_Impl::FStateChartNodes Nodes;
+    DruStateChart_Impl::FStateChartFlatTable FlatTable;
     bool bNodesDirty = true;
+
+#if WITH_EDITOR
+    FOnElementChanged ElementChangedDelegate;
+
+    // element lists before current edit of AllStates or AllTransitions
+    TArray<UBaseStateDefinition*> PreEditStates;
+    TArray<UTransitionDefinition*> PreEditTransitions;
+#endif
 };
\ No newline at end of file
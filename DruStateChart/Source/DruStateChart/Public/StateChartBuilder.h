@@ -3,7 +3,9 @@
 #pragma once
 
 #include "Impl/StateChartBuilderOps.h"
+#include "StateChartTypes.h"
 #include "UObject/ObjectPtr.h"
+#include "PropertyBag.h"
 
 class UStateChartAsset;
 class UCompoundStateDefinition;
@@ -21,6 +23,41 @@ public:
 
     TObjectPtr<UStateChartAsset> Build(UObject* InParent = nullptr, UClass* InClass = nullptr, FName InName = FName(), EObjectFlags Flags = EObjectFlags::RF_NoFlags);
 
+    /* Precompile configurations table of resulting StateChart, if it is eligible */
+    FStateChartBuilder& CompileFlatTable(int32 MaxConfigurations = 256)
+    {
+        MaxFlatTableConfigurations = MaxConfigurations;
+        return *this;
+    }
+
+    /* Limits number of external events queued while executor is busy */
+    FStateChartBuilder& EventQueue(int32 Capacity, EStateChartQueueOverflow Overflow = EStateChartQueueOverflow::DropNewest)
+    {
+        EventQueueCapacity = Capacity;
+        EventQueueOverflow = Overflow;
+        return *this;
+    }
+
+    /* Sets queueing rules of events of type T */
+    template <typename T>
+    FStateChartBuilder& EventQueuePolicy(int32 Capacity, EStateChartQueueOverflow Overflow = EStateChartQueueOverflow::DropOldest, bool bCoalesce = false, bool bCritical = false)
+    {
+        FStateChartEventQueuePolicy& Policy = EventQueuePolicies.AddDefaulted_GetRef();
+        Policy.EventType = T::StaticStruct();
+        Policy.Capacity = Capacity;
+        Policy.Overflow = Overflow;
+        Policy.bCoalesce = bCoalesce;
+        Policy.bCritical = bCritical;
+        return *this;
+    }
+
+    /* Declares Datamodel variable with its initial value */
+    FStateChartBuilder& Variable(FName Name, bool InitialValue);
+    FStateChartBuilder& Variable(FName Name, int32 InitialValue);
+    FStateChartBuilder& Variable(FName Name, float InitialValue);
+    FStateChartBuilder& Variable(FName Name, double InitialValue);
+    FStateChartBuilder& Variable(FName Name, FName InitialValue);
+
     DruStateChart_Impl::FStateBuilder& State(FString Name)
     {
         return *StateBuilders.Emplace_GetRef(MakeShared<DruStateChart_Impl::FStateBuilder>(MoveTemp(Name)));
@@ -70,4 +107,12 @@ private:
     FPathLookup PathLookup;
 
     TObjectPtr<UStateChartAsset> StateChart = nullptr;
+
+    int32 MaxFlatTableConfigurations = 0;
+
+    int32 EventQueueCapacity = 0;
+    EStateChartQueueOverflow EventQueueOverflow = EStateChartQueueOverflow::DropNewest;
+    TArray<FStateChartEventQueuePolicy> EventQueuePolicies;
+
+    FInstancedPropertyBag Datamodel;
 };
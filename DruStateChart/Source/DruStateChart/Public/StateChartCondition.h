@@ -18,6 +18,11 @@ struct DRUSTATECHART_API FStateChartCondition
 public:
     virtual ~FStateChartCondition() = default;
 
+    /* Called when StateChart is assembled. Condition may precompute data used by Evaluate */
+    virtual void Compile(const FStateChartCompileContext& Context)
+    {
+    }
+
     /*
      * Return true if Transition should be taken, false otherwise
      * TransitionEvent contains event that triggered the transition. It may be null in case of automatic transition.
@@ -28,4 +33,23 @@ public:
     {
         return true;
     }
+
+    /*
+     * Return true if result depends only on Context and TransitionEvent and evaluation has no side effects.
+     * Identical pure conditions are evaluated at most once per event, their result is shared by all transitions using them
+     */
+    virtual bool IsPure() const
+    {
+        return false;
+    }
+
+    /*
+     * Fills names of values that result depends on and returns true, or returns false if they are unknown.
+     * Datamodel variables are referenced by their names, other values by any name passed to IStateChartExecutor::InvalidateDependency.
+     * Eventless transitions with known dependencies are not re-evaluated by IStateChartExecutor::Update until one of them changes
+     */
+    virtual bool GetDependencies(TArray<FName>& OutDependencies) const
+    {
+        return false;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,134 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "StateChartTypes.h"
+#include "StateChartCondition.h"
+#include "GameplayTagContainer.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "UObject/UnrealType.h"
+#include "StateChartDatamodel.generated.h"
+
+namespace DruStateChart_Impl
+{
+    /* Property type that stores values of T inside Datamodel */
+    template <typename T> struct TDatamodelPropertyType;
+    template <> struct TDatamodelPropertyType<bool> { using Type = FBoolProperty; };
+    template <> struct TDatamodelPropertyType<int32> { using Type = FIntProperty; };
+    template <> struct TDatamodelPropertyType<int64> { using Type = FInt64Property; };
+    template <> struct TDatamodelPropertyType<float> { using Type = FFloatProperty; };
+    template <> struct TDatamodelPropertyType<double> { using Type = FDoubleProperty; };
+    template <> struct TDatamodelPropertyType<uint8> { using Type = FByteProperty; };
+    template <> struct TDatamodelPropertyType<FName> { using Type = FNameProperty; };
+    template <> struct TDatamodelPropertyType<FString> { using Type = FStrProperty; };
+    template <> struct TDatamodelPropertyType<FGameplayTag> { using Type = FStructProperty; };
+}
+
+/*
+ * Reference to a variable of executor Datamodel.
+ * Resolved to offset when StateChart is assembled, so reading and writing it is a direct memory access.
+ * Conditions and Actions should resolve their slots inside Compile
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartDatamodelSlot
+{
+    GENERATED_BODY()
+
+public:
+    FStateChartDatamodelSlot() = default;
+    FStateChartDatamodelSlot(FName InName) : Name(InName) {}
+
+    /* Resolves slot against Datamodel layout. Returns false if variable does not exist or is not of type T */
+    template <typename T>
+    bool Resolve(const FStateChartCompileContext& Context)
+    {
+        using FPropertyType = typename DruStateChart_Impl::TDatamodelPropertyType<T>::Type;
+
+        const FProperty* Property = FindProperty(Context);
+        bool bValid = Property != nullptr && Property->IsA<FPropertyType>() && Property->GetElementSize() == sizeof(T);
+
+        if constexpr (std::is_same_v<FPropertyType, FStructProperty>)
+        {
+            bValid = bValid && CastFieldChecked<FStructProperty>(Property)->Struct == T::StaticStruct();
+        }
+
+        Offset = bValid ? Property->GetOffset_ForInternal() : INDEX_NONE;
+        return bValid;
+    }
+
+    bool IsResolved() const { return Offset != INDEX_NONE; }
+
+    /* Returns value of the variable. Slot must be resolved */
+    template <typename T>
+    const T& Get(const FStateChartExecutionContext& Context) const
+    {
+        return *GetPtr<T>(Context);
+    }
+
+    /* Writes value of the variable and notifies executor if it changed. Slot must be resolved */
+    template <typename T>
+    void Set(const FStateChartExecutionContext& Context, const T& Value) const
+    {
+        T& Current = *GetPtr<T>(Context);
+        if (!(Current == Value))
+        {
+            Current = Value;
+            Context.Executor.NotifyDatamodelChanged(Name);
+        }
+    }
+
+    /* Name of variable in Datamodel */
+    UPROPERTY(EditAnywhere)
+    FName Name;
+
+private:
+    template <typename T>
+    T* GetPtr(const FStateChartExecutionContext& Context) const
+    {
+        check(IsResolved() && Context.Datamodel.IsValid());
+        return reinterpret_cast<T*>(Context.Datamodel.GetMemory() + Offset);
+    }
+
+    const FProperty* FindProperty(const FStateChartCompileContext& Context) const;
+
+    int32 Offset = INDEX_NONE;
+};
+
+/*
+ * Raised by executor when variable of Datamodel is changed through FStateChartDatamodelSlot.
+ * Events raised from Actions are processed as internal events.
+ * Executor raises it only if any transition is triggered by this event
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartDatamodelChangedEvent
+{
+    GENERATED_BODY()
+
+public:
+    FStateChartDatamodelChangedEvent() = default;
+    FStateChartDatamodelChangedEvent(FName InName) : Name(InName) {}
+
+    /* Name of changed variable */
+    UPROPERTY(EditAnywhere)
+    FName Name;
+};
+
+/*
+ * Passes when transition is triggered by change of given Datamodel variable
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartDatamodelChangedCondition : public FStateChartCondition
+{
+    GENERATED_BODY()
+
+public:
+    FStateChartDatamodelChangedCondition() = default;
+    FStateChartDatamodelChangedCondition(FName InName) : Name(InName) {}
+
+    bool Evaluate(const FStateChartExecutionContext& Context, FConstStructView Event) const override;
+    bool IsPure() const override { return true; }
+    bool GetDependencies(TArray<FName>& OutDependencies) const override { return true; }
+
+    UPROPERTY(EditAnywhere)
+    FName Name;
+};
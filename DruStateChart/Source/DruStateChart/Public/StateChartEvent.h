@@ -22,6 +22,38 @@ protected:
 	FGameplayTag EventTag;
 };
 
+/*
+ * Transition with this EventID is triggered by event of any type.
+ * Transitions on other event types are also triggered by events derived from their type
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartAnyEvent
+{
+	GENERATED_BODY()
+};
+
+/*
+ * Raised by executor when Delay of timed transition elapses. Triggers only the transition that scheduled it
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartTimeoutEvent
+{
+	GENERATED_BODY()
+
+public:
+	FStateChartTimeoutEvent() = default;
+	FStateChartTimeoutEvent(int32 InTransitionIndex, const FStateChartTimerHandle& InTimer)
+		: TransitionIndex(InTransitionIndex), Timer(InTimer)
+	{}
+
+	UPROPERTY()
+	int32 TransitionIndex = INDEX_NONE;
+
+	/* Timeouts from previous activations of the state are ignored */
+	UPROPERTY()
+	FStateChartTimerHandle Timer;
+};
+
 USTRUCT()
 struct DRUSTATECHART_API FStateChartGenericEventCondition : public FStateChartCondition
 {
@@ -34,6 +66,8 @@ public:
 	{};
 
 	bool Evaluate(const FStateChartExecutionContext& Context, FConstStructView Event) const override;
+	bool IsPure() const override { return true; }
+	bool GetDependencies(TArray<FName>& OutDependencies) const override { return true; }
 
 	UPROPERTY(EditAnywhere)
 	FGameplayTag EventTag;
@@ -0,0 +1,85 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Map.h"
+#include "Containers/Set.h"
+#include "GameplayTagContainer.h"
+#include "StructView.h"
+#include "Concepts/StaticStructProvider.h"
+
+class IStateChartExecutor;
+
+/* Fan-out counters of FStateChartEventBus */
+struct FStateChartEventBusStats
+{
+    /* Number of broadcast events */
+    int32 NumBroadcasts = 0;
+
+    /* Number of times broadcast event was delivered to an executor */
+    int64 NumDeliveries = 0;
+
+    /* Number of deliveries skipped, because active states of executor had no transition on the event */
+    int64 NumDeliveriesAvoided = 0;
+
+    /* Number of executors reached by the last broadcast */
+    int32 LastFanOut = 0;
+
+    /* Largest number of executors reached by a single broadcast */
+    int32 MaxFanOut = 0;
+};
+
+/*
+ * Delivers broadcast events only to executors that may react to them.
+ * Each attached executor keeps its interest in event types and tags up to date while it enters and exits states,
+ * so broadcast touches only executors whose active states have transitions on the event, its parent types or FStateChartAnyEvent.
+ * FStateChartGenericEvent reaches executors interested in its tag or parent tags. Busy executors receive every event
+ */
+class DRUSTATECHART_API FStateChartEventBus
+{
+public:
+    /* Delivers Event to interested executors. Returns number of executors it was delivered to */
+    template <typename T, TEMPLATE_REQUIRES(TModels<CStaticStructProvider, T>::Value)>
+    int32 Broadcast(const T& Event)
+    {
+        return Broadcast(FConstStructView::Make(Event));
+    }
+
+    /* Delivers Event to interested executors. Returns number of executors it was delivered to */
+    int32 Broadcast(FConstStructView Event);
+
+    /* Delivers FStateChartGenericEvent with given tag to interested executors. Returns number of executors it was delivered to */
+    int32 BroadcastTag(const FGameplayTag& EventTag);
+
+    /* Called by executors when they are attached to the bus and detached from it */
+    void AddExecutor(IStateChartExecutor& Executor);
+    void RemoveExecutor(IStateChartExecutor& Executor);
+
+    /* Called by executors when they gain first and lose last transition on given event type */
+    void AddInterest(IStateChartExecutor& Executor, const UScriptStruct* EventType);
+    void RemoveInterest(IStateChartExecutor& Executor, const UScriptStruct* EventType);
+
+    /* Called by executors when they gain first and lose last transition on FStateChartGenericEvent with given tag */
+    void AddTagInterest(IStateChartExecutor& Executor, const FGameplayTag& EventTag);
+    void RemoveTagInterest(IStateChartExecutor& Executor, const FGameplayTag& EventTag);
+
+    /* Called by executors when they start and finish handling events against states other than their active ones, e.g. queued events or running plan */
+    void SetExecutorBusy(IStateChartExecutor& Executor, bool bBusy);
+
+    /* Returns number of executors interested in exactly given event type */
+    int32 GetNumInterested(const UScriptStruct* EventType) const;
+
+    int32 GetNumExecutors() const { return NumExecutors; }
+    const FStateChartEventBusStats& GetStats() const { return Stats; }
+
+private:
+    template <typename TDeliver>
+    int32 Deliver(const UScriptStruct* EventType, const FGameplayTag& EventTag, TDeliver&& DeliverToExecutor);
+
+    TMap<const UScriptStruct*, TSet<IStateChartExecutor*>> InterestedExecutors;
+    TMap<FGameplayTag, TSet<IStateChartExecutor*>> TagInterestedExecutors;
+    TSet<IStateChartExecutor*> BusyExecutors;
+    int32 NumExecutors = 0;
+
+    FStateChartEventBusStats Stats;
+};
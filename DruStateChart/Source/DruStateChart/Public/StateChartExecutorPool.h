@@ -0,0 +1,59 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/GCObject.h"
+#include "UObject/ObjectPtr.h"
+#include "Containers/Array.h"
+#include "Templates/SharedPointer.h"
+
+class IStateChartExecutor;
+class UStateChartAsset;
+class FStateChartTimerWheel;
+class FStateChartEventBus;
+
+/*
+ * Keeps stopped executors of a single asset, so spawn waves reuse their memory instead of creating executors again.
+ * Executors handed out by the pool are reset to the requested Context object and are not started yet
+ */
+class DRUSTATECHART_API FStateChartExecutorPool : public FGCObject
+{
+public:
+    /* New executors of the pool use given timer wheel and event bus. Both may be null */
+    explicit FStateChartExecutorPool(UStateChartAsset& InAsset, TSharedPtr<FStateChartTimerWheel> InTimerWheel = nullptr, TSharedPtr<FStateChartEventBus> InEventBus = nullptr);
+
+    /* Creates executors until NumExecutors of them are pooled */
+    void Reserve(int32 NumExecutors);
+
+    /* Returns pooled executor reset to ContextObject, or new one if pool is empty. Call Execute to start it */
+    TSharedRef<IStateChartExecutor> Acquire(TObjectPtr<UObject> ContextObject = nullptr);
+
+    /* Stops Executor and returns it to the pool. Caller must not use it afterwards */
+    void Release(const TSharedRef<IStateChartExecutor>& Executor);
+
+    /* Destroys pooled executors above MaxPooled */
+    void Trim(int32 MaxPooled);
+
+    int32 GetNumPooled() const { return PooledExecutors.Num(); }
+
+    /* Number of executors created by the pool and number of Acquire calls served by pooled ones */
+    int32 GetNumCreated() const { return NumCreated; }
+    int32 GetNumReused() const { return NumReused; }
+
+    // Begin FGCObject overrides
+    void AddReferencedObjects(FReferenceCollector& Collector) override;
+    FString GetReferencerName() const override;
+    //~End FGCObject overrides
+
+private:
+    TSharedRef<IStateChartExecutor> CreateExecutor(TObjectPtr<UObject> ContextObject);
+
+    TObjectPtr<UStateChartAsset> Asset;
+    TSharedPtr<FStateChartTimerWheel> TimerWheel;
+    TSharedPtr<FStateChartEventBus> EventBus;
+
+    TArray<TSharedRef<IStateChartExecutor>> PooledExecutors;
+
+    int32 NumCreated = 0;
+    int32 NumReused = 0;
+};
@@ -0,0 +1,41 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "StateChartCondition.h"
+#include "Templates/SubclassOf.h"
+#include "Impl/StateChartExpression.h"
+#include "StateChartExpressionCondition.generated.h"
+
+/*
+ * Condition defined by expression over properties of Context object or variables of Datamodel, for example "Health < 0.3 && bHasAmmo".
+ * Expression is compiled when StateChart is assembled, so evaluation does not look up properties by name.
+ * When ContextClass is set, condition fails if Context object is not of ContextClass. Otherwise expression reads Datamodel
+ */
+USTRUCT(meta = (DisplayName = "Expression"))
+struct DRUSTATECHART_API FStateChartExpressionCondition : public FStateChartCondition
+{
+    GENERATED_BODY()
+
+public:
+    FStateChartExpressionCondition() = default;
+    FStateChartExpressionCondition(FString InExpression, TSubclassOf<UObject> InContextClass = nullptr)
+        : Expression(MoveTemp(InExpression)), ContextClass(InContextClass)
+    {}
+
+    void Compile(const FStateChartCompileContext& Context) override;
+    bool Evaluate(const FStateChartExecutionContext& Context, FConstStructView TransitionEvent) const override;
+    bool IsPure() const override { return true; }
+    bool GetDependencies(TArray<FName>& OutDependencies) const override;
+
+    UPROPERTY(EditAnywhere)
+    FString Expression;
+
+    /* Class of Context object. Expression may reference its properties. Datamodel variables are used when not set */
+    UPROPERTY(EditAnywhere)
+    TSubclassOf<UObject> ContextClass;
+
+private:
+    /* Shared between copies of this condition */
+    TSharedPtr<const DruStateChart_Impl::FStateChartExpression> Program;
+};
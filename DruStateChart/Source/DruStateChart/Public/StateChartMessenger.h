@@ -0,0 +1,119 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "StateChartTypes.h"
+#include "Containers/Array.h"
+#include "GameplayTagContainer.h"
+#include "InstancedStruct.h"
+#include "StructView.h"
+#include "Templates/SharedPointer.h"
+#include "Concepts/StaticStructProvider.h"
+
+class IStateChartExecutor;
+
+/* Delivery counters of FStateChartMessenger */
+struct FStateChartMessengerStats
+{
+    /* Number of messages accepted by Send */
+    int64 NumSent = 0;
+
+    /* Number of messages delivered to their executors */
+    int64 NumDelivered = 0;
+
+    /* Number of messages discarded, because their executor was unregistered or destroyed before delivery */
+    int64 NumDropped = 0;
+
+    int32 NumFlushes = 0;
+
+    /* Number of messages delivered by the last Flush and time it took */
+    int32 LastFlushMessages = 0;
+    double LastFlushSeconds = 0.0;
+
+    /* Time between Send and delivery, summed over all delivered messages, and its largest value */
+    double TotalLatencySeconds = 0.0;
+    double MaxLatencySeconds = 0.0;
+
+    double GetAverageLatencySeconds() const { return NumDelivered != 0 ? TotalLatencySeconds / NumDelivered : 0.0; }
+
+    /* Messages delivered per second during the last Flush */
+    double GetLastFlushThroughput() const { return LastFlushSeconds > 0.0 ? LastFlushMessages / LastFlushSeconds : 0.0; }
+};
+
+/*
+ * Delivers events between executors without re-entering their processing.
+ * Send puts event to mailbox of target executor, and Flush delivers contents of all mailboxes in batches, one mailbox at a time.
+ * Messages sent while Flush is running are delivered by the next Flush, so executors sending to each other never recurse
+ */
+class DRUSTATECHART_API FStateChartMessenger
+{
+public:
+    /* Returns handle other executors may send messages to. Executor must be stored inside TSharedRef */
+    FStateChartExecutorHandle Register(IStateChartExecutor& Executor);
+
+    /* Discards pending messages of the executor. Its handle never resolves again */
+    void Unregister(const FStateChartExecutorHandle& Handle);
+
+    /* Returns registered executor or null if handle is stale */
+    TSharedPtr<IStateChartExecutor> Resolve(const FStateChartExecutorHandle& Handle) const;
+
+    /* Puts Event to mailbox of Target. Returns false if Target is not registered or was destroyed */
+    template <typename T, TEMPLATE_REQUIRES(TModels<CStaticStructProvider, T>::Value)>
+    bool Send(const FStateChartExecutorHandle& Target, const T& Event)
+    {
+        return Send(Target, FConstStructView::Make(Event));
+    }
+
+    /* Puts Event to mailbox of Target. Returns false if Target is not registered or was destroyed */
+    bool Send(const FStateChartExecutorHandle& Target, FConstStructView Event);
+
+    /* Puts FStateChartGenericEvent with given tag to mailbox of Target. Returns false if Target is not registered or was destroyed */
+    bool SendTag(const FStateChartExecutorHandle& Target, const FGameplayTag& EventTag);
+
+    /* Delivers messages sent before this call. Returns number of delivered messages */
+    int32 Flush();
+
+    int32 GetNumPendingMessages() const { return NumPendingMessages; }
+    const FStateChartMessengerStats& GetStats() const { return Stats; }
+
+    void AddStructReferencedObjects(FReferenceCollector& Collector);
+
+private:
+    struct FMessage
+    {
+        // tag messages have no payload
+        FGameplayTag EventTag;
+        FInstancedStruct Event;
+        double SendTime;
+    };
+
+    struct FMailbox
+    {
+        TWeakPtr<IStateChartExecutor> Executor;
+        TArray<FMessage> Messages;
+        uint32 Serial = 0;
+        bool bRegistered = false;
+
+        // mailbox is listed in PendingMailboxes
+        bool bPending = false;
+    };
+
+    FMailbox* FindMailbox(const FStateChartExecutorHandle& Handle);
+    const FMailbox* FindMailbox(const FStateChartExecutorHandle& Handle) const;
+
+    /* Adds message to mailbox of Target. Returns null if Target is not registered or was destroyed */
+    FMessage* AddMessage(const FStateChartExecutorHandle& Target);
+
+    TArray<FMailbox> Mailboxes;
+    TArray<int32> FreeMailboxes;
+
+    // mailboxes with messages, in order of their first message
+    TArray<int32> PendingMailboxes;
+
+    // kept to reuse allocations between flushes
+    TArray<int32> FlushingMailboxes;
+    TArray<FMessage> DeliveringMessages;
+
+    int32 NumPendingMessages = 0;
+    FStateChartMessengerStats Stats;
+};
@@ -0,0 +1,121 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "StateChartTimerWheel.h"
+#include "StateChartEventBus.h"
+#include "StateChartMessenger.h"
+#include "StateChartExecutorPool.h"
+#include "StateChartTypes.h"
+#include "StateChartSubsystem.generated.h"
+
+class UStateChartAsset;
+
+/* Returns current significance of executor. May be bound to USignificanceManager or distance checks of the game */
+DECLARE_DELEGATE_RetVal_OneParam(EStateChartSignificance, FStateChartSignificanceDelegate, const IStateChartExecutor&);
+
+/*
+ * Drives StateChart executors of a world.
+ * Owns timer wheel shared by all executors created through it, so delayed events and timed transitions of the whole world are advanced together.
+ * Owns event bus those executors are attached to, so world-wide events reach only executors that may react to them.
+ * Messages sent between executors through its messenger are delivered at the start of Tick, before events of registered executors are processed.
+ * Events of registered executors are processed during Tick within FrameBudgetMilliseconds, so bursts of events are spread across frames.
+ * Executors of lower significance are processed every few frames, so their events are batched and coalesced by queue policies of their assets
+ */
+UCLASS(Config = Game)
+class DRUSTATECHART_API UStateChartSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* Creates default executor that uses timer wheel and event bus of this world */
+    TSharedRef<IStateChartExecutor> CreateExecutor(UStateChartAsset& StateChartAsset, TObjectPtr<UObject> ContextObject = nullptr);
+
+    /* Returns pool of executors for given asset. Its executors use timer wheel and event bus of this world */
+    FStateChartExecutorPool& GetExecutorPool(UStateChartAsset& StateChartAsset);
+
+    /* Defers processing of events of Executor to Tick of this subsystem. Executor is unregistered automatically when destroyed */
+    void RegisterExecutor(const TSharedRef<IStateChartExecutor>& Executor);
+
+    /* Processes all events still queued in Executor and returns it to immediate processing */
+    void UnregisterExecutor(const TSharedRef<IStateChartExecutor>& Executor);
+
+    /* Processes events of registered executors in round-robin order until they are out of events or budget is spent */
+    void PumpExecutors(double BudgetSeconds);
+
+    void SetFrameBudgetMilliseconds(float InFrameBudgetMilliseconds) { FrameBudgetMilliseconds = InFrameBudgetMilliseconds; }
+
+    /* Sets how often executors of given significance are processed. High significance is always processed every frame */
+    void SetSignificanceInterval(EStateChartSignificance Significance, int32 NumFrames);
+
+    /*
+     * Sets callback that updates significance of registered executors. It is called for at most MaxSignificanceUpdatesPerFrame executors each frame.
+     * Alternatively, significance may be pushed by calling IStateChartExecutor::SetSignificance directly
+     */
+    void SetSignificanceCallback(FStateChartSignificanceDelegate InSignificanceCallback) { SignificanceCallback = MoveTemp(InSignificanceCallback); }
+
+    const TSharedRef<FStateChartTimerWheel>& GetTimerWheel() const { return TimerWheel; }
+
+    /* Broadcasts events to executors of this world that may react to them */
+    FStateChartEventBus& GetEventBus() const { return *EventBus; }
+
+    /* Delivers messages between executors of this world. Executors are addressed by handles returned by FStateChartMessenger::Register */
+    FStateChartMessenger& GetMessenger() const { return *Messenger; }
+    const FStateChartSchedulerStats& GetSchedulerStats() const { return SchedulerStats; }
+
+    static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+    // Begin UTickableWorldSubsystem overrides
+    void Tick(float DeltaTime) override;
+    TStatId GetStatId() const override;
+    //~End UTickableWorldSubsystem overrides
+
+private:
+    struct FDueExecutor
+    {
+        TSharedPtr<IStateChartExecutor> Executor;
+        int32 Index;
+    };
+
+    /* Returns true if executor at given index of Executors should be processed this frame */
+    bool IsDue(EStateChartSignificance Significance, int32 ExecutorIndex) const;
+
+    void UpdateSignificance();
+
+    /* Time available for processing events of registered executors each frame */
+    UPROPERTY(Config)
+    float FrameBudgetMilliseconds = 2.f;
+
+    /* Number of frames between processing events of Medium and Low significance executors */
+    UPROPERTY(Config)
+    int32 MediumSignificanceInterval = 2;
+
+    UPROPERTY(Config)
+    int32 LowSignificanceInterval = 8;
+
+    /* Limits number of SignificanceCallback calls, so significance of many executors is updated over several frames */
+    UPROPERTY(Config)
+    int32 MaxSignificanceUpdatesPerFrame = 1024;
+
+    FStateChartSignificanceDelegate SignificanceCallback;
+    int32 NextSignificanceIndex = 0;
+
+    TSharedRef<FStateChartTimerWheel> TimerWheel = MakeShared<FStateChartTimerWheel>();
+    TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+    TSharedRef<FStateChartMessenger> Messenger = MakeShared<FStateChartMessenger>();
+
+    TMap<const UStateChartAsset*, TSharedRef<FStateChartExecutorPool>> ExecutorPools;
+
+    TArray<TWeakPtr<IStateChartExecutor>> Executors;
+
+    // executor that is pumped first next frame, so backlog of one executor does not starve the others
+    int32 NextExecutorIndex = 0;
+
+    // executors with events that are processed during current frame. kept to reuse allocation
+    TArray<FDueExecutor> DueExecutors;
+    uint32 FrameCounter = 0;
+
+    FStateChartSchedulerStats SchedulerStats;
+};
@@ -0,0 +1,97 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "StateChartTypes.h"
+#include "Containers/Array.h"
+#include "Templates/SharedPointer.h"
+
+class IStateChartExecutor;
+
+/* Timer delivered to its executor by FStateChartTimerWheel */
+struct FStateChartExpiredTimer
+{
+    FStateChartTimerHandle Handle;
+    uint32 Cookie;
+};
+
+/*
+ * Hierarchical timing wheel shared by a group of executors. Used for delayed events and timed transitions.
+ * Scheduling and cancelling timers are O(1). Expired timers are delivered to their executors in batches once per Advance.
+ * Delays are rounded up to TickInterval
+ */
+class DRUSTATECHART_API FStateChartTimerWheel
+{
+public:
+    explicit FStateChartTimerWheel(double InTickInterval = 1.0 / 60.0);
+
+    /* Schedules timer of Owner. Cookie is passed back to Owner when timer expires. Owner must be stored inside TSharedRef */
+    FStateChartTimerHandle Schedule(IStateChartExecutor& Owner, uint32 Cookie, double DelaySeconds);
+
+    /* Removes pending timer. Returns false if it has already expired or was cancelled */
+    bool Cancel(const FStateChartTimerHandle& Handle);
+
+    /* Returns cookie of pending timer or nullptr if it has already expired or was cancelled */
+    const uint32* FindCookie(const FStateChartTimerHandle& Handle) const;
+
+    /* Advances time and delivers expired timers to executors that are still alive */
+    void Advance(double DeltaSeconds);
+
+    int32 GetNumTimers() const { return NumTimers; }
+    double GetTickInterval() const { return TickInterval; }
+
+private:
+    static constexpr int32 NumLevels = 4;
+    static constexpr int32 SlotBits = 6;
+    static constexpr int32 NumSlots = 1 << SlotBits;
+
+    struct FTimer
+    {
+        TWeakPtr<IStateChartExecutor> Owner;
+        uint64 DueTick = 0;
+        uint64 Sequence = 0;
+        uint32 Cookie = 0;
+        uint32 Serial = 0;
+
+        // intrusive list of slot or free list. Slot is INDEX_NONE for free timers
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        int32 Slot = INDEX_NONE;
+    };
+
+    struct FPendingDelivery
+    {
+        TSharedPtr<IStateChartExecutor> Owner;
+        uint64 DueTick;
+        uint64 Sequence;
+        FStateChartExpiredTimer Timer;
+    };
+
+    void ProcessTick();
+
+    /* Moves timers of given level slot, which starts at CurrentTick, to lower levels */
+    void Cascade(int32 Level);
+
+    /* Puts timer to the slot matching its DueTick */
+    void Link(int32 TimerIndex);
+    void Unlink(int32 TimerIndex);
+
+    /* Detaches all timers of the slot and returns the first of them */
+    int32 DetachSlot(int32 Slot);
+
+    void Free(int32 TimerIndex);
+
+    TArray<FTimer> Timers;
+    int32 FirstFree = INDEX_NONE;
+    int32 NumTimers = 0;
+
+    int32 Slots[NumLevels * NumSlots];
+
+    double TickInterval;
+    double AccumulatedTime = 0.0;
+    uint64 CurrentTick = 0;
+    uint64 NextSequence = 0;
+
+    TArray<FPendingDelivery> PendingDeliveries;
+    bool bDelivering = false;
+};
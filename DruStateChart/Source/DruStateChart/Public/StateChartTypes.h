@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "StructView.h"
 #include "StateChartTypes.generated.h"
 
 /* Determines when next Action in the list is executed */
@@ -28,6 +29,41 @@ enum class EHistoryType : uint8
     Deep,
 };
 
+/* Determines which event is discarded when event queue is full */
+UENUM()
+enum class EStateChartQueueOverflow : uint8
+{
+    /* Incoming event is discarded */
+    DropNewest,
+    /* Oldest queued event is discarded to make room for incoming one */
+    DropOldest,
+};
+
+/* Determines how often scheduler processes events of an executor */
+UENUM()
+enum class EStateChartSignificance : uint8
+{
+    /* Every frame */
+    High,
+    /* Every MediumSignificanceInterval frames of UStateChartSubsystem */
+    Medium,
+    /* Every LowSignificanceInterval frames of UStateChartSubsystem */
+    Low,
+};
+
+/* Kind of edit made to a State or Transition definition. Used to patch assembled nodes incrementally */
+enum class EStateChartElementChange : uint8
+{
+    Added,
+    Removed,
+    /* SortOrder or SourceState changed */
+    Reordered,
+    /* ParentID of the state changed */
+    Reparented,
+    /* Any other property changed */
+    Modified,
+};
+
 class IStateChartExecutor;
 
 /*
@@ -50,4 +86,168 @@ struct FStateChartExecutionContext
 
     /* Optional object passed from FStateChartExecutor. You may use it to pass any game specific data */
     TObjectPtr<UObject> ContextObject;
+
+    /* Datamodel owned by executor. Its layout is declared by StateChart asset. Access it via FStateChartDatamodelSlot */
+    FStructView Datamodel;
+};
+
+/*
+ * Identifies timer scheduled in FStateChartTimerWheel
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartTimerHandle
+{
+    GENERATED_BODY()
+
+public:
+    bool IsValid() const { return Index != INDEX_NONE; }
+
+    friend bool operator== (const FStateChartTimerHandle& A, const FStateChartTimerHandle& B)
+    {
+        return A.Index == B.Index && A.Serial == B.Serial;
+    }
+
+    friend bool operator!= (const FStateChartTimerHandle& A, const FStateChartTimerHandle& B)
+    {
+        return !(A == B);
+    }
+
+    UPROPERTY()
+    int32 Index = INDEX_NONE;
+
+    UPROPERTY()
+    uint32 Serial = 0;
+};
+
+/*
+ * Addresses executor registered in FStateChartMessenger. Handle of unregistered executor never resolves again
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartExecutorHandle
+{
+    GENERATED_BODY()
+
+public:
+    bool IsValid() const { return Index != INDEX_NONE; }
+
+    friend bool operator== (const FStateChartExecutorHandle& A, const FStateChartExecutorHandle& B)
+    {
+        return A.Index == B.Index && A.Serial == B.Serial;
+    }
+
+    friend bool operator!= (const FStateChartExecutorHandle& A, const FStateChartExecutorHandle& B)
+    {
+        return !(A == B);
+    }
+
+    UPROPERTY()
+    int32 Index = INDEX_NONE;
+
+    UPROPERTY()
+    uint32 Serial = 0;
+};
+
+/*
+ * Queueing rules for events of a single type.
+ * Applies to events queued while executor is busy. Events sent by Actions are never dropped or coalesced
+ */
+USTRUCT()
+struct DRUSTATECHART_API FStateChartEventQueuePolicy
+{
+    GENERATED_BODY()
+
+public:
+    /* Type of events this policy applies to. Derived types are not included */
+    UPROPERTY(EditAnywhere)
+    TObjectPtr<const UScriptStruct> EventType;
+
+    /* Maximum number of queued events of this type. Zero means unlimited */
+    UPROPERTY(EditAnywhere, meta = (ClampMin = 0))
+    int32 Capacity = 0;
+
+    UPROPERTY(EditAnywhere)
+    EStateChartQueueOverflow Overflow = EStateChartQueueOverflow::DropOldest;
+
+    /* Only the latest value of this event matters. Incoming event replaces payload of the queued one, keeping its position in the queue */
+    UPROPERTY(EditAnywhere)
+    bool bCoalesce = false;
+
+    /* Event cannot wait for scheduler. It is processed right away together with events queued before it, even by executors that defer processing */
+    UPROPERTY(EditAnywhere)
+    bool bCritical = false;
+};
+
+/*
+ * Execution counters of an executor.
+ * Macrostep is processing of one event together with all eventless transitions enabled by it.
+ * Microstep is a single set of transitions taken together
+ */
+struct FStateChartExecutorStats
+{
+    /* Number of processed macrosteps */
+    int32 NumMacrosteps = 0;
+
+    /* Number of taken microsteps */
+    int32 NumMicrosteps = 0;
+
+    /* Number of microsteps taken by the last macrostep */
+    int32 LastMacrostepMicrosteps = 0;
+
+    /* Largest number of microsteps taken by a single macrostep */
+    int32 MaxMacrostepMicrosteps = 0;
+
+    /* Number of macrosteps stopped because eventless transitions were still enabled after MaxEventlessMicrosteps */
+    int32 NumEventlessLimitHits = 0;
+
+    /* Number of evaluated eventless transitions */
+    int32 NumEventlessEvaluations = 0;
+
+    /* Number of eventless transitions skipped by Update, because none of their dependencies changed */
+    int32 NumEventlessEvaluationsAvoided = 0;
+
+    /* Number of Update calls that returned without evaluating anything */
+    int32 NumIdleUpdates = 0;
+
+    /* Number of times executor gave up waiting for asynchronous Actions and continued without them */
+    int32 NumActionTimeouts = 0;
+
+    /* Largest number of events waiting in external and internal queues */
+    int32 MaxExternalQueueDepth = 0;
+    int32 MaxInternalQueueDepth = 0;
+
+    /* Number of queued events discarded because their queue was full */
+    int32 NumDroppedEvents = 0;
+
+    /* Number of incoming events merged into already queued event of the same type */
+    int32 NumCoalescedEvents = 0;
+};
+
+/*
+ * Counters of UStateChartSubsystem describing its last frame
+ */
+struct FStateChartSchedulerStats
+{
+    /* Time spent processing events of registered executors during last frame */
+    double LastFrameSeconds = 0.0;
+
+    /* Number of macrosteps processed during last frame */
+    int32 LastFrameMacrosteps = 0;
+
+    /* Number of events left for next frames */
+    int32 Backlog = 0;
+
+    /* Largest Backlog left at the end of a frame */
+    int32 MaxBacklog = 0;
+
+    /* Number of frames that ran out of budget before all events were processed */
+    int32 NumBudgetOverruns = 0;
+};
+
+/*
+ * Data available to Conditions and Actions when StateChart is assembled
+ */
+struct FStateChartCompileContext
+{
+    /* Layout of executor Datamodel. May be null if StateChart has no variables */
+    const UScriptStruct* DatamodelType = nullptr;
 };
\ No newline at end of file
@@ -57,4 +57,11 @@ public:
      * Override this method if your Object does not require asynchronous execution.
      */
     virtual void StateExited(const FStateChartExecutionContext& Context) {}
+
+    /*
+     * Seconds executor waits for Done of StateEnteredAsync and StateExitedAsync before continuing without it.
+     * Zero means default timeout of StateChart is used
+     */
+    UPROPERTY(EditAnywhere, meta = (ClampMin = 0, Units = "s"))
+    float Timeout = 0.f;
 };
\ No newline at end of file
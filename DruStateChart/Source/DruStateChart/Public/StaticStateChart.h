@@ -0,0 +1,263 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "Impl/StaticStateChartImpl.h"
+#include "Misc/AssertionMacros.h"
+#include "Templates/UnrealTemplate.h"
+
+/*
+ * StateChart declared entirely in C++ types. It does not create any UObjects and all node tables are computed at compile time.
+ * Follows the same semantics as FStateChartDefaultExecutor, but supports only a subset of its features:
+ *  - Compound and Atomic states. No Parallel, History or Final states and no StateHandlers
+ *  - Events are matched by exact C++ type
+ *  - Guards and Actions are static functions and complete synchronously
+ *  - Initial transitions have no actions
+ *  - Events cannot be sent from inside Actions
+ *
+ * Example:
+ *  struct FRoot : TStaticState<> {};
+ *  struct FIdle : TStaticState<FRoot> { static void OnEnter(FMyContext& Context) {} };
+ *  struct FRunning : TStaticState<FRoot> {};
+ *  struct FStart : TStaticTransition<FIdle, FStartEvent, FRunning> { static bool Guard(FMyContext& Context, const FStartEvent& Event) { return true; } };
+ *
+ *  using FMyChart = TStaticStateChart<FMyContext, TStaticStates<FRoot, FIdle, FRunning>, TStaticTransitions<FStart>>;
+ *  TStaticStateChartExecutor<FMyChart> Executor(Context);
+ */
+
+/*
+ * Base for static states. Root state has no Parent and must be listed first.
+ * When Initial is not set, first listed child is used.
+ * Derived types may declare static OnEnter and OnExit functions accepting Context
+ */
+template <typename TParent = void, typename TInitial = void>
+struct TStaticState
+{
+    using FParent = TParent;
+    using FInitial = TInitial;
+
+    template <typename TContext>
+    static void OnEnter(TContext& Context) {}
+
+    template <typename TContext>
+    static void OnExit(TContext& Context) {}
+};
+
+/*
+ * Base for static transitions. Transition without Target does not change active states.
+ * Transitions of the same state are checked in the order they are listed.
+ * Derived types may declare static Guard and Action functions accepting Context and Event
+ */
+template <typename TSource, typename TEvent, typename TTarget = void>
+struct TStaticTransition
+{
+    using FSource = TSource;
+    using FEvent = TEvent;
+    using FTarget = TTarget;
+
+    template <typename TContext>
+    static bool Guard(TContext& Context, const TEvent& Event) { return true; }
+
+    template <typename TContext>
+    static void Action(TContext& Context, const TEvent& Event) {}
+};
+
+template <typename... TStates>
+struct TStaticStates {};
+
+template <typename... TTransitions>
+struct TStaticTransitions {};
+
+template <typename TContext, typename TStateList, typename TTransitionList>
+struct TStaticStateChart;
+
+/* Definition of static StateChart. Validates it and holds its node tables */
+template <typename TInContext, typename... TStates, typename... TTransitions>
+struct TStaticStateChart<TInContext, TStaticStates<TStates...>, TStaticTransitions<TTransitions...>>
+{
+    using FContext = TInContext;
+
+    static constexpr int32 NumStates = sizeof...(TStates);
+
+    template <typename T>
+    static constexpr int32 IndexOf = DruStateChart_Impl::StaticIndexOf<T, TStates...>();
+
+    static_assert(NumStates > 0, "StateChart must have at least one state");
+    static_assert(((DruStateChart_Impl::StaticCountOf<TStates, TStates...>() == 1) && ...), "Each state must be listed once");
+    static_assert(((std::is_void_v<typename TStates::FParent> || IndexOf<typename TStates::FParent> != INDEX_NONE) && ...), "Parent state is not listed");
+    static_assert(((std::is_void_v<typename TStates::FInitial> || IndexOf<typename TStates::FInitial> != INDEX_NONE) && ...), "Initial state is not listed");
+    static_assert((0 + ... + (std::is_void_v<typename TStates::FParent> ? 1 : 0)) == 1, "StateChart must have exactly one root state");
+    static_assert(((IndexOf<typename TTransitions::FSource> != INDEX_NONE) && ...), "Transition source state is not listed");
+    static_assert(((std::is_void_v<typename TTransitions::FTarget> || IndexOf<typename TTransitions::FTarget> != INDEX_NONE) && ...), "Transition target state is not listed");
+
+    static constexpr int32 ParentIndexes[] = { IndexOf<typename TStates::FParent>... };
+    static constexpr int32 ExplicitInitialIndexes[] = { IndexOf<typename TStates::FInitial>... };
+
+    static constexpr DruStateChart_Impl::TStaticStateTables<NumStates> Tables = DruStateChart_Impl::MakeStaticStateTables(ParentIndexes, ExplicitInitialIndexes);
+
+    static_assert(Tables.bRootIsFirst, "Root state must be listed first");
+    static_assert(Tables.bAcyclic, "States have cyclic parent references");
+    static_assert(Tables.bInitialIsChild, "Initial state must be a direct child");
+
+    // root has no parent to serve as transition domain. root is listed first, so its index is 0
+    static_assert(((IndexOf<typename TTransitions::FTarget> != 0) && ...), "Transition cannot target root state");
+
+    /* Calls Func with TStaticType of state at given index */
+    template <typename TFunc>
+    static void VisitState(int32 StateIndex, TFunc&& Func)
+    {
+        ((StateIndex == IndexOf<TStates> ? (Func(DruStateChart_Impl::TStaticType<TStates>()), true) : false) || ...);
+    }
+
+    /* Calls Func with TStaticType of each transition in listed order, until it returns true */
+    template <typename TFunc>
+    static bool VisitTransitions(TFunc&& Func)
+    {
+        return (Func(DruStateChart_Impl::TStaticType<TTransitions>()) || ...);
+    }
+};
+
+/*
+ * Executes static StateChart over given Context.
+ * Only one Atomic state is active at a time, so configuration is stored as its index
+ */
+template <typename TChart>
+class TStaticStateChartExecutor
+{
+public:
+    using FContext = typename TChart::FContext;
+
+    explicit TStaticStateChartExecutor(FContext& InContext)
+        : Context(InContext)
+    {
+    }
+
+    /* Enters initial configuration */
+    void Execute()
+    {
+        TGuardValue<bool> Guard(bExecutingTransition, true);
+        EnterStates(INDEX_NONE, 0);
+    }
+
+    /* Executes Event with provided payload. Returns true if any transition was taken */
+    template <typename TEvent>
+    bool ExecuteEvent(const TEvent& Event)
+    {
+        checkf(!bExecutingTransition, TEXT("Static StateChart does not support sending Events from its Actions"));
+        TGuardValue<bool> Guard(bExecutingTransition, true);
+
+        // same as in default executor: Atomic state is checked first, then its ancestors
+        for (int32 StateIndex = ActiveStateIndex; StateIndex != INDEX_NONE; StateIndex = TChart::Tables.ParentIndex[StateIndex])
+        {
+            const bool bTaken = TChart::VisitTransitions([&](auto Type)
+            {
+                return TryTransition<typename decltype(Type)::Type>(StateIndex, Event);
+            });
+
+            if (bTaken)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Executes Event of requested type with default payload */
+    template <typename TEvent>
+    bool ExecuteEvent()
+    {
+        return ExecuteEvent(TEvent());
+    }
+
+    /* Returns true if given state or any of its descendants is active */
+    template <typename TState>
+    bool IsActive() const
+    {
+        constexpr int32 TestedIndex = TChart::template IndexOf<TState>;
+        static_assert(TestedIndex != INDEX_NONE, "State is not listed in StateChart");
+
+        for (int32 StateIndex = ActiveStateIndex; StateIndex != INDEX_NONE; StateIndex = TChart::Tables.ParentIndex[StateIndex])
+        {
+            if (StateIndex == TestedIndex)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Returns index of active Atomic state in TStaticStates list */
+    int32 GetActiveStateIndex() const { return ActiveStateIndex; }
+
+private:
+    template <typename TTransition, typename TEvent>
+    bool TryTransition(int32 StateIndex, const TEvent& Event)
+    {
+        if constexpr (std::is_same_v<typename TTransition::FEvent, TEvent>)
+        {
+            constexpr int32 SourceIndex = TChart::template IndexOf<typename TTransition::FSource>;
+            constexpr int32 TargetIndex = TChart::template IndexOf<typename TTransition::FTarget>;
+
+            if (StateIndex == SourceIndex && TTransition::Guard(Context, Event))
+            {
+                if constexpr (TargetIndex == INDEX_NONE)
+                {
+                    TTransition::Action(Context, Event);
+                }
+                else
+                {
+                    constexpr int32 DomainIndex = DruStateChart_Impl::GetStaticTransitionDomain(TChart::Tables, SourceIndex, TargetIndex);
+
+                    ExitStates(DomainIndex);
+                    TTransition::Action(Context, Event);
+                    EnterStates(DomainIndex, TargetIndex);
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /* Exits active states up to, but not including DomainIndex, deepest first */
+    void ExitStates(int32 DomainIndex)
+    {
+        for (int32 StateIndex = ActiveStateIndex; StateIndex != DomainIndex; StateIndex = TChart::Tables.ParentIndex[StateIndex])
+        {
+            TChart::VisitState(StateIndex, [&](auto Type) { decltype(Type)::Type::OnExit(Context); });
+        }
+    }
+
+    /* Enters states from DomainIndex (exclusive) down to TargetIndex and then its initial descendants */
+    void EnterStates(int32 DomainIndex, int32 TargetIndex)
+    {
+        int32 Path[TChart::NumStates];
+        int32 PathLength = 0;
+
+        for (int32 StateIndex = TargetIndex; StateIndex != DomainIndex; StateIndex = TChart::Tables.ParentIndex[StateIndex])
+        {
+            Path[PathLength++] = StateIndex;
+        }
+
+        while (PathLength > 0)
+        {
+            TChart::VisitState(Path[--PathLength], [&](auto Type) { decltype(Type)::Type::OnEnter(Context); });
+        }
+
+        int32 StateIndex = TargetIndex;
+        while (TChart::Tables.InitialIndex[StateIndex] != INDEX_NONE)
+        {
+            StateIndex = TChart::Tables.InitialIndex[StateIndex];
+            TChart::VisitState(StateIndex, [&](auto Type) { decltype(Type)::Type::OnEnter(Context); });
+        }
+
+        ActiveStateIndex = StateIndex;
+    }
+
+    FContext& Context;
+    int32 ActiveStateIndex = INDEX_NONE;
+    bool bExecutingTransition = false;
+};
@@ -9,6 +9,7 @@ void SStatesView::Construct(const FArguments& Args, TObjectPtr<UStateChartAsset>
     StateChart = InStateChart;
 
     BuildTreeData();
+    InStateChart->OnElementChanged().AddSP(this, &ThisClass::OnElementChanged);
 
     ChildSlot
     [
@@ -26,21 +27,84 @@ void SStatesView::BuildTreeData()
 {
     RootStates.Reset();
     TreeData.Reset();
+    ParentLookup.Reset();
 
-    auto& Nodes = StateChart->GetAssembledNodes();
+    // make sure nodes are assembled before iterating states
+    StateChart->GetAssembledNodes();
 
     for (auto State : StateChart->AllStates)
     {
-        if (!State->ParentID.IsValid())
+        // empty entries are added by details panel before an element is picked
+        if (State != nullptr)
         {
-            RootStates.Add(State);
+            AddTreeItem(State);
         }
-        else
+    }
+}
+
+void SStatesView::AddTreeItem(UBaseStateDefinition* State)
+{
+    if (!State->ParentID.IsValid())
+    {
+        RootStates.Add(State);
+    }
+    else
+    {
+        UBaseStateDefinition* Parent = StateChart->GetAssembledNodes().StateIDToDefinition.FindRef(State->ParentID);
+
+        TArray<UBaseStateDefinition*>& Siblings = TreeData.FindOrAdd(Parent);
+        Siblings.Add(State);
+
+        ParentLookup.Emplace(State, Parent);
+    }
+}
+
+void SStatesView::RemoveTreeItem(UBaseStateDefinition* State)
+{
+    UBaseStateDefinition* Parent = nullptr;
+    if (ParentLookup.RemoveAndCopyValue(State, Parent))
+    {
+        if (TArray<UBaseStateDefinition*>* Siblings = TreeData.Find(Parent))
         {
-            TArray<UBaseStateDefinition*>& Siblings = TreeData.FindOrAdd(Nodes.StateIDToDefinition[State->ParentID]);
-            Siblings.Add(State);
+            Siblings->Remove(State);
         }
     }
+    else
+    {
+        RootStates.Remove(State);
+    }
+}
+
+void SStatesView::OnElementChanged(UStateChartElementAsset* Element, EStateChartElementChange Change)
+{
+    UBaseStateDefinition* State = Cast<UBaseStateDefinition>(Element);
+    if (State == nullptr)
+    {
+        return;
+    }
+
+    // patch only affected items instead of rebuilding whole tree
+    switch (Change)
+    {
+        case EStateChartElementChange::Added:
+            AddTreeItem(State);
+            break;
+
+        case EStateChartElementChange::Removed:
+            RemoveTreeItem(State);
+            TreeData.Remove(State);
+            break;
+
+        case EStateChartElementChange::Reparented:
+            RemoveTreeItem(State);
+            AddTreeItem(State);
+            break;
+
+        default:
+            return;
+    }
+
+    TreeView->RequestTreeRefresh();
 }
 
 TSharedRef<ITableRow> SStatesView::MakeRow(UBaseStateDefinition* Item, const TSharedRef<STableViewBase>& OwnerTable)
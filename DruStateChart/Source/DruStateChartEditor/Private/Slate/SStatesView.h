@@ -24,6 +24,9 @@ public:
 
 private:
     void BuildTreeData();
+    void AddTreeItem(UBaseStateDefinition* State);
+    void RemoveTreeItem(UBaseStateDefinition* State);
+    void OnElementChanged(UStateChartElementAsset* Element, EStateChartElementChange Change);
 
     TSharedRef<ITableRow> MakeRow(UBaseStateDefinition* Item, const TSharedRef<STableViewBase>& OwnerTable);
     void GetStateChildren(UBaseStateDefinition* Item, TArray<UBaseStateDefinition*>& OutChildren);
@@ -33,4 +36,5 @@ private:
     TSharedPtr<SStatesTreeView> TreeView;
     TArray<UBaseStateDefinition*> RootStates;
     TMap<UBaseStateDefinition*, TArray<UBaseStateDefinition*>> TreeData;
+    TMap<UBaseStateDefinition*, UBaseStateDefinition*> ParentLookup;
 };
\ No newline at end of file
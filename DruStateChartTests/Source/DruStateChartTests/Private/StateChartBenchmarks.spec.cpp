@@ -0,0 +1,557 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Impl/StateChartNodes.h"
+#include "Impl/StateChartElements.h"
+#include "Impl/StateChartDefaultExecutor.h"
+#include "Impl/StateChartExecutorRegistry.h"
+#include "Impl/StateChartFlatExecutor.h"
+#include "Interfaces/IStateChartExecutor.h"
+#include "StateChartAsset.h"
+#include "StateChartBuilder.h"
+#include "StateChartExecutorPool.h"
+#include "StateChartExpressionCondition.h"
+#include "StateChartSubsystem.h"
+#include "StaticStateChart.h"
+#include "Algo/AllOf.h"
+#include "UObject/StrongObjectPtr.h"
+
+#include "TestContext.h"
+#include "TestEvents.h"
+
+namespace StateChartBenchmarks
+{
+    struct FRingContext {};
+    struct FRingRoot : TStaticState<> {};
+
+    template <int32 Index>
+    struct TRingState : TStaticState<FRingRoot> {};
+
+    template <int32 Index, int32 NumStates>
+    struct TRingTransition : TStaticTransition<TRingState<Index>, FTestEvent, TRingState<(Index + 1) % NumStates>> {};
+
+    /* Static version of BuildRingChart */
+    template <typename TSequence>
+    struct TRingChart;
+
+    template <int32... Indexes>
+    struct TRingChart<TIntegerSequence<int32, Indexes...>>
+    {
+        using Type = TStaticStateChart<FRingContext, TStaticStates<FRingRoot, TRingState<Indexes>...>, TStaticTransitions<TRingTransition<Indexes, sizeof...(Indexes)>...>>;
+    };
+}
+
+BEGIN_DEFINE_SPEC(FStateChartBenchmarksSpec, "DruStateChart.Benchmarks", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::PerfFilter)
+
+void GenerateStates(int32 NumStates, int32 Seed, TArray<TObjectPtr<UBaseStateDefinition>>& OutStates, TArray<TObjectPtr<UTransitionDefinition>>& OutTransitions) const;
+
+TObjectPtr<UStateChartAsset> BuildRingChart(FStateChartBuilder& Builder, int32 NumStates) const;
+TObjectPtr<UStateChartAsset> BuildFeatureChart(FStateChartBuilder& Builder, int32 NumStates, DruStateChart_Impl::EStateChartFeatures Features) const;
+
+template <typename TFunc>
+double MeasureSeconds(int32 NumIterations, TFunc&& Func) const;
+
+END_DEFINE_SPEC(FStateChartBenchmarksSpec)
+
+void FStateChartBenchmarksSpec::Define()
+{
+    using namespace DruStateChart_Impl;
+
+    Describe("Assembly", [this]
+    {
+        It("Should Assemble 50k States", [this]
+        {
+            TArray<TObjectPtr<UBaseStateDefinition>> AllStates;
+            TArray<TObjectPtr<UTransitionDefinition>> AllTransitions;
+            GenerateStates(50000, 123, AllStates, AllTransitions);
+
+            FStateChartNodes Nodes;
+            const double Seconds = MeasureSeconds(5, [&] { Nodes.CreateNodes(AllStates, AllTransitions); });
+
+            AddInfo(FString::Printf(TEXT("Assembly of %d states and %d transitions: %.2f ms"), AllStates.Num(), AllTransitions.Num(), Seconds * 1000.0));
+
+            TestEqual("Num States", Nodes.StateNodes.Num(), AllStates.Num());
+            TestEqual("Num Transitions", Nodes.TransitionNodes.Num(), AllTransitions.Num());
+
+            // verify layout invariants used by executor
+            bool bLayoutValid = true;
+            for (int32 StateIndex = 0; StateIndex < Nodes.StateNodes.Num(); ++StateIndex)
+            {
+                const FStateNode& Node = Nodes.StateNodes[StateIndex];
+                bLayoutValid &= StateIndex == 0 || Node.ParentIndex < FIndex(StateIndex);
+
+                for (int32 ChildIndex = Node.ChildIndex; ChildIndex < Node.ChildIndex + Node.NumChildren; ++ChildIndex)
+                {
+                    bLayoutValid &= Nodes.StateNodes[ChildIndex].ParentIndex == FIndex(StateIndex);
+                }
+
+                for (int32 TransitionIndex = Node.TransitionIndex; TransitionIndex < Node.TransitionIndex + Node.NumTransitions; ++TransitionIndex)
+                {
+                    bLayoutValid &= Nodes.TransitionNodes[TransitionIndex].SourceNodeIndex == FIndex(StateIndex);
+                }
+            }
+
+            TestTrue("Layout Valid", bLayoutValid);
+        });
+    });
+
+    Describe("Execution", [this]
+    {
+        It("Flat Table vs Default Executor", [this]
+        {
+            constexpr int32 NumEvents = 100000;
+
+            FStateChartBuilder Builder;
+            Builder.CompileFlatTable();
+            TObjectPtr<UStateChartAsset> StateChart = BuildRingChart(Builder, 16);
+
+            TSharedRef<IStateChartExecutor> DefaultExecutor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+            TSharedRef<IStateChartExecutor> FlatExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            TestNotNull("Flat Table", StateChart->GetFlatTable());
+
+            DefaultExecutor->Execute();
+            FlatExecutor->Execute();
+
+            auto SendEvents = [&](IStateChartExecutor& Executor)
+            {
+                for (int32 Index = 0; Index < NumEvents; ++Index)
+                {
+                    Executor.ExecuteEvent<FTestEvent>();
+                }
+            };
+
+            const double DefaultSeconds = MeasureSeconds(3, [&] { SendEvents(*DefaultExecutor); });
+            const double FlatSeconds = MeasureSeconds(3, [&] { SendEvents(*FlatExecutor); });
+
+            AddInfo(FString::Printf(TEXT("%d events. Default: %.2f ms, Flat Table: %.2f ms"), NumEvents, DefaultSeconds * 1000.0, FlatSeconds * 1000.0));
+        });
+
+        It("Static vs Default Executor", [this]
+        {
+            using namespace StateChartBenchmarks;
+            using FStaticRingChart = TRingChart<TMakeIntegerSequence<int32, 16>>::Type;
+
+            constexpr int32 NumEvents = 100000;
+
+            FStateChartBuilder Builder;
+            TObjectPtr<UStateChartAsset> StateChart = BuildRingChart(Builder, 16);
+
+            TSharedRef<IStateChartExecutor> DefaultExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+            DefaultExecutor->Execute();
+
+            FRingContext Context;
+            TStaticStateChartExecutor<FStaticRingChart> StaticExecutor(Context);
+            StaticExecutor.Execute();
+
+            const double DefaultSeconds = MeasureSeconds(3, [&]
+            {
+                for (int32 Index = 0; Index < NumEvents; ++Index)
+                {
+                    DefaultExecutor->ExecuteEvent<FTestEvent>();
+                }
+            });
+
+            const double StaticSeconds = MeasureSeconds(3, [&]
+            {
+                for (int32 Index = 0; Index < NumEvents; ++Index)
+                {
+                    StaticExecutor.ExecuteEvent<FTestEvent>();
+                }
+            });
+
+            AddInfo(FString::Printf(TEXT("%d events. Default: %.2f ms, Static: %.2f ms"), NumEvents, DefaultSeconds * 1000.0, StaticSeconds * 1000.0));
+            TestEqual("Static Ring Position", StaticExecutor.GetActiveStateIndex(), 1 + (NumEvents * 3) % 16);
+        });
+
+        It("Specialized vs Default Executor", [this]
+        {
+            constexpr int32 NumEvents = 100000;
+
+            const TPair<const TCHAR*, EStateChartFeatures> Variants[] =
+            {
+                { TEXT("None"), EStateChartFeatures::None },
+                { TEXT("History"), EStateChartFeatures::History },
+                { TEXT("Parallel"), EStateChartFeatures::Parallel },
+                { TEXT("Conditions"), EStateChartFeatures::Conditions },
+                { TEXT("Parallel + Conditions"), EStateChartFeatures::Parallel | EStateChartFeatures::Conditions },
+            };
+
+            for (const auto& Variant : Variants)
+            {
+                FStateChartBuilder Builder;
+                TObjectPtr<UStateChartAsset> StateChart = BuildFeatureChart(Builder, 16, Variant.Value);
+
+                TestTrue(FString::Printf(TEXT("%s Features"), Variant.Key), StateChart->GetAssembledNodes().Features == Variant.Value);
+
+                TSharedRef<IStateChartExecutor> DefaultExecutor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+                TSharedRef<IStateChartExecutor> SpecializedExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+
+                DefaultExecutor->Execute();
+                SpecializedExecutor->Execute();
+
+                auto SendEvents = [&](IStateChartExecutor& Executor)
+                {
+                    for (int32 Index = 0; Index < NumEvents; ++Index)
+                    {
+                        Executor.ExecuteEvent<FTestEvent>();
+                    }
+                };
+
+                const double DefaultSeconds = MeasureSeconds(3, [&] { SendEvents(*DefaultExecutor); });
+                const double SpecializedSeconds = MeasureSeconds(3, [&] { SendEvents(*SpecializedExecutor); });
+
+                AddInfo(FString::Printf(TEXT("%s: %d events. Default: %.2f ms, Specialized: %.2f ms"), Variant.Key, NumEvents, DefaultSeconds * 1000.0, SpecializedSeconds * 1000.0));
+            }
+        });
+
+        It("10k Executors At Mixed Significance", [this]
+        {
+            constexpr int32 NumExecutors = 10000;
+            constexpr int32 NumFrames = 32;
+            constexpr int32 EventsPerFrame = 4;
+
+            // only the latest event matters, so batched executors process one of them per visit
+            FStateChartBuilder Builder;
+            Builder.EventQueuePolicy<FTestEvent>(0, EStateChartQueueOverflow::DropOldest, true);
+            TObjectPtr<UStateChartAsset> StateChart = BuildRingChart(Builder, 16);
+
+            auto RunFrames = [&](bool bMixedSignificance, int32& OutMacrosteps)
+            {
+                UStateChartSubsystem* Subsystem = NewObject<UStateChartSubsystem>();
+
+                TArray<TSharedRef<IStateChartExecutor>> Executors;
+                for (int32 Index = 0; Index < NumExecutors; ++Index)
+                {
+                    TSharedRef<IStateChartExecutor> Executor = Subsystem->CreateExecutor(*StateChart);
+                    Subsystem->RegisterExecutor(Executor);
+                    Executor->SetSignificance(bMixedSignificance ? static_cast<EStateChartSignificance>(Index % 3) : EStateChartSignificance::High);
+                    Executor->Execute();
+                    Executors.Add(Executor);
+                }
+
+                double PumpSeconds = 0.0;
+                OutMacrosteps = 0;
+
+                for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+                {
+                    for (const TSharedRef<IStateChartExecutor>& Executor : Executors)
+                    {
+                        for (int32 Index = 0; Index < EventsPerFrame; ++Index)
+                        {
+                            Executor->ExecuteEvent<FTestEvent>();
+                        }
+                    }
+
+                    Subsystem->PumpExecutors(1.0);
+
+                    PumpSeconds += Subsystem->GetSchedulerStats().LastFrameSeconds;
+                    OutMacrosteps += Subsystem->GetSchedulerStats().LastFrameMacrosteps;
+                }
+
+                return PumpSeconds / NumFrames;
+            };
+
+            int32 HighMacrosteps = 0;
+            int32 MixedMacrosteps = 0;
+
+            const double HighSeconds = RunFrames(false, HighMacrosteps);
+            const double MixedSeconds = RunFrames(true, MixedMacrosteps);
+
+            TestTrue("Fewer Macrosteps", MixedMacrosteps < HighMacrosteps);
+            AddInfo(FString::Printf(TEXT("%d executors, %d events per frame each. All High: %.2f ms per frame (%d macrosteps), Mixed: %.2f ms per frame (%d macrosteps)"),
+                NumExecutors, EventsPerFrame, HighSeconds * 1000.0, HighMacrosteps, MixedSeconds * 1000.0, MixedMacrosteps));
+        });
+
+        It("Spawn Waves With Pool vs CreateDefault", [this]
+        {
+            constexpr int32 NumExecutors = 2000;
+            constexpr int32 NumWaves = 5;
+
+            FStateChartBuilder Builder;
+            TObjectPtr<UStateChartAsset> StateChart = BuildRingChart(Builder, 16);
+
+            TArray<TSharedRef<IStateChartExecutor>> Executors;
+            Executors.Reserve(NumExecutors);
+
+            const double CreateSeconds = MeasureSeconds(NumWaves, [&]
+            {
+                for (int32 Index = 0; Index < NumExecutors; ++Index)
+                {
+                    TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+                    Executor->Execute();
+                    Executors.Add(Executor);
+                }
+
+                Executors.Reset();
+            });
+
+            FStateChartExecutorPool Pool(*StateChart);
+            Pool.Reserve(NumExecutors);
+
+            const double PoolSeconds = MeasureSeconds(NumWaves, [&]
+            {
+                for (int32 Index = 0; Index < NumExecutors; ++Index)
+                {
+                    TSharedRef<IStateChartExecutor> Executor = Pool.Acquire();
+                    Executor->Execute();
+                    Executors.Add(Executor);
+                }
+
+                for (const TSharedRef<IStateChartExecutor>& Executor : Executors)
+                {
+                    Pool.Release(Executor);
+                }
+
+                Executors.Reset();
+            });
+
+            TestEqual("Executors Created By Pool", Pool.GetNumCreated(), NumExecutors);
+            AddInfo(FString::Printf(TEXT("%d executors spawned and despawned. CreateDefault: %.2f ms, Pool: %.2f ms"), NumExecutors, CreateSeconds * 1000.0, PoolSeconds * 1000.0));
+        });
+
+        It("Expression vs Hand-Written Conditions", [this]
+        {
+            constexpr int32 NumEvaluations = 1000000;
+
+            UTestContextObject* Object = NewObject<UTestContextObject>();
+            Object->Health = 0.1f;
+            Object->bHasAmmo = true;
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children(Builder.State("a"));
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart, Object);
+            FStateChartExecutionContext Context(*Executor, Object);
+
+            // conditions are stored and called the same way transitions do
+            TArray<FInstancedStruct> HandWritten = { FInstancedStruct::Make(FTestLowHealthCondition()), FInstancedStruct::Make(FTestHasAmmoCondition()) };
+            TArray<FInstancedStruct> Expression = { FInstancedStruct::Make(FStateChartExpressionCondition("Health < 0.3 && bHasAmmo", UTestContextObject::StaticClass())) };
+            Expression[0].GetMutable<FStateChartExpressionCondition>().Compile(FStateChartCompileContext{});
+
+            auto Evaluate = [&](const TArray<FInstancedStruct>& Conditions)
+            {
+                int32 NumPassed = 0;
+                for (int32 Index = 0; Index < NumEvaluations; ++Index)
+                {
+                    NumPassed += Algo::AllOf(Conditions, [&](const FInstancedStruct& Struct) { return Struct.Get<FStateChartCondition>().Evaluate(Context, FConstStructView()); });
+                }
+                return NumPassed;
+            };
+
+            int32 HandWrittenPassed = 0;
+            int32 ExpressionPassed = 0;
+
+            const double HandWrittenSeconds = MeasureSeconds(3, [&] { HandWrittenPassed = Evaluate(HandWritten); });
+            const double ExpressionSeconds = MeasureSeconds(3, [&] { ExpressionPassed = Evaluate(Expression); });
+
+            TestEqual("Same Results", ExpressionPassed, HandWrittenPassed);
+            AddInfo(FString::Printf(TEXT("%d evaluations. Hand-Written: %.2f ms, Expression: %.2f ms"), NumEvaluations, HandWrittenSeconds * 1000.0, ExpressionSeconds * 1000.0));
+        });
+    });
+
+    Describe("Memory", [this]
+    {
+        It("Idle Executor Footprint", [this]
+        {
+            constexpr int32 NumExecutors = 10000;
+
+            // generous bounds, they catch inline storage or eager allocations creeping back into executors
+            constexpr int32 MaxDefaultExecutorSize = 1024;
+            constexpr int32 MaxFlatExecutorSize = 512;
+            constexpr double MaxBytesPerExecutor = 4096.0;
+
+            FStateChartBuilder Builder;
+            TObjectPtr<UStateChartAsset> StateChart = BuildRingChart(Builder, 16);
+
+            TArray<TSharedRef<IStateChartExecutor>> Executors;
+            Executors.Reserve(NumExecutors);
+
+            const uint64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+            for (int32 Index = 0; Index < NumExecutors; ++Index)
+            {
+                TSharedRef<IStateChartExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+                Executor->Execute();
+                Executor->ExecuteEvent<FTestEvent>();
+                Executors.Add(Executor);
+            }
+
+            const uint64 UsedAfter = FPlatformMemory::GetStats().UsedPhysical;
+            const double BytesPerExecutor = UsedAfter > UsedBefore ? double(UsedAfter - UsedBefore) / NumExecutors : 0.0;
+
+            TestTrue("Executors Are Idle", Algo::AllOf(Executors, [](const TSharedRef<IStateChartExecutor>& Executor) { return Executor->GetNumQueuedEvents() == 0; }));
+            TestTrue("Default Executor Size", int32(sizeof(FStateChartDefaultExecutor)) <= MaxDefaultExecutorSize);
+            TestTrue("Flat Executor Size", int32(sizeof(FStateChartFlatExecutor)) <= MaxFlatExecutorSize);
+            TestTrue("Bytes Per Idle Executor", BytesPerExecutor <= MaxBytesPerExecutor);
+            AddInfo(FString::Printf(TEXT("sizeof Default Executor: %d bytes, sizeof Flat Executor: %d bytes. %d idle executors use %.0f bytes each"),
+                int32(sizeof(FStateChartDefaultExecutor)), int32(sizeof(FStateChartFlatExecutor)), NumExecutors, BytesPerExecutor));
+        });
+    });
+
+    Describe("Garbage Collection", [this]
+    {
+        It("Reachability With 10k Executors", [this]
+        {
+            constexpr int32 NumExecutors = 10000;
+
+            // reproduces previous layout, where every executor was a separate FGCObject reporting its asset too
+            struct FPerExecutorReferencer : FGCObject
+            {
+                explicit FPerExecutorReferencer(const TSharedRef<IStateChartExecutor>& InExecutor) : Executor(InExecutor), Asset(InExecutor->GetExecutingAsset()) {}
+
+                void AddReferencedObjects(FReferenceCollector& Collector) override
+                {
+                    Collector.AddReferencedObject(Asset);
+                    Executor->AddReferencedObjects(Collector);
+                }
+
+                FString GetReferencerName() const override { return TEXT("PerExecutorReferencer"); }
+
+                TSharedRef<IStateChartExecutor> Executor;
+                TObjectPtr<UStateChartAsset> Asset;
+            };
+
+            auto Collect = [] { CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true); };
+
+            // baseline collection runs before any executor references the asset, so it is kept alive by the test
+            FStateChartBuilder Builder;
+            TStrongObjectPtr<UStateChartAsset> StateChart(BuildRingChart(Builder, 16));
+
+            const double BaselineSeconds = MeasureSeconds(3, Collect);
+
+            TArray<TSharedRef<IStateChartExecutor>> Executors;
+            Executors.Reserve(NumExecutors);
+
+            for (int32 Index = 0; Index < NumExecutors; ++Index)
+            {
+                TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+                Executor->Execute();
+                Executor->ExecuteEvent<FTestEvent>();
+                Executors.Add(Executor);
+            }
+
+            const double RegistrySeconds = MeasureSeconds(3, Collect);
+
+            TArray<TUniquePtr<FPerExecutorReferencer>> Referencers;
+            Referencers.Reserve(NumExecutors);
+
+            for (const TSharedRef<IStateChartExecutor>& Executor : Executors)
+            {
+                Referencers.Add(MakeUnique<FPerExecutorReferencer>(Executor));
+            }
+
+            // registry still reports executors here, so this is an upper bound of previous cost
+            const double PerExecutorSeconds = MeasureSeconds(3, Collect);
+
+            TestTrue("Executors Are Registered", FStateChartExecutorRegistry::Get().GetNumExecutors() >= NumExecutors);
+            AddInfo(FString::Printf(TEXT("Full collection with %d executors: %.2f ms with registry, %.2f ms with per-executor referencers, %.2f ms without executors"),
+                NumExecutors, RegistrySeconds * 1000.0, PerExecutorSeconds * 1000.0, BaselineSeconds * 1000.0));
+        });
+    });
+}
+
+void FStateChartBenchmarksSpec::GenerateStates(int32 NumStates, int32 Seed, TArray<TObjectPtr<UBaseStateDefinition>>& OutStates, TArray<TObjectPtr<UTransitionDefinition>>& OutTransitions) const
+{
+    FRandomStream Stream(Seed);
+
+    OutStates.Reset(NumStates);
+    OutTransitions.Reset(NumStates);
+
+    for (int32 Index = 0; Index < NumStates; ++Index)
+    {
+        UCompoundStateDefinition* State = NewObject<UCompoundStateDefinition>();
+        State->FriendlyName = LexToString(Index);
+        State->SortOrder = Stream.FRand();
+
+        if (Index > 0)
+        {
+            // random recursive tree, its depth grows logarithmically
+            State->ParentID = OutStates[Stream.RandRange(0, Index - 1)]->ID;
+
+            UTransitionDefinition* Transition = NewObject<UTransitionDefinition>();
+            Transition->SourceState = State->ID;
+            Transition->SortOrder = Stream.FRand();
+            Transition->TargetStates.Add(OutStates[Stream.RandRange(0, Index - 1)]->ID);
+            OutTransitions.Add(Transition);
+        }
+
+        OutStates.Add(State);
+    }
+
+    // assembly must not depend on input order
+    for (int32 Index = OutStates.Num() - 1; Index > 0; --Index)
+    {
+        OutStates.Swap(Index, Stream.RandRange(0, Index));
+    }
+}
+
+TObjectPtr<UStateChartAsset> FStateChartBenchmarksSpec::BuildRingChart(FStateChartBuilder& Builder, int32 NumStates) const
+{
+    // each FTestEvent moves chart to the next state in a ring
+    for (int32 Index = 0; Index < NumStates; ++Index)
+    {
+        Builder.Root().Child
+        (
+            Builder.State(LexToString(Index)).Children
+            (
+                Builder.Transition().Target(LexToString((Index + 1) % NumStates)).Event<FTestEvent>()
+            )
+        );
+    }
+
+    return Builder.Build();
+}
+
+TObjectPtr<UStateChartAsset> FStateChartBenchmarksSpec::BuildFeatureChart(FStateChartBuilder& Builder, int32 NumStates, DruStateChart_Impl::EStateChartFeatures Features) const
+{
+    using namespace DruStateChart_Impl;
+
+    const bool bParallel = EnumHasAnyFlags(Features, EStateChartFeatures::Parallel);
+    const FString RingPath = bParallel ? TEXT("p.ring.") : TEXT("ring.");
+
+    // same ring as in BuildRingChart, but nested into a state, so it may get History or parallel sibling
+    auto& Ring = Builder.State("ring");
+    for (int32 Index = 0; Index < NumStates; ++Index)
+    {
+        auto& Transition = Builder.Transition().Target(RingPath + LexToString((Index + 1) % NumStates)).Event<FTestEvent>();
+        if (EnumHasAnyFlags(Features, EStateChartFeatures::Conditions))
+        {
+            Transition.Condition(FTestCondition());
+        }
+
+        Ring.Child(Builder.State(LexToString(Index)).Children(Transition));
+    }
+
+    if (EnumHasAnyFlags(Features, EStateChartFeatures::History))
+    {
+        Ring.Child(Builder.History("h"));
+    }
+
+    if (bParallel)
+    {
+        Builder.Root().Child(Builder.Parallel("p").Children(Ring, Builder.State("idle")));
+    }
+    else
+    {
+        Builder.Root().Child(Ring);
+    }
+
+    return Builder.Build();
+}
+
+template <typename TFunc>
+double FStateChartBenchmarksSpec::MeasureSeconds(int32 NumIterations, TFunc&& Func) const
+{
+    double BestTime = TNumericLimits<double>::Max();
+
+    for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+        Func();
+        BestTime = FMath::Min(BestTime, FPlatformTime::Seconds() - StartTime);
+    }
+
+    return BestTime;
+}
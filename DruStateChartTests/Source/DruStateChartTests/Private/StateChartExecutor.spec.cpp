@@ -4,18 +4,35 @@
 #include "Impl/StateChartNodes.h"
 #include "Impl/StateChartElements.h"
 #include "Impl/StateChartDefaultExecutor.h"
+#include "Impl/StateChartExecutorRegistry.h"
+#include "Impl/StateChartFlatExecutor.h"
 #include "StateChartAsset.h"
 #include "StateChartBuilder.h"
+#include "StateChartDatamodel.h"
 #include "StateChartEvent.h"
+#include "StateChartEventBus.h"
+#include "StateChartExecutorPool.h"
+#include "StateChartExpressionCondition.h"
+#include "StateChartMessenger.h"
+#include "StateChartSubsystem.h"
+#include "StateChartTimerWheel.h"
+#include "Algo/Transform.h"
+#include "NativeGameplayTags.h"
 
 #include "TestActions.h"
+#include "TestContext.h"
 #include "TestEvents.h"
 #include "TestStateHandler.h"
 
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Move, "DruStateChart.Test.Move");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Move_Left, "DruStateChart.Test.Move.Left");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Move_Left_Fast, "DruStateChart.Test.Move.Left.Fast");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Test_Other, "DruStateChart.Test.Other");
+
 BEGIN_DEFINE_SPEC(FStateChartExecutorSpec, "DruStateChart.StateChart Executor", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
 
-bool TestActive(const FString& State, const DruStateChart_Impl::FStateChartDefaultExecutor& Executor);
-bool TestNotActive(const FString& State, const DruStateChart_Impl::FStateChartDefaultExecutor& Executor);
+bool TestActive(const FString& State, const IStateChartExecutor& Executor);
+bool TestNotActive(const FString& State, const IStateChartExecutor& Executor);
 
 END_DEFINE_SPEC(FStateChartExecutorSpec)
 
@@ -351,6 +368,43 @@ void FStateChartExecutorSpec::Define()
             TestTrue("Event is Valid", InstancedHandler->EnterEvent.IsValid());
             TestEqual("Event Name", InstancedHandler->EnterEvent.Get<FTestEvent>().Name, FName("TestEvent"));
         });
+
+        It("Should Create New StateHandlers On Reentry", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Handler<UTestStateHandler>().Children // <-- this will be initial state
+                (
+                    Builder.Transition().Event<FTestEvent>().Target("b")
+                ),
+                Builder.State("b").Handler<UTestStateHandler>().Children
+                (
+                    Builder.Transition().Event<FTestEvent>().Target("a")
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartDefaultExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+
+            TArray<UTestStateHandler*> InstancedHandlers;
+            Executor->OnStateHandlerCreated().AddLambda([&](UStateHandler& InHandler)
+            {
+                InstancedHandlers.Add(Cast<UTestStateHandler>(&InHandler));
+            });
+
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            if (TestEqual("Num Handlers", InstancedHandlers.Num(), 3))
+            {
+                TestTrue("First 'a' Exited", InstancedHandlers[0]->bExitedCalled);
+                TestTrue("'b' Exited", InstancedHandlers[1]->bExitedCalled);
+                TestFalse("Second 'a' Exited", InstancedHandlers[2]->bExitedCalled);
+                TestTrue("Handlers Are Distinct", InstancedHandlers[0] != InstancedHandlers[2]);
+            }
+        });
     });
 
     Describe("Actions", [this]
@@ -559,6 +613,45 @@ void FStateChartExecutorSpec::Define()
 
             TestActive("c", *Executor); // should be restored by History state "h", due to it being 'deep'
         });
+
+        It("Should Forget History When Stopped", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("temp").Children // <-- this will be initial state
+                (
+                    Builder.Transition().Target("s.h").Event<FTestEvent>()
+                ),
+                Builder.State("s").Children
+                (
+                    Builder.State("a"),
+                    Builder.State("b"),
+                    Builder.History("h").Initial("a"),
+
+                    Builder.Transition().Target("s.b").Event<FTestEvent>()
+                ),
+
+                Builder.Transition().Target("temp").Event<FTestOtherEvent>()
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartDefaultExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>(); // enters "a" by default transition of "h"
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->ExecuteEvent<FTestOtherEvent>(); // records "b"
+            Executor->ExecuteEvent<FTestEvent>();
+
+            TestActive("b", *Executor);
+
+            Executor->Stop();
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            TestActive("a", *Executor); // recorded "b" is discarded by Stop
+        });
     });
 
     Describe("Event Queue", [this]
@@ -684,15 +777,1795 @@ void FStateChartExecutorSpec::Define()
             TestActive("root", *Executor);
             TestActive("d", *Executor);
         });
+
+        It("Should Coalesce Queued Events Of Same Type", [this]
+        {
+            TSharedPtr<FSimpleDelegate> Trigger = MakeShared<FSimpleDelegate>();
+            FTestAsyncAction Action(Trigger);
+
+            FStateChartBuilder Builder;
+            Builder.EventQueuePolicy<FTestEvent>(0, EStateChartQueueOverflow::DropOldest, true);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children // <-- this will be initial state
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(Action)
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("err").Event<FTestEvent>().Condition(FTestCondition("First")),
+                    Builder.Transition().Target("c").Event<FTestEvent>().Condition(FTestCondition("Last"))
+                ),
+                Builder.State("c"),
+                Builder.State("err")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartDefaultExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->ExecuteEvent(FTestEvent("First"));
+            Executor->ExecuteEvent(FTestEvent("Last")); // <-- replaces payload of the queued event
+
+            Trigger->ExecuteIfBound();
+
+            TestActive("c", *Executor);
+            TestNotActive("err", *Executor);
+
+            const FStateChartExecutorStats Stats = Executor->GetStats();
+            TestEqual("Coalesced Events", Stats.NumCoalescedEvents, 1);
+            TestEqual("Queue Depth", Stats.MaxExternalQueueDepth, 1);
+        });
+
+        It("Should Drop Events When Queue Is Full", [this]
+        {
+            TSharedPtr<FSimpleDelegate> Trigger = MakeShared<FSimpleDelegate>();
+            FTestAsyncAction Action(Trigger);
+
+            FStateChartBuilder Builder;
+            Builder.EventQueue(1, EStateChartQueueOverflow::DropNewest);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children // <-- this will be initial state
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(Action)
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestEvent>().Condition(FTestCondition("First")),
+                    Builder.Transition().Target("err").Event<FTestOtherEvent>()
+                ),
+                Builder.State("c"),
+                Builder.State("err")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartDefaultExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->ExecuteEvent(FTestEvent("First"));
+            Executor->ExecuteEvent<FTestOtherEvent>(); // <-- does not fit into the queue
+
+            Trigger->ExecuteIfBound();
+
+            TestActive("c", *Executor);
+            TestNotActive("err", *Executor);
+            TestEqual("Dropped Events", Executor->GetStats().NumDroppedEvents, 1);
+        });
+    });
+
+    Describe("Tag Events", [this]
+    {
+        It("Should Match Tags Through Hierarchy", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").EventTag(TAG_Test_Move_Left, true),
+                    Builder.Transition().Target("a").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("c").Children
+                (
+                    Builder.Transition().Target("a").Event<FStateChartGenericEvent>().Condition(FStateChartGenericEventCondition(TAG_Test_Other))
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            // unreferenced tag matches its closest parent
+            Executor->ExecuteEvent(FStateChartGenericEvent(TAG_Test_Move_Left_Fast));
+            TestActive("b", *Executor);
+
+            // exact match does not accept child tags
+            Executor->ExecuteEvent(FStateChartGenericEvent(TAG_Test_Move_Left_Fast));
+            TestActive("a", *Executor);
+
+            Executor->ExecuteEvent(FStateChartGenericEvent(TAG_Test_Move_Left));
+            Executor->ExecuteEvent(FStateChartGenericEvent(TAG_Test_Move_Left));
+            TestActive("c", *Executor);
+
+            // unrelated tag is ignored by tag triggers, but still checked by conditions
+            Executor->ExecuteEvent(FStateChartGenericEvent(TAG_Test_Move));
+            TestActive("c", *Executor);
+
+            Executor->ExecuteEvent(FStateChartGenericEvent(TAG_Test_Other));
+            TestActive("a", *Executor);
+        });
+
+        It("Should Index Candidates By Tag", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Move_Left),
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Other)
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("a").EventTag(TAG_Test_Move, true)
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            const FStateChartTagIndex& TagIndex = StateChart->GetAssembledNodes().TagIndex;
+
+            TestEqual("Move.Left.Fast Candidates", TagIndex.FindCandidates(TAG_Test_Move_Left_Fast).Num(), 1);
+            TestEqual("Move Candidates", TagIndex.FindCandidates(TAG_Test_Move).Num(), 1);
+            TestEqual("Other Candidates", TagIndex.FindCandidates(TAG_Test_Other).Num(), 1);
+            TestEqual("Invalid Tag Candidates", TagIndex.FindCandidates(FGameplayTag()).Num(), 0);
+        });
+
+        It("Should Execute Tag Events Without Payload", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("b").Children
+                (
+                    // condition receives payload created from tag
+                    Builder.Transition().Target("c").Event<FStateChartGenericEvent>().Condition(FStateChartGenericEventCondition(TAG_Test_Other))
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            Executor->ExecuteTagEvent(TAG_Test_Move_Left);
+            TestActive("b", *Executor);
+
+            Executor->ExecuteTagEvent(TAG_Test_Move);
+            TestActive("b", *Executor);
+
+            Executor->ExecuteTagEvent(TAG_Test_Other);
+            TestActive("c", *Executor);
+        });
+
+        It("Should Keep Order Of Queued Tag And Struct Events", [this]
+        {
+            TSharedPtr<FSimpleDelegate> Trigger = MakeShared<FSimpleDelegate>();
+            FTestAsyncAction Action(Trigger);
+
+            FTestCallbackAction EventAction([&](const FStateChartExecutionContext& Context)
+            {
+                // both events will be put in internal event queue
+                Context.Executor.ExecuteTagEvent(TAG_Test_Move);
+                Context.Executor.ExecuteEvent(FTestEvent("Event1"));
+            });
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(Action).Action(EventAction)
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").EventTag(TAG_Test_Move),
+                    Builder.Transition().Target("err").Event<FTestEvent>()
+                ),
+                Builder.State("c").Children
+                (
+                    Builder.Transition().Target("d").Event<FTestEvent>().Condition(FTestCondition("Event1"))
+                ),
+                Builder.State("d"),
+                Builder.State("err")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            TestNotActive("c", *Executor);
+
+            Trigger->ExecuteIfBound();
+
+            TestActive("d", *Executor);
+            TestNotActive("err", *Executor);
+        });
+    });
+
+    Describe("Expression Conditions", [this]
+    {
+        It("Should Drive Transitions", [this]
+        {
+            UTestContextObject* Object = NewObject<UTestContextObject>();
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Condition(FStateChartExpressionCondition("Health < 0.3 && bHasAmmo", UTestContextObject::StaticClass()))
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart, Object);
+            Executor->Execute();
+
+            Object->Health = 0.1f;
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("a", *Executor);
+
+            Object->bHasAmmo = true;
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("b", *Executor);
+        });
+
+        It("Should Fail With Wrong Context", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Condition(FStateChartExpressionCondition("true", UTestContextObject::StaticClass()))
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart, StateChart);
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            TestActive("a", *Executor);
+        });
+    });
+
+    Describe("Eventless Transitions", [this]
+    {
+        It("Should Take Eventless Transitions Before Next Event", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b") // <-- taken right after initial state is entered
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestEvent>()
+                ),
+                Builder.State("c").Children
+                (
+                    Builder.Transition().Target("e").Condition(FTestPureCondition(false, nullptr)),
+                    Builder.Transition().Target("d")
+                ),
+                Builder.State("d"),
+                Builder.State("e")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            Executor->Execute();
+            TestActive("b", *Executor);
+            TestEqual("Initial Microsteps", Executor->GetStats().LastMacrostepMicrosteps, 2);
+
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("d", *Executor);
+            TestNotActive("e", *Executor);
+
+            const FStateChartExecutorStats Stats = Executor->GetStats();
+            TestEqual("Macrosteps", Stats.NumMacrosteps, 2);
+            TestEqual("Microsteps", Stats.NumMicrosteps, 4);
+            TestEqual("Event Microsteps", Stats.LastMacrostepMicrosteps, 2);
+        });
+
+        It("Should Stop Endless Eventless Loop", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b"),
+                    Builder.Transition().Target("c").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("a")
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            AddExpectedError(TEXT("eventless transitions in a row"), EAutomationExpectedErrorFlags::Contains, 1);
+            Executor->Execute();
+
+            const FStateChartExecutorStats Stats = Executor->GetStats();
+            TestEqual("Limit Hits", Stats.NumEventlessLimitHits, 1);
+            TestEqual("Microsteps", Stats.LastMacrostepMicrosteps, StateChart->GetMaxEventlessMicrosteps() + 1);
+
+            // MaxEventlessMicrosteps is even, so loop stops in a
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("c", *Executor);
+        });
+    });
+
+    Describe("Timers", [this]
+    {
+        It("Should Take Timed Transition After Delay", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").After(1.0f)
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartTimerWheel> TimerWheel = MakeShared<FStateChartTimerWheel>(0.1);
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetTimerWheel(TimerWheel);
+            Executor->Execute();
+
+            TimerWheel->Advance(0.95);
+            TestActive("a", *Executor);
+
+            TimerWheel->Advance(0.2);
+            TestActive("b", *Executor);
+            TestEqual("Pending Timers", TimerWheel->GetNumTimers(), 0);
+        });
+
+        It("Should Cancel Timeout When State Exits", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("c").After(1.0f),
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("a").Event<FTestEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartTimerWheel> TimerWheel = MakeShared<FStateChartTimerWheel>(0.1);
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetTimerWheel(TimerWheel);
+            Executor->Execute();
+
+            TimerWheel->Advance(0.6);
+            Executor->ExecuteEvent<FTestEvent>();
+            TestEqual("Pending Timers", TimerWheel->GetNumTimers(), 0);
+
+            // timeout starts over when state is entered again
+            Executor->ExecuteEvent<FTestEvent>();
+            TimerWheel->Advance(0.6);
+            TestActive("a", *Executor);
+
+            TimerWheel->Advance(0.6);
+            TestActive("c", *Executor);
+        });
+
+        It("Should Execute Delayed Events", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartTimerWheel> TimerWheel = MakeShared<FStateChartTimerWheel>(0.1);
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetTimerWheel(TimerWheel);
+            Executor->Execute();
+
+            const FStateChartTimerHandle Cancelled = Executor->ExecuteEventDelayed(FTestEvent(), 0.5f);
+            Executor->ExecuteEventDelayed(FTestEvent(), 1000.0f); // <-- far beyond first levels of the wheel
+            Executor->CancelDelayedEvent(Cancelled);
+
+            TimerWheel->Advance(1.0);
+            TestActive("a", *Executor);
+
+            for (int32 Second = 1; Second < 999; ++Second)
+            {
+                TimerWheel->Advance(1.0);
+            }
+            TestActive("a", *Executor);
+
+            TimerWheel->Advance(1.1);
+            TestActive("b", *Executor);
+        });
+    });
+
+    Describe("Action Timeouts", [this]
+    {
+        It("Should Continue Without Action After Timeout", [this]
+        {
+            TSharedPtr<FSimpleDelegate> Trigger = MakeShared<FSimpleDelegate>();
+            FTestAsyncAction Action(Trigger);
+            Action.Timeout = 1.0f;
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(Action)
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartTimerWheel> TimerWheel = MakeShared<FStateChartTimerWheel>(0.1);
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetTimerWheel(TimerWheel);
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            TimerWheel->Advance(0.5);
+            TestNotActive("b", *Executor);
+
+            AddExpectedError(TEXT("Continuing without them"), EAutomationExpectedErrorFlags::Contains, 1);
+            TimerWheel->Advance(0.6);
+
+            TestActive("b", *Executor);
+            TestEqual("Action Timeouts", Executor->GetStats().NumActionTimeouts, 1);
+
+            // late completion of abandoned action is ignored
+            Trigger->ExecuteIfBound();
+            TestActive("b", *Executor);
+        });
+
+        It("Should Cancel Timeout When Action Completes", [this]
+        {
+            TSharedPtr<FSimpleDelegate> Trigger = MakeShared<FSimpleDelegate>();
+            FTestAsyncAction Action(Trigger);
+            Action.Timeout = 1.0f;
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(Action)
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartTimerWheel> TimerWheel = MakeShared<FStateChartTimerWheel>(0.1);
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetTimerWheel(TimerWheel);
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            TestEqual("Pending Timers", TimerWheel->GetNumTimers(), 1);
+
+            Trigger->ExecuteIfBound();
+            TestActive("b", *Executor);
+            TestEqual("Pending Timers After Done", TimerWheel->GetNumTimers(), 0);
+
+            TimerWheel->Advance(2.0);
+            TestEqual("Action Timeouts", Executor->GetStats().NumActionTimeouts, 0);
+        });
+    });
+
+    Describe("Scheduling", [this]
+    {
+        It("Should Process Deferred Events In Pump", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetDeferredProcessing(true);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("a", *Executor);
+            TestEqual("Queued Events", Executor->GetNumQueuedEvents(), 2);
+
+            TestEqual("First Pump", Executor->Pump(1), 1);
+            TestActive("b", *Executor);
+
+            TestEqual("Second Pump", Executor->Pump(10), 1);
+            TestActive("c", *Executor);
+            TestEqual("Queued Events After Pump", Executor->GetNumQueuedEvents(), 0);
+        });
+
+        It("Should Keep Order Of Events Left By Pump", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestOtherEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetDeferredProcessing(true);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->SetDeferredProcessing(false);
+
+            // queued event goes first, even though this one is processed immediately
+            Executor->ExecuteEvent<FTestOtherEvent>();
+            TestActive("c", *Executor);
+        });
+
+        It("Should Share Budget Between Executors", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            UStateChartSubsystem* Subsystem = NewObject<UStateChartSubsystem>();
+
+            TSharedRef<IStateChartExecutor> Executor1 = Subsystem->CreateExecutor(*StateChart);
+            TSharedRef<IStateChartExecutor> Executor2 = Subsystem->CreateExecutor(*StateChart);
+            Subsystem->RegisterExecutor(Executor1);
+            Subsystem->RegisterExecutor(Executor2);
+            Executor1->Execute();
+            Executor2->Execute();
+
+            Executor1->ExecuteEvent<FTestEvent>();
+            Executor1->ExecuteEvent<FTestEvent>();
+            Executor2->ExecuteEvent<FTestEvent>();
+
+            Subsystem->PumpExecutors(10.0);
+            TestActive("c", *Executor1);
+            TestActive("b", *Executor2);
+
+            const FStateChartSchedulerStats& Stats = Subsystem->GetSchedulerStats();
+            TestEqual("Macrosteps", Stats.LastFrameMacrosteps, 3);
+            TestEqual("Backlog", Stats.Backlog, 0);
+
+            Subsystem->UnregisterExecutor(Executor2);
+            Executor2->ExecuteEvent<FTestEvent>();
+            TestActive("c", *Executor2);
+        });
+
+        It("Should Process Low Significance Executor Every Nth Frame", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            UStateChartSubsystem* Subsystem = NewObject<UStateChartSubsystem>();
+            Subsystem->SetSignificanceInterval(EStateChartSignificance::Low, 4);
+
+            TSharedRef<IStateChartExecutor> Executor = Subsystem->CreateExecutor(*StateChart);
+            Subsystem->RegisterExecutor(Executor);
+            Executor->SetSignificance(EStateChartSignificance::Low);
+            Executor->Execute();
+
+            Subsystem->PumpExecutors(10.0);
+            Executor->ExecuteEvent<FTestEvent>();
+
+            for (int32 Frame = 1; Frame < 4; ++Frame)
+            {
+                Subsystem->PumpExecutors(10.0);
+            }
+
+            TestActive("a", *Executor);
+            TestEqual("Backlog", Subsystem->GetSchedulerStats().Backlog, 1);
+
+            Subsystem->PumpExecutors(10.0);
+            TestActive("b", *Executor);
+        });
+
+        It("Should Process Critical Events Immediately", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.EventQueuePolicy<FTestOtherEvent>(0, EStateChartQueueOverflow::DropOldest, false, true);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestOtherEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetDeferredProcessing(true);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("a", *Executor);
+
+            // events queued before critical one are processed first
+            Executor->ExecuteEvent<FTestOtherEvent>();
+            TestActive("c", *Executor);
+        });
+
+        It("Should Process Critical Tag Events Immediately", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.EventQueuePolicy<FStateChartGenericEvent>(0, EStateChartQueueOverflow::DropOldest, false, true);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetDeferredProcessing(true);
+            Executor->Execute();
+
+            Executor->ExecuteTagEvent(TAG_Test_Move);
+            TestActive("b", *Executor);
+        });
+    });
+
+    Describe("Event Bus", [this]
+    {
+        It("Should Deliver Events Only To Interested Executors", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("a").Event<FTestOtherEvent>()
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+
+            TSharedRef<IStateChartExecutor> First = IStateChartExecutor::CreateDefault(*StateChart);
+            TSharedRef<IStateChartExecutor> Second = IStateChartExecutor::CreateDefault(*StateChart);
+            First->SetEventBus(EventBus);
+            Second->SetEventBus(EventBus);
+            First->Execute();
+            Second->Execute();
+
+            TestEqual("Delivered Other Event", EventBus->Broadcast(FTestOtherEvent()), 0);
+            TestEqual("Delivered Event", EventBus->Broadcast(FTestEvent()), 2);
+            TestActive("b", *First);
+            TestActive("b", *Second);
+
+            // both executors left the state reacting to FTestEvent
+            TestEqual("Interested In Event", EventBus->GetNumInterested(FTestEvent::StaticStruct()), 0);
+            TestEqual("Interested In Other Event", EventBus->GetNumInterested(FTestOtherEvent::StaticStruct()), 2);
+            TestEqual("Delivered Event Again", EventBus->Broadcast(FTestEvent()), 0);
+
+            TestEqual("Broadcasts", EventBus->GetStats().NumBroadcasts, 3);
+            TestEqual("Deliveries", EventBus->GetStats().NumDeliveries, int64(2));
+            TestEqual("Deliveries Avoided", EventBus->GetStats().NumDeliveriesAvoided, int64(4));
+            TestEqual("Max Fan Out", EventBus->GetStats().MaxFanOut, 2);
+        });
+
+        It("Should Deliver Derived Events To Parent Type Subscribers", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FStateChartAnyEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetEventBus(EventBus);
+            Executor->Execute();
+
+            TestEqual("Delivered Derived Event", EventBus->Broadcast(FTestDerivedEvent()), 1);
+            TestActive("b", *Executor);
+
+            TestEqual("Delivered Any Event", EventBus->Broadcast(FTestOtherEvent()), 1);
+            TestActive("c", *Executor);
+        });
+
+        It("Should Deliver Tag Events", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetEventBus(EventBus);
+            Executor->Execute();
+
+            TestEqual("Delivered Tag", EventBus->BroadcastTag(TAG_Test_Move_Left), 1);
+            TestActive("b", *Executor);
+        });
+
+        It("Should Deliver Tag Events Only To Executors Interested In Tag", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetEventBus(EventBus);
+            Executor->Execute();
+
+            TestEqual("Delivered Other Tag", EventBus->BroadcastTag(TAG_Test_Other), 0);
+            TestEqual("Delivered Parent Tag", EventBus->Broadcast(FStateChartGenericEvent(TAG_Test_Move)), 1);
+            TestActive("b", *Executor);
+        });
+
+        It("Should Deliver Events To Executors With Queued Events", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestOtherEvent>()
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetEventBus(EventBus);
+            Executor->Execute();
+            Executor->SetDeferredProcessing(true);
+            Executor->ExecuteEvent(FTestEvent());
+
+            // queued event moves executor to state reacting to this one
+            TestEqual("Delivered While Queued", EventBus->Broadcast(FTestOtherEvent()), 1);
+
+            Executor->Pump(MAX_int32);
+            TestActive("c", *Executor);
+            TestEqual("Delivered After Pump", EventBus->Broadcast(FTestOtherEvent()), 0);
+        });
+
+        It("Should Detach Destroyed Executors", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartEventBus> EventBus = MakeShared<FStateChartEventBus>();
+
+            {
+                TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+                Executor->SetEventBus(EventBus);
+                Executor->Execute();
+
+                TestEqual("Interested While Alive", EventBus->GetNumInterested(FTestEvent::StaticStruct()), 1);
+            }
+
+            TestEqual("Interested After Destruction", EventBus->GetNumInterested(FTestEvent::StaticStruct()), 0);
+            TestEqual("Executors After Destruction", EventBus->GetNumExecutors(), 0);
+        });
+    });
+
+    Describe("Messaging", [this]
+    {
+        It("Should Deliver Messages On Flush", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").EventTag(TAG_Test_Move)
+                ),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            FStateChartMessenger Messenger;
+            const FStateChartExecutorHandle Handle = Messenger.Register(*Executor);
+
+            TestTrue("Sent Event", Messenger.Send(Handle, FTestEvent()));
+            TestTrue("Sent Tag", Messenger.SendTag(Handle, TAG_Test_Move));
+            TestActive("a", *Executor);
+            TestEqual("Pending Messages", Messenger.GetNumPendingMessages(), 2);
+
+            TestEqual("Delivered Messages", Messenger.Flush(), 2);
+            TestActive("c", *Executor);
+            TestEqual("Pending Messages After Flush", Messenger.GetNumPendingMessages(), 0);
+            TestEqual("Messages Delivered", Messenger.GetStats().NumDelivered, int64(2));
+        });
+
+        It("Should Deliver Replies On Next Flush", [this]
+        {
+            FStateChartMessenger Messenger;
+            FStateChartExecutorHandle PingHandle;
+            FStateChartExecutorHandle PongHandle;
+
+            FStateChartBuilder PingBuilder;
+            PingBuilder.Root().Children
+            (
+                PingBuilder.State("a").Children
+                (
+                    PingBuilder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                PingBuilder.State("b").OnEnter(FTestCallbackAction([&] { Messenger.Send(PongHandle, FTestEvent()); }))
+            );
+
+            FStateChartBuilder PongBuilder;
+            PongBuilder.Root().Children
+            (
+                PongBuilder.State("a").Children
+                (
+                    PongBuilder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                PongBuilder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> PingChart = PingBuilder.Build();
+            TObjectPtr<UStateChartAsset> PongChart = PongBuilder.Build();
+            TSharedRef<IStateChartExecutor> Ping = IStateChartExecutor::CreateDefault(*PingChart);
+            TSharedRef<IStateChartExecutor> Pong = IStateChartExecutor::CreateDefault(*PongChart);
+            Ping->Execute();
+            Pong->Execute();
+
+            PingHandle = Messenger.Register(*Ping);
+            PongHandle = Messenger.Register(*Pong);
+
+            Messenger.Send(PingHandle, FTestEvent());
+
+            TestEqual("First Flush", Messenger.Flush(), 1);
+            TestActive("b", *Ping);
+            TestActive("a", *Pong);
+
+            TestEqual("Second Flush", Messenger.Flush(), 1);
+            TestActive("b", *Pong);
+        });
+
+        It("Should Reject Stale Handles", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            FStateChartMessenger Messenger;
+            const FStateChartExecutorHandle Handle = Messenger.Register(*Executor);
+            Messenger.Send(Handle, FTestEvent());
+            Messenger.Unregister(Handle);
+
+            const FStateChartExecutorHandle NewHandle = Messenger.Register(*Executor);
+            TestEqual("Slot Reused", NewHandle.Index, Handle.Index);
+            TestFalse("Resolved Stale Handle", Messenger.Resolve(Handle).IsValid());
+            TestFalse("Sent To Stale Handle", Messenger.Send(Handle, FTestEvent()));
+
+            TestEqual("Delivered Messages", Messenger.Flush(), 0);
+            TestActive("a", *Executor);
+            TestEqual("Dropped Messages", Messenger.GetStats().NumDropped, int64(1));
+        });
+    });
+
+    Describe("Executor Reuse", [this]
+    {
+        It("Should Exit States And Discard Events On Stop", [this]
+        {
+            int32 NumExits = 0;
+            FTestCallbackAction ExitAction([&] { NumExits += 1; });
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").OnExit(ExitAction).Children
+                (
+                    Builder.State("a1").OnExit(ExitAction).Children
+                    (
+                        Builder.Transition().Target("b").Event<FTestEvent>()
+                    )
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->SetDeferredProcessing(true);
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            Executor->Stop();
+            TestEqual("Exit Actions", NumExits, 2);
+            TestEqual("Active States", Executor->GetActiveStates().Num(), 0);
+            TestEqual("Queued Events", Executor->GetNumQueuedEvents(), 0);
+
+            Executor->Execute();
+            TestActive("a1", *Executor);
+        });
+
+        It("Should Restore Initial State On Reset", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Variable("Ammo", 1);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(FTestSetVariableAction("Ammo", 5))
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("b", *Executor);
+
+            UObject* NewContext = GetTransientPackage();
+            Executor->Reset(NewContext);
+
+            TestTrue("Context Object", Executor->GetContextObject() == NewContext);
+            TestEqual("Macrosteps", Executor->GetStats().NumMacrosteps, 0);
+
+            FStateChartCompileContext CompileContext;
+            CompileContext.DatamodelType = StateChart->GetDatamodel().GetPropertyBagStruct();
+
+            FStateChartDatamodelSlot Slot("Ammo");
+            Slot.Resolve<int32>(CompileContext);
+
+            FStateChartExecutionContext Context(*Executor, nullptr);
+            Context.Datamodel = Executor->GetDatamodel();
+            TestEqual("Ammo", Slot.Get<int32>(Context), 1);
+
+            Executor->Execute();
+            TestActive("a", *Executor);
+        });
+
+        It("Should Reuse Released Executors", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            FStateChartExecutorPool Pool(*StateChart);
+            Pool.Reserve(2);
+
+            TSharedRef<IStateChartExecutor> First = Pool.Acquire();
+            First->Execute();
+            First->ExecuteEvent<FTestEvent>();
+            TestActive("b", *First);
+
+            IStateChartExecutor* FirstPointer = &First.Get();
+            Pool.Release(First);
+            TestEqual("Pooled After Release", Pool.GetNumPooled(), 2);
+
+            TSharedRef<IStateChartExecutor> Second = Pool.Acquire();
+            TestTrue("Reused Executor", &Second.Get() == FirstPointer);
+            TestEqual("Active States Of Reused Executor", Second->GetActiveStates().Num(), 0);
+
+            Second->Execute();
+            TestActive("a", *Second);
+
+            TestEqual("Created", Pool.GetNumCreated(), 2);
+            TestEqual("Reused", Pool.GetNumReused(), 2);
+
+            Pool.Trim(0);
+            TestEqual("Pooled After Trim", Pool.GetNumPooled(), 0);
+        });
+    });
+
+    Describe("Condition Dependencies", [this]
+    {
+        It("Should Re-Evaluate Only Changed Eventless Transitions", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Variable("Ammo", 0);
+            Builder.Variable("Health", 1.0f);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("c").Condition(FStateChartExpressionCondition("Health < 0.5")),
+                    Builder.Transition().Target("b").Condition(FStateChartExpressionCondition("Ammo > 2"))
+                ),
+                Builder.State("b"),
+                Builder.State("c")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            Executor->Update();
+            Executor->Update();
+            TestActive("a", *Executor);
+            TestEqual("Idle Updates", Executor->GetStats().NumIdleUpdates, 2);
+            TestEqual("Evaluations", Executor->GetStats().NumEventlessEvaluations, 2);
+
+            FStateChartCompileContext CompileContext;
+            CompileContext.DatamodelType = StateChart->GetDatamodel().GetPropertyBagStruct();
+
+            FStateChartDatamodelSlot Slot("Ammo");
+            Slot.Resolve<int32>(CompileContext);
+
+            FStateChartExecutionContext Context(*Executor, nullptr);
+            Context.Datamodel = Executor->GetDatamodel();
+            Slot.Set(Context, 5);
+
+            // change is picked up on next Update only
+            TestActive("a", *Executor);
+
+            Executor->Update();
+            TestActive("b", *Executor);
+
+            const FStateChartExecutorStats Stats = Executor->GetStats();
+            TestEqual("Evaluations After Change", Stats.NumEventlessEvaluations, 3);
+            TestEqual("Avoided Evaluations", Stats.NumEventlessEvaluationsAvoided, 1);
+        });
+
+        It("Should Re-Evaluate Explicitly Invalidated Conditions", [this]
+        {
+            UTestContextObject* Object = NewObject<UTestContextObject>();
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Condition(FTestLowHealthCondition())
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart, Object);
+            Executor->Execute();
+
+            Object->Health = 0.1f;
+            Executor->Update();
+            TestActive("a", *Executor);
+            TestEqual("Idle Updates", Executor->GetStats().NumIdleUpdates, 1);
+
+            Executor->CreateInvalidationDelegate("Health").Execute();
+            Executor->Update();
+            TestActive("b", *Executor);
+        });
+
+        It("Should Poll Conditions Without Dependencies", [this]
+        {
+            UTestContextObject* Object = NewObject<UTestContextObject>();
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Condition(FTestHasAmmoCondition())
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestEqual("Polling Transitions", StateChart->GetAssembledNodes().DependencyIndex.PollingTransitions.Num(), 1);
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart, Object);
+            Executor->Execute();
+
+            Object->bHasAmmo = true;
+            Executor->Update();
+            TestActive("b", *Executor);
+            TestEqual("Idle Updates", Executor->GetStats().NumIdleUpdates, 0);
+        });
+    });
+
+    Describe("Guard Memoization", [this]
+    {
+        It("Should Evaluate Identical Pure Conditions Once Per Event", [this]
+        {
+            TSharedPtr<int32> Counter = MakeShared<int32>(0);
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.Parallel("p").Children
+                (
+                    Builder.State("a").Children
+                    (
+                        Builder.Transition().Event<FTestEvent>().Condition(FTestPureCondition(true, Counter))
+                    ),
+                    Builder.State("b").Children
+                    (
+                        Builder.Transition().Event<FTestEvent>().Condition(FTestPureCondition(true, Counter))
+                    ),
+                    Builder.State("c").Children
+                    (
+                        Builder.Transition().Event<FTestEvent>().Condition(FTestPureCondition(false, Counter)) // <-- different value, separate guard
+                    )
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestEqual("Num Guards", StateChart->GetAssembledNodes().GuardTable.NumGuards, 2);
+
+            TSharedRef<IStateChartExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestEvent>();
+            TestEqual("Evaluations After First Event", *Counter, 2);
+
+            Executor->ExecuteEvent<FTestEvent>();
+            TestEqual("Evaluations After Second Event", *Counter, 4);
+        });
+
+        It("Should Not Share Impure Conditions", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Condition(FTestCondition("x")).Condition(FTestPureCondition(true, nullptr))
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            const FStateChartNodes& Nodes = StateChart->GetAssembledNodes();
+            const int32 TransitionIndex = Nodes.TransitionNodes.IndexOfByPredicate([](const FTransitionNode& Node) { return Node.Definition->Conditions.Num() == 2; });
+
+            const FStateChartGuardTable& GuardTable = Nodes.GuardTable;
+            TArrayView<const FIndex> GuardIDs = GuardTable.GetTransitionGuards(TransitionIndex);
+
+            TestEqual("Num Guards", GuardTable.NumGuards, 1);
+            TestEqual("Num Transition Guards", GuardIDs.Num(), 2);
+            TestTrue("Impure Condition", GuardIDs[0].IsNone());
+            TestFalse("Pure Condition", GuardIDs[1].IsNone());
+        });
+    });
+
+    Describe("Datamodel", [this]
+    {
+        It("Should Give Each Executor Own Copy", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Variable("Ammo", 1);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>().Action(FTestSetVariableAction("Ammo", 5))
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            TSharedRef<IStateChartExecutor> OtherExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            Executor->Execute();
+            OtherExecutor->Execute();
+            Executor->ExecuteEvent<FTestEvent>();
+
+            FStateChartCompileContext CompileContext;
+            CompileContext.DatamodelType = StateChart->GetDatamodel().GetPropertyBagStruct();
+
+            FStateChartDatamodelSlot Slot("Ammo");
+            TestTrue("Resolved", Slot.Resolve<int32>(CompileContext));
+            TestFalse("Resolved With Wrong Type", FStateChartDatamodelSlot("Ammo").Resolve<float>(CompileContext));
+
+            FStateChartExecutionContext Context(*Executor, nullptr);
+            Context.Datamodel = Executor->GetDatamodel();
+
+            FStateChartExecutionContext OtherContext(*OtherExecutor, nullptr);
+            OtherContext.Datamodel = OtherExecutor->GetDatamodel();
+
+            TestEqual("Changed Value", Slot.Get<int32>(Context), 5);
+            TestEqual("Other Value", Slot.Get<int32>(OtherContext), 1);
+        });
+
+        It("Should Raise Event When Variable Changes", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Variable("Ammo", 0);
+            Builder.Variable("Health", 1.0f);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Event<FTestEvent>().Action(FTestSetVariableAction("Ammo", 0)), // <-- same value, no event
+                    Builder.Transition().Target("b").Event<FStateChartDatamodelChangedEvent>().Condition(FStateChartDatamodelChangedCondition("Ammo"))
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestEvent>().Action(FTestSetVariableAction("Ammo", 3))
+                ),
+                Builder.State("c").Children
+                (
+                    Builder.Transition().Target("d").Event<FStateChartDatamodelChangedEvent>().Condition(FStateChartExpressionCondition("Ammo == 3 && Health > 0.5"))
+                ),
+                Builder.State("d")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("a", *Executor);
+
+            Executor->ExecuteEvent<FStateChartDatamodelChangedEvent>();
+            TestActive("a", *Executor);
+
+            Executor->ExecuteEvent(FStateChartDatamodelChangedEvent("Ammo"));
+            TestActive("b", *Executor);
+
+            // change made by transition action is processed as internal event right after it
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("d", *Executor);
+        });
+    });
+
+    Describe("Event Types", [this]
+    {
+        It("Should Trigger Transitions On Parent Event Types", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestDerivedEvent>(),
+                    Builder.Transition().Target("err").Event<FTestEvent>()
+                ),
+                Builder.State("c"),
+                Builder.State("err")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestOtherEvent>();
+            TestActive("a", *Executor);
+
+            Executor->ExecuteEvent<FTestDerivedEvent>();
+            TestActive("b", *Executor);
+
+            // transitions are still checked in document order
+            Executor->ExecuteEvent<FTestDerivedEvent>();
+            TestActive("c", *Executor);
+        });
+
+        It("Should Index Only Referenced Event Types", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            const FStateChartEventTypeIndex& Index = StateChart->GetAssembledNodes().EventTypeIndex;
+
+            TestEqual("Indexed Types", Index.TypeToList.Num(), 1);
+            TestEqual("Derived Type Uses Parent List", Index.FindListIndex(FTestDerivedEvent::StaticStruct()), Index.FindListIndex(FTestEvent::StaticStruct()));
+            TestEqual("Unrelated Type", Index.FindListIndex(FTestOtherEvent::StaticStruct()), INDEX_NONE);
+        });
+
+        It("Should Trigger Any Event Transitions", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").AnyEvent()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").AnyEvent().Condition(FTestCondition("go"))
+                ),
+                Builder.State("c").Children
+                (
+                    Builder.Transition().Target("a").AnyEvent()
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestOtherEvent>();
+            TestActive("b", *Executor);
+
+            Executor->ExecuteEvent(FTestDerivedEvent("stay"));
+            TestActive("b", *Executor);
+
+            Executor->ExecuteEvent(FTestEvent("go"));
+            TestActive("c", *Executor);
+
+            Executor->ExecuteTagEvent(TAG_Test_Other);
+            TestActive("a", *Executor);
+        });
+
+        It("Should Match Event Types In Flat Table", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.CompileFlatTable();
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("c").Event<FTestDerivedEvent>()
+                ),
+                Builder.State("c").Children
+                (
+                    Builder.Transition().Target("a").AnyEvent()
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestNotNull("Flat Table", StateChart->GetFlatTable());
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            Executor->ExecuteEvent<FTestDerivedEvent>();
+            TestActive("b", *Executor);
+
+            Executor->ExecuteEvent<FTestEvent>();
+            TestActive("b", *Executor);
+
+            Executor->ExecuteEvent<FTestDerivedEvent>();
+            TestActive("c", *Executor);
+
+            Executor->ExecuteEvent<FTestOtherEvent>();
+            TestActive("a", *Executor);
+        });
+    });
+
+    Describe("Flat Table", [this]
+    {
+        It("Should Match Default Executor", [this]
+        {
+            TArray<FString> DefaultLog;
+            TArray<FString> FlatLog;
+            TArray<FString>* Log = nullptr;
+
+            auto LogAction = [&](FString Message)
+            {
+                return FTestCallbackAction([&Log, Message]() { Log->Add(Message); });
+            };
+
+            FStateChartBuilder Builder;
+            Builder.CompileFlatTable();
+            Builder.Root().Children
+            (
+                Builder.Parallel("p").OnEnter(LogAction("enter p")).OnExit(LogAction("exit p")).Children
+                (
+                    Builder.State("a").OnEnter(LogAction("enter a")).Children
+                    (
+                        Builder.Transition().Target("p.b").Event<FTestEvent>().Action(LogAction("a->b"))
+                    ),
+                    Builder.State("b").OnExit(LogAction("exit b")).Children
+                    (
+                        Builder.Transition().Target("c").Event<FStateChartGenericEvent>()
+                    )
+                ),
+                Builder.State("c").OnEnter(LogAction("enter c")).Children
+                (
+                    Builder.Transition().Target("p").Event<FTestEvent>()
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestNotNull("Flat Table", StateChart->GetFlatTable());
+
+            TSharedRef<FStateChartDefaultExecutor> DefaultExecutor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+            TSharedRef<IStateChartExecutor> FlatExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            auto Run = [&](IStateChartExecutor& Executor, TArray<FString>& OutLog)
+            {
+                Log = &OutLog;
+
+                Executor.Execute();
+                Executor.ExecuteEvent<FTestEvent>();
+                Executor.ExecuteEvent<FStateChartGenericEvent>();
+                Executor.ExecuteEvent<FTestEvent>();
+                Executor.ExecuteEvent<FTestEvent>();
+            };
+
+            Run(*DefaultExecutor, DefaultLog);
+            Run(*FlatExecutor, FlatLog);
+
+            TestEqual("Actions", FlatLog, DefaultLog);
+            auto GetActiveNames = [](const IStateChartExecutor& Executor)
+            {
+                TArray<FString> Result;
+                Algo::Transform(Executor.GetActiveStates(), Result, [](auto State) { return State->FriendlyName; });
+                Result.Sort();
+                return Result;
+            };
+
+            TestEqual("Active States", GetActiveNames(*FlatExecutor), GetActiveNames(*DefaultExecutor));
+        });
+
+        It("Should Apply Event Queue Policy", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.CompileFlatTable();
+            Builder.EventQueue(1, EStateChartQueueOverflow::DropNewest);
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.Transition().Target("b").Event<FTestEvent>()
+                ),
+                Builder.State("b").Children
+                (
+                    Builder.Transition().Target("err").Event<FTestOtherEvent>()
+                ),
+                Builder.State("err")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartFlatExecutor> Executor = MakeShared<FStateChartFlatExecutor>(*StateChart);
+
+            Executor->Execute();
+            Executor->SetDeferredProcessing(true);
+            Executor->ExecuteEvent<FTestEvent>();
+            Executor->ExecuteEvent<FTestOtherEvent>(); // <-- does not fit into the queue
+            Executor->Pump(MAX_int32);
+
+            TestActive("b", *Executor);
+
+            const FStateChartExecutorStats Stats = Executor->GetStats();
+            TestEqual("Dropped Events", Stats.NumDroppedEvents, 1);
+            TestEqual("Queue Depth", Stats.MaxExternalQueueDepth, 1);
+        });
+
+        It("Should Fallback To Default Executor", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.CompileFlatTable();
+            Builder.Root().Children
+            (
+                Builder.State("a").Children
+                (
+                    Builder.History("h"),
+                    Builder.State("1")
+                ),
+                Builder.State("b")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestNull("Flat Table", StateChart->GetFlatTable());
+
+            TSharedRef<IStateChartExecutor> Executor = IStateChartExecutor::CreateDefault(*StateChart);
+            Executor->Execute();
+
+            TestActive("1", *Executor);
+        });
+    });
+
+    Describe("Feature Variants", [this]
+    {
+        It("Should Compute Features", [this]
+        {
+            TSharedPtr<FSimpleDelegate> Trigger = MakeShared<FSimpleDelegate>();
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.Parallel("p").Children
+                (
+                    Builder.State("a").OnEnter(FTestCallbackAction()),
+                    Builder.State("b").Children
+                    (
+                        Builder.History("h"),
+                        Builder.State("1")
+                    )
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestTrue("Features", StateChart->GetAssembledNodes().Features == (EStateChartFeatures::History | EStateChartFeatures::Parallel));
+
+            FStateChartBuilder AsyncBuilder;
+            AsyncBuilder.Root().Children
+            (
+                AsyncBuilder.State("a").OnEnter(FTestAsyncAction(Trigger))
+            );
+
+            TObjectPtr<UStateChartAsset> AsyncStateChart = AsyncBuilder.Build();
+            TestTrue("Async Features", AsyncStateChart->GetAssembledNodes().Features == EStateChartFeatures::AsyncActions);
+        });
+
+        It("Should Match Default Executor", [this]
+        {
+            TArray<FString> DefaultLog;
+            TArray<FString> SpecializedLog;
+            TArray<FString>* Log = nullptr;
+
+            auto LogAction = [&](FString Message)
+            {
+                return FTestCallbackAction([&Log, Message]() { Log->Add(Message); });
+            };
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.Parallel("p").OnExit(LogAction("exit p")).Children
+                (
+                    Builder.State("a").OnEnter(LogAction("enter a")).OnExit(LogAction("exit a")),
+                    Builder.State("b").OnEnter(LogAction("enter b")).Children
+                    (
+                        Builder.State("1"),
+                        Builder.State("2").OnEnter(LogAction("enter 2")),
+                        Builder.Transition().Target("p.b.2").Event<FTestEvent>().Action(LogAction("b->2"))
+                    ),
+                    Builder.Transition().Target("c").Event<FStateChartGenericEvent>()
+                ),
+                Builder.State("c").OnEnter(LogAction("enter c"))
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TestTrue("Features", StateChart->GetAssembledNodes().Features == EStateChartFeatures::Parallel);
+
+            TSharedRef<IStateChartExecutor> DefaultExecutor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+            TSharedRef<IStateChartExecutor> SpecializedExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+
+            auto Run = [&](IStateChartExecutor& Executor, TArray<FString>& OutLog)
+            {
+                Log = &OutLog;
+
+                Executor.Execute();
+                Executor.ExecuteEvent<FTestEvent>();
+                Executor.ExecuteEvent<FStateChartGenericEvent>();
+            };
+
+            Run(*DefaultExecutor, DefaultLog);
+            Run(*SpecializedExecutor, SpecializedLog);
+
+            TestEqual("Actions", SpecializedLog, DefaultLog);
+            TestActive("c", *SpecializedExecutor);
+            TestNotActive("p", *SpecializedExecutor);
+        });
+    });
+
+    Describe("Garbage Collection", [this]
+    {
+        It("Should Register Executors Once Per Asset", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a")
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+
+            FStateChartExecutorRegistry& Registry = FStateChartExecutorRegistry::Get();
+            const int32 NumExecutors = Registry.GetNumExecutors();
+            const int32 NumAssets = Registry.GetNumAssets();
+
+            {
+                TSharedRef<IStateChartExecutor> FirstExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+                TSharedRef<IStateChartExecutor> SecondExecutor = IStateChartExecutor::CreateDefault(*StateChart);
+
+                TestEqual("Num Executors", Registry.GetNumExecutors(), NumExecutors + 2);
+                TestEqual("Num Assets", Registry.GetNumAssets(), NumAssets + 1);
+            }
+
+            TestEqual("Num Executors After Destruction", Registry.GetNumExecutors(), NumExecutors);
+            TestEqual("Num Assets After Destruction", Registry.GetNumAssets(), NumAssets);
+        });
+
+        It("Should Keep StateHandlers Of Active States Alive", [this]
+        {
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").Handler<UTestStateHandler>() // <-- this will be initial state
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<FStateChartDefaultExecutor> Executor = MakeShared<FStateChartDefaultExecutor>(*StateChart);
+
+            TWeakObjectPtr<UStateHandler> InstancedHandler;
+            Executor->OnStateHandlerCreated().AddLambda([&](UStateHandler& InHandler)
+            {
+                InstancedHandler = &InHandler;
+            });
+
+            Executor->Execute();
+
+            // nothing but executor references asset and handler here
+            TWeakObjectPtr<UStateChartAsset> WeakStateChart = StateChart;
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+            TestTrue("Asset Is Alive", WeakStateChart.IsValid());
+            TestTrue("Handler Is Alive", InstancedHandler.IsValid());
+        });
     });
 }
 
-bool FStateChartExecutorSpec::TestActive(const FString& State, const DruStateChart_Impl::FStateChartDefaultExecutor& Executor)
+bool FStateChartExecutorSpec::TestActive(const FString& State, const IStateChartExecutor& Executor)
 {
     return TestTrue(FString::Printf(TEXT("'%s' Active"), *State), Executor.GetActiveStates().ContainsByPredicate([&](auto S) { return S->FriendlyName == State; }));
 }
 
-bool FStateChartExecutorSpec::TestNotActive(const FString& State, const DruStateChart_Impl::FStateChartDefaultExecutor& Executor)
+bool FStateChartExecutorSpec::TestNotActive(const FString& State, const IStateChartExecutor& Executor)
 {
     return TestFalse(FString::Printf(TEXT("'%s' Active"), *State), Executor.GetActiveStates().ContainsByPredicate([&](auto S) { return S->FriendlyName == State; }));
 }
\ No newline at end of file
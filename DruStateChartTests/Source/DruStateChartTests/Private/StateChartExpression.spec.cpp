@@ -0,0 +1,90 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Impl/StateChartExpression.h"
+
+#include "TestContext.h"
+
+BEGIN_DEFINE_SPEC(FStateChartExpressionSpec, "DruStateChart.Expression", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool TestExpression(const FString& Source, const UTestContextObject& Object, bool bExpected);
+
+END_DEFINE_SPEC(FStateChartExpressionSpec)
+
+void FStateChartExpressionSpec::Define()
+{
+    using namespace DruStateChart_Impl;
+
+    Describe("Evaluation", [this]
+    {
+        It("Should Evaluate Operators", [this]
+        {
+            UTestContextObject* Object = NewObject<UTestContextObject>();
+            Object->Health = 0.25f;
+            Object->bHasAmmo = true;
+            Object->Ammo = 3;
+
+            TestExpression("Health < 0.3 && bHasAmmo", *Object, true);
+            TestExpression("Health < 0.2 || !bHasAmmo", *Object, false);
+            TestExpression("Ammo * 2 - 1 == 5", *Object, true);
+            TestExpression("Ammo / 2 >= 1.5", *Object, true);
+            TestExpression("-Ammo < -2 && (Ammo != 3 || true)", *Object, true);
+            TestExpression("!(Ammo <= 3)", *Object, false);
+            TestExpression("Ammo > 3 || Health > 0.3 || bHasAmmo && Ammo", *Object, true);
+            TestExpression("0.5f > Health", *Object, true);
+            TestExpression("(Ammo)==3 && (Ammo+1)>=4", *Object, true);
+        });
+
+        It("Should Read Bitfields And Nested Properties", [this]
+        {
+            UTestContextObject* Object = NewObject<UTestContextObject>();
+            Object->bIsSprinting = true;
+            Object->Stats.Stamina = 10.0;
+            Object->Stats.Level = 2;
+
+            TestExpression("bIsSprinting && !bIsCrouching", *Object, true);
+            TestExpression("Stats.Stamina > 5 && Stats.Level == 2", *Object, true);
+
+            Object->bIsCrouching = true;
+            TestExpression("bIsSprinting && !bIsCrouching", *Object, false);
+        });
+
+        It("Should Report Errors", [this]
+        {
+            const TCHAR* InvalidSources[] =
+            {
+                TEXT("Health <"),
+                TEXT("(Health < 0.3"),
+                TEXT("Health < 0.3)"),
+                TEXT("Unknown > 1"),
+                TEXT("Name == 1"),
+                TEXT("Health & bHasAmmo"),
+                TEXT("Health < 1.2.3"),
+                TEXT(""),
+            };
+
+            for (const TCHAR* Source : InvalidSources)
+            {
+                FStateChartExpression Expression;
+                FString Error;
+
+                TestFalse(FString::Printf(TEXT("'%s' Compiled"), Source), Expression.Compile(Source, *UTestContextObject::StaticClass(), Error));
+                TestFalse(FString::Printf(TEXT("'%s' Error"), Source), Error.IsEmpty());
+            }
+        });
+    });
+}
+
+bool FStateChartExpressionSpec::TestExpression(const FString& Source, const UTestContextObject& Object, bool bExpected)
+{
+    DruStateChart_Impl::FStateChartExpression Expression;
+    FString Error;
+
+    if (!Expression.Compile(Source, *UTestContextObject::StaticClass(), Error))
+    {
+        AddError(FString::Printf(TEXT("Failed to compile '%s': %s"), *Source, *Error));
+        return false;
+    }
+
+    return TestEqual(Source, Expression.Evaluate(&Object), bExpected);
+}
@@ -189,6 +189,119 @@ void FStateChartNodesSpec::Define()
         TestEqual("NumTransitions", Nodes.StateNodes[0].NumTransitions, 2); // initial transition is not counted here
         TestEqual("InitialTransitionIndex", Nodes.StateNodes[0].InitialTransitionIndex, 2);
     });
+
+    It("Should Ignore States With Invalid Parent", [this]
+    {
+        TArray<TObjectPtr<UBaseStateDefinition>> AllStates;
+        AllStates.SetNum(5);
+
+        AllStates[0] = CreateState<UCompoundStateDefinition>("root");
+        AllStates[1] = CreateState<UCompoundStateDefinition>("root/a", AllStates[0], 0);
+        AllStates[2] = CreateState<UCompoundStateDefinition>("unknown/b");
+        AllStates[2]->ParentID = FGuid::NewGuid();
+        AllStates[3] = CreateState<UCompoundStateDefinition>("cycle/c");
+        AllStates[4] = CreateState<UCompoundStateDefinition>("cycle/d", AllStates[3]);
+        AllStates[3]->ParentID = AllStates[4]->ID;
+
+        AddExpectedError(TEXT("references unknown parent"), EAutomationExpectedErrorFlags::Contains, 1);
+        AddExpectedError(TEXT("cyclic parent references"), EAutomationExpectedErrorFlags::Contains, 1);
+
+        FStateChartNodes Nodes;
+        Nodes.CreateNodes(AllStates, {});
+
+        TestEqual("Num States", Nodes.StateNodes.Num(), 2);
+        TestEqual("State[0]", Nodes.StateNodes[0].Definition, AllStates[0].Get());
+        TestEqual("State[1]", Nodes.StateNodes[1].Definition, AllStates[1].Get());
+        TestEqual("State[1].ParentIndex", Nodes.StateNodes[1].ParentIndex, FIndex(0));
+    });
+
+    Describe("Incremental Updates", [this]
+    {
+        It("Should Match Full Rebuild", [this]
+        {
+            TArray<TObjectPtr<UBaseStateDefinition>> AllStates;
+            AllStates.SetNum(6);
+
+            AllStates[0] = CreateState<UCompoundStateDefinition>("root");
+            AllStates[1] = CreateState<UCompoundStateDefinition>("root/a", AllStates[0], 0);
+            AllStates[2] = CreateState<UCompoundStateDefinition>("root/b", AllStates[0], 1);
+            AllStates[3] = CreateState<UCompoundStateDefinition>("root/a/1", AllStates[1], 0);
+            AllStates[4] = CreateState<UCompoundStateDefinition>("root/a/2", AllStates[1], 1);
+            AllStates[5] = CreateState<UCompoundStateDefinition>("root/b/1", AllStates[2], 0);
+
+            TArray<TObjectPtr<UTransitionDefinition>> AllTransitions;
+            AllTransitions.Add(CreateTransition(AllStates[0], AllStates[1], 0, true));
+            AllTransitions.Add(CreateTransition(AllStates[1], AllStates[3], 0, true));
+            AllTransitions.Add(CreateTransition(AllStates[2], AllStates[5], 0, true));
+            AllTransitions.Add(CreateTransition(AllStates[3], AllStates[4], 0));
+            AllTransitions.Add(CreateTransition(AllStates[4], AllStates[5], 0));
+
+            FStateChartNodes Nodes;
+            Nodes.CreateNodes(AllStates, AllTransitions);
+
+            auto VerifyNodes = [&](const TCHAR* What)
+            {
+                FStateChartNodes RebuiltNodes;
+                RebuiltNodes.CreateNodes(AllStates, AllTransitions);
+
+                FString Difference;
+                TestTrue(FString::Printf(TEXT("%s: %s"), What, *Difference), Nodes.IsEquivalent(RebuiltNodes, &Difference));
+            };
+
+            // add leaf state to a state without children
+            AllStates.Add(CreateState<UCompoundStateDefinition>("root/a/1/x", AllStates[3], 0));
+            TestTrue("Insert Leaf", Nodes.InsertLeafState(*AllStates.Last()));
+            VerifyNodes(TEXT("Insert Leaf"));
+
+            // add leaf state in the middle of siblings
+            AllStates.Add(CreateState<UCompoundStateDefinition>("root/a/3", AllStates[1], 0.5));
+            TestTrue("Insert Sibling", Nodes.InsertLeafState(*AllStates.Last()));
+            VerifyNodes(TEXT("Insert Sibling"));
+
+            // add transitions
+            AllTransitions.Add(CreateTransition(AllStates[3], AllStates[2], -1));
+            TestTrue("Insert Transition", Nodes.InsertTransition(*AllTransitions.Last()));
+            VerifyNodes(TEXT("Insert Transition"));
+
+            AllTransitions.Add(CreateTransition(AllStates.Last(), AllStates[2], 0));
+            TestTrue("Insert Transition To New State", Nodes.InsertTransition(*AllTransitions.Last()));
+            VerifyNodes(TEXT("Insert Transition To New State"));
+
+            // reorder transition
+            AllTransitions[3]->SortOrder = -2;
+            TestTrue("Reorder Transition", Nodes.UpdateTransition(*AllTransitions[3]));
+            VerifyNodes(TEXT("Reorder Transition"));
+
+            // remove transition
+            UTransitionDefinition* RemovedTransition = AllTransitions[4];
+            AllTransitions.RemoveAt(4);
+            TestTrue("Remove Transition", Nodes.RemoveTransition(*RemovedTransition));
+            VerifyNodes(TEXT("Remove Transition"));
+
+            // transitions with equal SortOrder keep order of input array
+            AllTransitions.Add(CreateTransition(AllStates[5], AllStates[1], 0));
+            AllTransitions.Add(CreateTransition(AllStates[5], AllStates[2], 0));
+            TestTrue("Insert Equal Transitions", Nodes.InsertTransition(*AllTransitions[AllTransitions.Num() - 2]) && Nodes.InsertTransition(*AllTransitions.Last()));
+            VerifyNodes(TEXT("Insert Equal Transitions"));
+
+            AllTransitions[AllTransitions.Num() - 2]->SortOrder = 1;
+            TestTrue("Move Equal Transition Last", Nodes.UpdateTransition(*AllTransitions[AllTransitions.Num() - 2]));
+            VerifyNodes(TEXT("Move Equal Transition Last"));
+
+            AllTransitions[AllTransitions.Num() - 2]->SortOrder = 0;
+            TestTrue("Restore Equal Transition", Nodes.UpdateTransition(*AllTransitions[AllTransitions.Num() - 2]));
+            VerifyNodes(TEXT("Restore Equal Transition"));
+
+            // move leaf state with transitions to other parent
+            AllStates[4]->ParentID = AllStates[2]->ID;
+            TestTrue("Reparent", Nodes.ReparentState(*AllStates[4]));
+            VerifyNodes(TEXT("Reparent"));
+
+            // moving subtrees requires full rebuild
+            AllStates[1]->ParentID = AllStates[2]->ID;
+            TestFalse("Reparent Subtree", Nodes.ReparentState(*AllStates[1]));
+        });
+    });
 }
 
 template <typename T>
@@ -0,0 +1,160 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Impl/StateChartDefaultExecutor.h"
+#include "StateChartAsset.h"
+#include "StateChartBuilder.h"
+#include "StateChartEvent.h"
+#include "StaticStateChart.h"
+
+#include "TestActions.h"
+#include "TestEvents.h"
+
+namespace StaticStateChartTests
+{
+    using FLog = TArray<FString>;
+
+    struct FRoot : TStaticState<> {};
+
+    struct FA : TStaticState<FRoot>
+    {
+        static void OnEnter(FLog& Log) { Log.Add(TEXT("enter a")); }
+        static void OnExit(FLog& Log) { Log.Add(TEXT("exit a")); }
+    };
+
+    struct FA1 : TStaticState<FA>
+    {
+        static void OnEnter(FLog& Log) { Log.Add(TEXT("enter a1")); }
+        static void OnExit(FLog& Log) { Log.Add(TEXT("exit a1")); }
+    };
+
+    struct FA2 : TStaticState<FA>
+    {
+        static void OnEnter(FLog& Log) { Log.Add(TEXT("enter a2")); }
+        static void OnExit(FLog& Log) { Log.Add(TEXT("exit a2")); }
+    };
+
+    struct FB : TStaticState<FRoot>
+    {
+        static void OnEnter(FLog& Log) { Log.Add(TEXT("enter b")); }
+        static void OnExit(FLog& Log) { Log.Add(TEXT("exit b")); }
+    };
+
+    struct FA1ToA2 : TStaticTransition<FA1, FTestEvent, FA2>
+    {
+        static void Action(FLog& Log, const FTestEvent& Event) { Log.Add(TEXT("a1->a2")); }
+    };
+
+    struct FA2ToB : TStaticTransition<FA2, FTestEvent, FB>
+    {
+        static bool Guard(FLog& Log, const FTestEvent& Event) { return Event.Name == FName(TEXT("go")); }
+    };
+
+    struct FBToA : TStaticTransition<FB, FTestEvent, FA> {};
+    struct FAToB : TStaticTransition<FA, FStateChartGenericEvent, FB> {};
+
+    using FChart = TStaticStateChart<FLog, TStaticStates<FRoot, FA, FA1, FA2, FB>, TStaticTransitions<FA1ToA2, FA2ToB, FBToA, FAToB>>;
+}
+
+BEGIN_DEFINE_SPEC(FStaticStateChartSpec, "DruStateChart.Static StateChart", EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+END_DEFINE_SPEC(FStaticStateChartSpec)
+
+void FStaticStateChartSpec::Define()
+{
+    using namespace StaticStateChartTests;
+
+    Describe("Tables", [this]
+    {
+        It("Should Resolve Hierarchy At Compile Time", [this]
+        {
+            static_assert(FChart::Tables.ParentIndex[FChart::IndexOf<FA1>] == FChart::IndexOf<FA>);
+            static_assert(FChart::Tables.InitialIndex[FChart::IndexOf<FRoot>] == FChart::IndexOf<FA>);
+            static_assert(FChart::Tables.InitialIndex[FChart::IndexOf<FA>] == FChart::IndexOf<FA1>);
+            static_assert(FChart::Tables.InitialIndex[FChart::IndexOf<FB>] == INDEX_NONE);
+
+            TestEqual("Num States", FChart::NumStates, 5);
+        });
+    });
+
+    Describe("Execution", [this]
+    {
+        It("Should Enter Initial States", [this]
+        {
+            FLog Log;
+            TStaticStateChartExecutor<FChart> Executor(Log);
+            Executor.Execute();
+
+            TestEqual("Log", Log, FLog({ TEXT("enter a"), TEXT("enter a1") }));
+            TestTrue("'a1' Active", Executor.IsActive<FA1>());
+            TestTrue("'a' Active", Executor.IsActive<FA>());
+            TestFalse("'b' Active", Executor.IsActive<FB>());
+        });
+
+        It("Should Match Default Executor", [this]
+        {
+            FLog DefaultLog;
+            FLog* Log = &DefaultLog;
+
+            auto LogAction = [&](FString Message)
+            {
+                return FTestCallbackAction([&Log, Message]() { Log->Add(Message); });
+            };
+
+            FStateChartBuilder Builder;
+            Builder.Root().Children
+            (
+                Builder.State("a").OnEnter(LogAction("enter a")).OnExit(LogAction("exit a")).Children
+                (
+                    Builder.State("a1").OnEnter(LogAction("enter a1")).OnExit(LogAction("exit a1")).Children
+                    (
+                        Builder.Transition().Target("a.a2").Event<FTestEvent>().Action(LogAction("a1->a2"))
+                    ),
+                    Builder.State("a2").OnEnter(LogAction("enter a2")).OnExit(LogAction("exit a2")).Children
+                    (
+                        Builder.Transition().Target("b").Event<FTestEvent>().Condition(FTestCondition("go"))
+                    ),
+                    Builder.Transition().Target("b").Event<FStateChartGenericEvent>()
+                ),
+                Builder.State("b").OnEnter(LogAction("enter b")).OnExit(LogAction("exit b")).Children
+                (
+                    Builder.Transition().Target("a").Event<FTestEvent>()
+                )
+            );
+
+            TObjectPtr<UStateChartAsset> StateChart = Builder.Build();
+            TSharedRef<DruStateChart_Impl::FStateChartDefaultExecutor> DefaultExecutor = MakeShared<DruStateChart_Impl::FStateChartDefaultExecutor>(*StateChart);
+
+            FLog StaticLog;
+            TStaticStateChartExecutor<FChart> StaticExecutor(StaticLog);
+
+            DefaultExecutor->Execute();
+            StaticExecutor.Execute();
+
+            auto SendBoth = [&](const auto& Event)
+            {
+                DefaultExecutor->ExecuteEvent(Event);
+                StaticExecutor.ExecuteEvent(Event);
+            };
+
+            SendBoth(FTestEvent("x"));
+            SendBoth(FTestEvent("stay"));
+            SendBoth(FTestEvent("go"));
+            SendBoth(FTestEvent("x"));
+            SendBoth(FStateChartGenericEvent());
+
+            TestEqual("Log", StaticLog, DefaultLog);
+            TestTrue("'b' Active", StaticExecutor.IsActive<FB>());
+        });
+
+        It("Should Report Taken Transitions", [this]
+        {
+            FLog Log;
+            TStaticStateChartExecutor<FChart> Executor(Log);
+            Executor.Execute();
+
+            TestTrue("Taken", Executor.ExecuteEvent(FTestEvent("x")));
+            TestFalse("Rejected By Guard", Executor.ExecuteEvent(FTestEvent("stay")));
+            TestTrue("'a2' Active", Executor.IsActive<FA2>());
+        });
+    });
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "StateChartAction.h"
+#include "StateChartDatamodel.h"
 #include "Templates/Function.h"
 #include "TestActions.generated.h"
 
@@ -36,7 +37,7 @@ public:
 };
 
 USTRUCT()
-struct FTestCallbackAction : public FStateChartAction
+struct FTestCallbackAction : public FStateChartSyncAction
 {
     GENERATED_BODY()
 
@@ -54,4 +55,27 @@ public:
     }
 
     TFunction<void(const FStateChartExecutionContext& Context)> Action;
-};
\ No newline at end of file
+};
+
+USTRUCT()
+struct FTestSetVariableAction : public FStateChartSyncAction
+{
+    GENERATED_BODY()
+
+public:
+    FTestSetVariableAction() = default;
+    FTestSetVariableAction(FName Name, int32 InValue) : Slot(Name), Value(InValue) {}
+
+    void Compile(const FStateChartCompileContext& Context) override
+    {
+        Slot.Resolve<int32>(Context);
+    }
+
+    void Execute(const FStateChartExecutionContext& Context) override
+    {
+        Slot.Set(Context, Value);
+    }
+
+    FStateChartDatamodelSlot Slot;
+    int32 Value = 0;
+};
@@ -0,0 +1,82 @@
+// Copyright Andrei Sudarikov. All Rights Reserved.
+
+#pragma once
+
+#include "StateChartCondition.h"
+#include "UObject/Object.h"
+#include "TestContext.generated.h"
+
+USTRUCT()
+struct FTestContextStats
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY()
+    double Stamina = 0.0;
+
+    UPROPERTY()
+    uint8 Level = 0;
+};
+
+UCLASS()
+class UTestContextObject : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY()
+    float Health = 1.0f;
+
+    UPROPERTY()
+    bool bHasAmmo = false;
+
+    UPROPERTY()
+    int32 Ammo = 0;
+
+    UPROPERTY()
+    uint8 bIsCrouching : 1;
+
+    UPROPERTY()
+    uint8 bIsSprinting : 1;
+
+    UPROPERTY()
+    FTestContextStats Stats;
+
+    UPROPERTY()
+    FString Name;
+};
+
+/* Together with FTestHasAmmoCondition is hand-written equivalent of "Health < 0.3 && bHasAmmo" expression */
+USTRUCT()
+struct FTestLowHealthCondition : public FStateChartCondition
+{
+    GENERATED_BODY()
+
+public:
+    bool Evaluate(const FStateChartExecutionContext& Context, FConstStructView TransitionEvent) const override
+    {
+        const UTestContextObject* Object = Context.GetContext<UTestContextObject>();
+        return Object != nullptr && Object->Health < 0.3f;
+    }
+
+    /* Owner of context object invalidates "Health" when it changes */
+    bool GetDependencies(TArray<FName>& OutDependencies) const override
+    {
+        OutDependencies.Add("Health");
+        return true;
+    }
+};
+
+USTRUCT()
+struct FTestHasAmmoCondition : public FStateChartCondition
+{
+    GENERATED_BODY()
+
+public:
+    bool Evaluate(const FStateChartExecutionContext& Context, FConstStructView TransitionEvent) const override
+    {
+        const UTestContextObject* Object = Context.GetContext<UTestContextObject>();
+        return Object != nullptr && Object->bHasAmmo;
+    }
+};
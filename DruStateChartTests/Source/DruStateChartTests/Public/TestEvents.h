@@ -17,6 +17,22 @@ public:
     FName Name;
 };
 
+USTRUCT()
+struct FTestDerivedEvent : public FTestEvent
+{
+    GENERATED_BODY()
+
+public:
+    FTestDerivedEvent() = default;
+    FTestDerivedEvent(FName Name) : FTestEvent(Name) {}
+};
+
+USTRUCT()
+struct FTestOtherEvent
+{
+    GENERATED_BODY()
+};
+
 USTRUCT()
 struct FTestCondition : public FStateChartCondition
 {
@@ -34,4 +50,32 @@ public:
     }
 
     FName Name;
-};
\ No newline at end of file
+};
+
+/* Pure condition with fixed result. Counts how many times it was evaluated */
+USTRUCT()
+struct FTestPureCondition : public FStateChartCondition
+{
+    GENERATED_BODY()
+
+public:
+    FTestPureCondition() = default;
+    FTestPureCondition(bool bInResult, TSharedPtr<int32> InCounter) : bResult(bInResult), Counter(MoveTemp(InCounter)) {}
+
+    bool Evaluate(const FStateChartExecutionContext& Context, FConstStructView TransitionEvent) const override
+    {
+        if (Counter.IsValid())
+        {
+            ++*Counter;
+        }
+
+        return bResult;
+    }
+
+    bool IsPure() const override { return true; }
+
+    UPROPERTY()
+    bool bResult = true;
+
+    TSharedPtr<int32> Counter;
+};